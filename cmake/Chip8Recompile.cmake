@@ -0,0 +1,38 @@
+# Functions translating CHIP-8 ROMs into C++ with chip-8-recompile
+#
+# chip8_recompile(<variable> <name> <rom> <symbol> [<quirks>])
+#   Generates ${CMAKE_CURRENT_BINARY_DIR}/recompiled/<name>.cpp from <rom>, defining a RecompiledRom named <symbol>,
+#   and stores the path of the generated source in <variable>. <quirks> names the quirk profile the code is
+#   specialized for, vip, chip48, schip, modern or xo-chip, modern by default.
+#
+# add_chip8_native_rom(<target> <rom>)
+#   Builds an executable named <target> running <rom> recompiled to native code in the terminal.
+
+function(chip8_recompile variable name rom symbol)
+    get_filename_component(rom_path "${rom}" ABSOLUTE)
+    set(output "${CMAKE_CURRENT_BINARY_DIR}/recompiled/${name}.cpp")
+
+    add_custom_command(
+        OUTPUT "${output}"
+        COMMAND ${CMAKE_COMMAND} -E make_directory "${CMAKE_CURRENT_BINARY_DIR}/recompiled"
+        COMMAND chip-8-recompile "${rom_path}" "${output}" ${symbol} ${ARGN}
+        DEPENDS chip-8-recompile "${rom_path}"
+        COMMENT "Recompiling ${name}"
+        VERBATIM)
+
+    set(${variable} "${output}" PARENT_SCOPE)
+endfunction()
+
+function(add_chip8_native_rom target rom)
+    find_package(Curses REQUIRED)
+
+    chip8_recompile(generated_source ${target} "${rom}" RECOMPILED_ROM)
+
+    add_executable(${target}
+        "${generated_source}"
+        "${PROJECT_SOURCE_DIR}/src/native_main.cpp"
+        "${PROJECT_SOURCE_DIR}/src/input/terminal_input.cpp"
+        "${PROJECT_SOURCE_DIR}/src/display/terminal_display.cpp")
+    target_include_directories(${target} PRIVATE "${PROJECT_SOURCE_DIR}/src" ${CURSES_INCLUDE_DIR})
+    target_link_libraries(${target} chip-8_lib ${CURSES_LIBRARIES})
+endfunction()
@@ -7,19 +7,28 @@
  * @copyright Copyright (c) 2020
  *
  */
-#include <chrono>
+#include <algorithm>
+#include <cstring>
 #include <iostream>
-#include <sstream>
 #include <string>
-#include <thread>
 #include "chip-8.hpp"
 #include "chip-8_state.hpp"
-#include "exceptions.hpp"
-#include "op_codes.hpp"
+#include "dispatch.hpp"
+#include "frame_scheduler.hpp"
+#include "idle_loop_detector.hpp"
+#include "instruction.hpp"
+#include "instruction_cache.hpp"
+#include "recompiled_program.hpp"
+#include "threaded_interpreter.hpp"
 #include "input/input_interface.hpp"
+#include "jit/jit_compiler.hpp"
 
 using namespace std;
-using std::chrono::system_clock;
+
+// Two page hires programs of the COSMAC VIP start by jumping over their own copy of the hires interpreter, which
+// ends at 0x2C0 where the program itself starts
+static const uint16_t VIP_HIRES_INTERPRETER_JUMP = 0x1260;
+static const uint16_t VIP_HIRES_PROGRAM_LOCATION = 0x2C0;
 
 CHIP8::CHIP8(DisplayInterface* display, InputInterface* input, CHIP8_State* state) {
     // Set the display interface
@@ -34,295 +43,406 @@ CHIP8::CHIP8(DisplayInterface* display, InputInterface* input, CHIP8_State* stat
     } else {
         this->state_ = state;
     }
+
+    // Decoded instructions are cached per address and dropped when the memory they came from is modified
+    this->instruction_cache_ = new InstructionCache(this->state_);
+
+    this->threaded_interpreter_ = new ThreadedInterpreter(this->state_, this->input_, this->instruction_cache_);
+
+    this->idle_loop_detector_ = new IdleLoopDetector(this->state_);
+}
+
+CHIP8::~CHIP8() {
+    // A state provided by the caller may outlive the emulator
+    this->state_->setClearLatch(NULL);
+
+    delete this->jit_compiler_;
+    delete this->recompiled_program_;
+    delete this->idle_loop_detector_;
+    delete this->threaded_interpreter_;
+    delete this->instruction_cache_;
 }
 
 void CHIP8::LoadRom(vector<char> *rom) {
     for (int i = 0; i < rom->size(); i++) {
         this->state_->setMemoryValue(INITAL_PROGRAM_COUNTER + i, rom->at(i));
     }
+
+    // The hires interpreter of the ROM is replaced by the 64x64 display, the program is started directly
+    uint16_t first_op_code = rom->size() >= 2 ? ((uint8_t)rom->at(0) << 8) | (uint8_t)rom->at(1) : 0;
+    if (first_op_code == VIP_HIRES_INTERPRETER_JUMP) {
+        this->state_->setDisplayMode(DisplayMode::VipHires);
+        this->state_->setMemoryValue(INITAL_PROGRAM_COUNTER, 0x10 | (VIP_HIRES_PROGRAM_LOCATION >> 8));
+        this->state_->setMemoryValue(INITAL_PROGRAM_COUNTER + 1, VIP_HIRES_PROGRAM_LOCATION & 0xFF);
+    }
+}
+
+void CHIP8::LoadRecompiledRom(const RecompiledRom* rom) {
+    for (int i = 0; i < rom->image_size; i++) {
+        this->state_->setMemoryValue(INITAL_PROGRAM_COUNTER + i, rom->image[i]);
+    }
+
+    delete this->recompiled_program_;
+    this->recompiled_program_ = new RecompiledProgram(rom, this->state_, this->input_);
+    this->SetQuirkProfile(rom->quirks);
 }
 
 void CHIP8::Start() {
-    using namespace std::this_thread;     // sleep_for, sleep_until
-    using namespace std::chrono_literals; // ns, us, ms, s, h, etc.
+    this->scheduler_.start();
+    while(!this->state_->exited()) {
+        RunSummary summary = this->RunFrames(1);
+
+        // Sleep until the absolute deadline of the next frame
+        this->scheduler_.endFrame(summary.cycles);
+    }
+}
 
-    int timer_counter = 0;
-    while(true) {
+void CHIP8::SetInstructionsPerFrame(int instructions) {
+    this->instructions_per_frame_ = max(instructions, 1);
+    this->cycles_until_timers_ = this->instructions_per_frame_;
+}
 
-        // Get the time at the start or the frame
-        system_clock::time_point frame_start_time = system_clock::now();
+int CHIP8::instructionsPerFrame() {
+    return this->instructions_per_frame_;
+}
 
-        // Update timers
-        if (timer_counter > 7) {
-            timer_counter = 0;
+void CHIP8::SetIdleLoopSkipping(bool enabled) {
+    this->idle_loop_skipping_ = enabled;
+}
 
-            // The timers run at 60Hz, so around every 8 frames
-            uint8_t delay_time = this->state_->delayTimer();
-            if (delay_time > 0) {
-                this->state_->setDelayTimer(delay_time - 1);
-            }
+void CHIP8::SetPresentationMode(PresentationMode mode) {
+    this->presentation_mode_ = mode;
 
-            uint8_t sound_time = this->state_->soundTimer();
-            if (sound_time > 0) {
-                this->state_->setSoundTimer(sound_time - 1);
-            }
-        }
-        timer_counter ++;
+    // Only the clear mode needs the frame preceding each clear
+    if (mode == PresentationMode::Clear) {
+        this->state_->setClearLatch(this->clear_latch_);
+        this->presented_clears_ = this->state_->clearCount();
+        this->frames_since_clear_ = 0;
+    } else {
+        this->state_->setClearLatch(NULL);
+    }
 
-        // Process the frame
-        int cycles = this->ProcessCurrentFrame();
+    // The display shows what was last presented, whatever the previous mode
+    FrameBufferView frame = this->state_->displayView();
+    memcpy(this->presented_display_, frame.rows, frame.height * frame.wordsPerRow() * sizeof(uint64_t));
+    this->presented_width_ = frame.width;
+    this->presented_height_ = frame.height;
+}
 
-        // The CHIP-8 processor runs at approximately 500Hz, which is 2ms per cycle
-        // Wait time in milliseconds for the instruction
-        int wait_time = 2 * cycles;
+PresentationMode CHIP8::presentationMode() {
+    return this->presentation_mode_;
+}
 
-        // Get the time at the start or the frame
-        system_clock::time_point frame_end = system_clock::now();
-        system_clock::duration process_duration = frame_end - frame_start_time;
+const FrameStatistics& CHIP8::frameStatistics() {
+    return this->scheduler_.statistics();
+}
 
-        // Force the thread to sleep for 2ms, minus the time it took to process the op code
-        sleep_for(2ms - process_duration);
+void CHIP8::UpdateTimers() {
+    uint8_t delay_time = this->state_->delayTimer();
+    if (delay_time > 0) {
+        this->state_->setDelayTimer(delay_time - 1);
+    }
+
+    uint8_t sound_time = this->state_->soundTimer();
+    if (sound_time > 0) {
+        this->state_->setSoundTimer(sound_time - 1);
     }
 }
 
-int CHIP8::ProcessCurrentFrame() {
+CHIP8_State* CHIP8::state() {
+    return this->state_;
+}
 
-     // Get current PC
-    uint16_t current_pc = this->state_->programCounter();
+void CHIP8::SetExecutionMode(ExecutionMode mode) {
+    // The other modes only know about 2 byte instructions and the 4KB address space
+    if (this->state_->xoChip()) {
+        mode = ExecutionMode::Interpreter;
+    }
 
-    // All instructions are 2 bytes long and are stored most-significant-byte first.
-    uint8_t ms_op_code = this->state_->memoryValue(current_pc);
-    uint8_t ls_op_code = this->state_->memoryValue(current_pc + 1);
+    if (mode == ExecutionMode::Jit && JitCompiler::isSupported() == false) {
+        mode = ExecutionMode::Interpreter;
+    }
 
-    // Use bit shift and bitwise operator to combine into single op code
-    uint16_t op_code = ((uint16_t)ms_op_code << 8) | ls_op_code;
+    // Recompiled code only reproduces the quirks it was recompiled with
+    if (mode == ExecutionMode::Recompiled &&
+        (this->recompiled_program_ == NULL || this->recompiled_program_->quirkProfile() != this->quirkProfile())) {
+        mode = ExecutionMode::Interpreter;
+    }
 
-    // Move program counter forward 16 bits
-    this->state_->setProgramCounter(current_pc + 2);
+    if (mode == ExecutionMode::Jit && this->jit_compiler_ == NULL) {
+        this->jit_compiler_ = new JitCompiler(this->state_, this->input_, this->quirkProfile());
+    } else if (mode != ExecutionMode::Jit && this->jit_compiler_ != NULL) {
+        delete this->jit_compiler_;
+        this->jit_compiler_ = NULL;
+    }
 
-    // Process the op code and return the number of CPU cycles used to process op code
-    int cycles = this->ProcessOpCode(op_code);
+    this->execution_mode_ = mode;
+}
 
-    if (this->draw_flag_ == true) {
-        // Reset flag
-        this->draw_flag_ = false;
-        // Refresh the display
-        this->display_->updateDisplay(this->state_);
+ExecutionMode CHIP8::executionMode() {
+    return this->execution_mode_;
+}
+
+void CHIP8::SetQuirkProfile(QuirkProfile profile) {
+    if (profile == this->quirkProfile()) {
+        return;
     }
+    this->instruction_cache_->setQuirkProfile(profile);
 
-    return cycles;
+    // Compiled code is specialized for the previous quirks, the JIT starts over
+    delete this->jit_compiler_;
+    this->jit_compiler_ = NULL;
+    this->SetExecutionMode(this->execution_mode_);
 }
 
-int CHIP8::ProcessOpCode(uint16_t op_code) {
-    uint8_t nyble_1 = (uint8_t)((op_code & 0xF000) >> 12);
-    uint8_t nyble_2 = (uint8_t)(op_code & 0x0F00) >> 8;
-    uint8_t nyble_3 = (uint8_t)(op_code & 0x00F0) >> 4;
-    uint8_t nyble_4 = (uint8_t)(op_code & 0x000F);
-
-    switch(nyble_1) {
-        case 0x00:
-            if (op_code == 0x00E0) {
-                this->draw_flag_ = true;
-                return Execute00E0(this->state_);
-
-            } else if (op_code == 0x00EE) {
-                // Return from subroutine
-                return Execute00EE(this->state_);
-            }
-            else {
-                // unused
-                return 1;
-            }
+QuirkProfile CHIP8::quirkProfile() {
+    return this->instruction_cache_->quirkProfile();
+}
 
-        case 0x01: {
-            // 1NNN - Jump to addres NNN
-            return Execute1NNN(this->state_, op_code);
+RunSummary CHIP8::RunCycles(long cycles) {
+    RunSummary summary;
+    long draws = this->draw_count_;
+
+    summary.stop_reason = StopReason::Cycles;
+    while (summary.cycles < cycles) {
+        if (this->state_->exited()) {
+            summary.stop_reason = StopReason::Exit;
+            break;
         }
+        this->RunBatch(cycles - summary.cycles, summary);
+    }
 
-        case 0x02: {
-            // 2NNN - Call subroutine at NNN
-            return Execute2NNN(this->state_, op_code);
+    summary.draws = this->draw_count_ - draws;
+    return summary;
+}
+
+RunSummary CHIP8::RunFrames(long frames) {
+    RunSummary summary;
+    long draws = this->draw_count_;
+
+    summary.stop_reason = StopReason::Frames;
+    while (summary.frames < frames) {
+        if (this->state_->exited()) {
+            summary.stop_reason = StopReason::Exit;
+            break;
         }
+        this->RunBatch(this->cycles_until_timers_, summary);
+    }
+
+    summary.draws = this->draw_count_ - draws;
+    return summary;
+}
+
+RunSummary CHIP8::RunUntil(RunPredicate predicate, long max_cycles) {
+    RunSummary summary;
+    long draws = this->draw_count_;
 
-        case 0x03: {
-            // 3XNN - Skips the next instruction if VX equals NN
-            return Execute3XNN(this->state_, op_code);
+    summary.stop_reason = StopReason::CycleLimit;
+    while (max_cycles <= 0 || summary.cycles < max_cycles) {
+        if (this->state_->exited()) {
+            summary.stop_reason = StopReason::Exit;
+            break;
         }
+        this->RunBatch(1, summary);
+        if (predicate(this->state_)) {
+            summary.stop_reason = StopReason::Predicate;
+            break;
+        }
+    }
+
+    summary.draws = this->draw_count_ - draws;
+    return summary;
+}
 
-        case 0x04: {
-            // 4XNN - Skips the next instruction if VX does not equal NN
-            return Execute4XNN(this->state_, op_code);
+int CHIP8::SkipIdleLoop(int max_cycles, RunSummary& summary) {
+    if (!this->idle_loop_detector_->inCandidateLoop()) {
+        return 0;
+    }
+
+    // The first iteration after a timer update reads the new timer values, so the loop gets a second iteration
+    // to come back to the same state
+    int done = 0;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        StateFingerprint before = this->idle_loop_detector_->fingerprint();
+        int length = 0;
+        while (done + length < max_cycles && length < MAX_IDLE_LOOP_LENGTH) {
+            length += this->ProcessFrames(1);
+            if (this->state_->programCounter() == before.program_counter) {
+                break;
+            }
         }
+        done += length;
 
-        case 0x05: {
-            // 5XY0 - Skips the next instruction if VX equals VY.
-            return Execute5XY0(this->state_, op_code);
+        if (length == 0) {
+            break;
         }
 
-        case 0x06: {
-            // 6XNN - Sets VX to NN
-            return Execute6XNN(this->state_, op_code);
+        if (this->idle_loop_detector_->fingerprint() == before) {
+            // Every following iteration does the same until the timers change, skip the complete ones
+            int skipped = (max_cycles - done) / length * length;
+            summary.idle_cycles += skipped;
+            return done + skipped;
         }
 
-        case 0x07: {
-            // 7XNN - Adds NN to VX. (Carry flag is not changed)
-            return Execute7XNN(this->state_, op_code);
+        if (this->state_->programCounter() != before.program_counter) {
+            // Left the loop
+            break;
         }
+    }
 
-        // 8XYN
-        case 0x08: {
-            switch (nyble_4) {
-
-                case 0x00: {
-                    // 8XY0 - Sets VX to the value of VY.
-                    return Execute8XY0(this->state_, op_code);
-                }
-
-                case 0x01: {
-                    // 8XY1 - Sets VX to VX or VY.
-                    return Execute8XY1(this->state_, op_code);
-                }
-
-                case 0x02: {
-                    // 8XY2 - Sets VX to VX and VY.
-                    return Execute8XY2(this->state_, op_code);
-                }
-
-                case 0x03: {
-                    // 8XY3 - Sets VX to VX xor VY.
-                    return Execute8XY3(this->state_, op_code);
-                }
-
-                case 0x04: {
-                    // 8XY4 - Adds VY to VX.
-                    // VF is set to 1 when there's a carry, and to 0 when there isn't.
-                    return Execute8XY4(this->state_, op_code);
-                }
-
-                case 0x05: {
-                    // 8XY5 - VY is subtracted from VX.
-                    // VF is set to 0 when there's a borrow, and 1 when there isn't.
-                    return Execute8XY5(this->state_, op_code);
-                }
-
-                case 0x06: {
-                    // 8XY6 - Stores the least significant bit of VX in VF and then shifts VX to the right by 1.
-                    return Execute8XY6(this->state_, op_code);
-                }
-
-                case 0x07: {
-                    // 8XY7 - Vx is subtracted from Vy.
-                    // VF is set to 0 when there's a borrow, and 1 when there isn't.
-                    return Execute8XY7(this->state_, op_code);
-                }
-
-                case 0x0E: {
-                    // 8XYE - Stores the most significant bit of VX in VF and then shifts VX to the left by 1.
-                    return Execute8XYE(this->state_, op_code);
-                }
-            }
+    return done;
+}
 
-            case 0x09: {
-                // 9XY0 - Skips the next instruction if VX doesn't equal VY.
-                // (Usually the next instruction is a jump to skip a code block)
-                return Execute9XY0(this->state_, op_code);
-            }
+void CHIP8::RunBatch(long max_cycles, RunSummary& summary) {
+    int cycles = (int)min(max_cycles, (long)this->cycles_until_timers_);
 
-            case 0x0A: {
-                // ANNN - Sets I to the address NNN.
-                return ExecuteANNN(this->state_, op_code);
-            }
+    int done = 0;
+    if (this->idle_loop_skipping_ && cycles > 1) {
+        done = this->SkipIdleLoop(cycles, summary);
+    }
+    summary.cycles += done + this->ProcessFrames(cycles - done);
+
+    this->cycles_until_timers_ -= cycles;
+    if (this->cycles_until_timers_ == 0) {
+        this->cycles_until_timers_ = this->instructions_per_frame_;
+        this->UpdateTimers();
+        this->input_->endFrame();
+        this->OnVBlank();
+        summary.frames++;
+    }
+}
 
-            case 0x0B: {
-                // BNNN - Jumps to the address NNN plus V0.
-                return ExecuteBNNN(this->state_, op_code);
+void CHIP8::OnDraw() {
+    switch (this->presentation_mode_) {
+        case PresentationMode::EveryDraw:
+            this->Present();
+            break;
+        case PresentationMode::VBlank:
+            break;
+        case PresentationMode::Clear:
+            if (this->state_->clearCount() != this->presented_clears_) {
+                this->presented_clears_ = this->state_->clearCount();
+                this->frames_since_clear_ = 0;
+                this->PresentFrame(this->state_->clearLatchView());
             }
+            break;
+    }
+}
 
-            case 0x0C: {
-                // CXNN - Sets VX to the result of a bitwise and operation on a random number and NN
-                // (Typically: 0 to 255)
-                return ExecuteCNNN(this->state_, op_code);
+void CHIP8::OnVBlank() {
+    switch (this->presentation_mode_) {
+        case PresentationMode::EveryDraw:
+            break;
+        case PresentationMode::VBlank:
+            this->PresentFrame(this->state_->displayView());
+            break;
+        case PresentationMode::Clear:
+            if (++this->frames_since_clear_ >= CLEAR_PRESENT_TIMEOUT_FRAMES) {
+                this->PresentFrame(this->state_->displayView());
             }
+            break;
+    }
+}
 
-            case 0x0D: {
-                // DXYN - Draws a sprite at coordinate (VX, VY) that has a width of 8 pixels and a height of N pixels.
-                this->draw_flag_ = true;
-                return ExecuteDXYN(this->state_, op_code);
-            }
+void CHIP8::Present() {
+    this->draw_count_++;
+    this->display_->updateDisplay(this->state_);
+    this->state_->clearDisplayDamage();
+}
 
-            case 0x0E: {
-                // There are two op codes we are concerned about  when the first nibble is 0x0E
-                uint8_t e_op_code = op_code & 0x00FF;
-                if (e_op_code == 0x9E) {
-                    // EX9E - Skips the next instruction if the key stored in VX is pressed.
-                    // (Usually the next instruction is a jump to skip a code block)
-                    return ExecuteEX9E(this->state_, op_code, this->input_);
-                }
-                else if (e_op_code == 0xA1) {
-                    // EXA1 - Skips the next instruction if the key stored in VX isn't pressed.
-                    // (Usually the next instruction is a jump to skip a code block)
-                    return ExecuteEXA1(this->state_, op_code, this->input_);
-                }
-                else {
-                    stringstream error_string;
-                    error_string << "Op Code " << op_code << " has not yet been implemented." << endl;
-                    throw OperationNotImplementedException(error_string.str());
-                }
-            }
+void CHIP8::Redraw() {
+    // An invalidated display redraws everything, whatever the damage
+    this->display_->invalidate();
+    FrameBufferView frame = {this->presented_display_, this->presented_width_, this->presented_height_};
+    if (this->presentation_mode_ == PresentationMode::EveryDraw) {
+        frame = this->state_->displayView();
+    }
+    this->display_->updateDisplay(frame, DisplayDamage());
+}
 
-            case 0x0F: {
-                // There are two op codes we are concerned about  when the first nibble is 0x0E
-                uint8_t f_op_code = op_code & 0x00FF;
-
-                switch(f_op_code) {
-                    case 0x07: {
-                        // 0xFX07 -Sets VX to the value of the delay timer.
-                        return ExecuteFX07(this->state_, op_code);
-                    }
-                    case 0x0A: {
-                        // 0xFX0A - A key press is awaited, and then stored in VX.
-                        return ExecuteFX0A(this->state_, op_code, this->input_);
-                    }
-                    case 0x15: {
-                        // 0xFX15 - Sets the delay timer to VX
-                        return ExecuteFX15(this->state_, op_code);
-                    }
-                    case 0x18: {
-                        // 0xFX18 - Sets the sound timer to VX.
-                        return ExecuteFX18(this->state_, op_code);
-                    }
-                    case 0x1E: {
-                        // 0xFX1E - Adds VX to I.
-                        // VF is set to 1 when there is a range overflow (I+VX>0xFFF), and to 0 when there isn't.
-                        return ExecuteFX1E(this->state_, op_code);
-                    }
-                    case 0x29: {
-                        // 0xFX29 - Sets I to the location of the sprite for the character in VX.
-                        return ExecuteFX29(this->state_, op_code);
-                    }
-                    case 0x33: {
-                        // 0xFX33 - Stores the binary-coded decimal representation of VX,
-                        // with the most significant of three digits at the address in I
-                        return ExecuteFX33(this->state_, op_code);
-                    }
-                    case 0x55: {
-                        // 0xFX55 - Stores V0 to VX (including VX) in memory starting at address I.
-                        return ExecuteFX55(this->state_, op_code);
-                    }
-                    case 0x65: {
-                        // 0xFX65 - Fills V0 to VX (including VX) with values from memory starting at address I.
-                        return ExecuteFX65(this->state_, op_code);
-                    }
-                }
-            }
+void CHIP8::PresentFrame(const FrameBufferView& frame) {
+    DisplayDamage damage;
+    bool resized = frame.width != this->presented_width_ || frame.height != this->presented_height_;
+    for (int y = 0; y < frame.height; y++) {
+        for (int word = 0; word < frame.wordsPerRow(); word++) {
+            uint64_t presented = resized ? ~frame.row(y)[word] : this->presented_display_[y * frame.wordsPerRow() + word];
+            damage.add(y, frame.row(y)[word] ^ presented, word);
+        }
+    }
+    if (damage.empty() && !resized) {
+        return;
+    }
+    memcpy(this->presented_display_, frame.rows, frame.height * frame.wordsPerRow() * sizeof(uint64_t));
+    this->presented_width_ = frame.width;
+    this->presented_height_ = frame.height;
+
+    this->draw_count_++;
+    FrameBufferView presented = {this->presented_display_, frame.width, frame.height};
+    this->display_->updateDisplay(presented, damage);
+    this->state_->clearDisplayDamage();
+}
+
+int CHIP8::ProcessFrames(int frame_count) {
+    if (this->execution_mode_ == ExecutionMode::Interpreter) {
+        for (int frame = 0; frame < frame_count; frame++) {
+            this->ProcessCurrentFrame();
+        }
+        return frame_count;
+    }
+
+    int processed = 0;
+    while (processed < frame_count) {
+        bool refresh_display = false;
+        if (this->execution_mode_ == ExecutionMode::Jit) {
+            processed += this->jit_compiler_->run(frame_count - processed, refresh_display);
+        } else if (this->execution_mode_ == ExecutionMode::Recompiled) {
+            processed += this->recompiled_program_->run(frame_count - processed, refresh_display);
+        } else {
+            processed += this->threaded_interpreter_->run(frame_count - processed, refresh_display);
         }
 
-        default: {
-            stringstream error_string;
-            error_string << "Op Code " << op_code << " has not yet been implemented." << endl;
-            throw OperationNotImplementedException(error_string.str());
+        if (refresh_display) {
+            this->OnDraw();
         }
     }
+    return processed;
+}
+
+int CHIP8::ProcessCurrentFrame() {
+
+     // Get current PC
+    uint16_t current_pc = this->state_->programCounter();
+
+    // Fetch the instruction decoded the last time this address was executed
+    const MicroOp& micro_op = this->instruction_cache_->fetch(current_pc);
+
+    // Move program counter forward 16 bits
+    this->state_->setProgramCounter(current_pc + 2);
+
+    if (micro_op.refreshes_display) {
+        this->draw_flag_ = true;
+    }
 
-    return 1;
-}
\ No newline at end of file
+    // Execute the instruction and return the number of CPU cycles used to process it
+    int cycles = micro_op.execute(this->state_, this->input_, micro_op.instruction);
+
+    if (this->draw_flag_ == true) {
+        // Reset flag
+        this->draw_flag_ = false;
+        // Refresh the display
+        this->OnDraw();
+    }
+
+    return cycles;
+}
+
+int CHIP8::ProcessOpCode(uint16_t op_code) {
+    // Resolve the handler for the op code from the pre-built dispatch table
+    const OpCodeEntry& entry = OP_CODE_TABLE.lookup(op_code, this->quirkProfile());
+
+    if (entry.refreshes_display) {
+        this->draw_flag_ = true;
+    }
+
+    return entry.execute(this->state_, this->input_, Instruction(op_code));
+}
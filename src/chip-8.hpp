@@ -11,14 +11,104 @@
 #ifndef CHIP_8_H
 #define CHIP_8_H
 
+#include <functional>
 #include <iostream>
 #include <vector>
 #include "chip-8_state.hpp"
+#include "frame_scheduler.hpp"
+#include "idle_loop_detector.hpp"
+#include "instruction_cache.hpp"
+#include "recompiled_program.hpp"
+#include "quirks.hpp"
+#include "threaded_interpreter.hpp"
 #include "input/input_interface.hpp"
 #include "display/display_interface.hpp"
+#include "jit/jit_compiler.hpp"
 
 using namespace std;
 
+// The timers run at 60Hz while instructions run at around 500Hz
+static const int INSTRUCTIONS_PER_TIMER_TICK = 8;
+
+// Frames are paced at the frequency of the timers
+static const int FRAMES_PER_SECOND = 60;
+
+/**
+ * @brief Strategies available to execute CHIP-8 instructions
+ *
+ */
+enum class ExecutionMode {
+    // Instructions are decoded and executed one at a time
+    Interpreter,
+    // Instructions are executed by handlers jumping directly to the next handler
+    Threaded,
+    // Basic blocks are compiled to native code, only available on x86-64
+    Jit,
+    // Basic blocks were translated to C++ ahead of time, only available once a recompiled ROM is loaded
+    Recompiled
+};
+
+// Frames without a clear after which the clear presentation mode falls back to presenting at vblank
+static const int CLEAR_PRESENT_TIMEOUT_FRAMES = 4;
+
+/**
+ * @brief When the display is updated with the content of the framebuffer
+ *
+ */
+enum class PresentationMode {
+    // After every instruction drawing on the display
+    EveryDraw,
+    // Once per 60Hz timer update, when the display changed
+    VBlank,
+    // With the frame drawn up to each clear, as games erase and redraw everything between two clears.
+    // Games that stop clearing are presented at vblank.
+    Clear
+};
+
+/**
+ * @brief Reason a batch of instructions stopped
+ *
+ */
+enum class StopReason {
+    // The requested number of cycles was executed
+    Cycles,
+    // The requested number of frames was executed
+    Frames,
+    // The predicate of RunUntil returned true
+    Predicate,
+    // RunUntil reached its cycle limit before the predicate returned true
+    CycleLimit,
+    // The program exited with 00FD
+    Exit
+};
+
+/**
+ * @brief Summary of a batch of instructions executed by RunCycles, RunFrames or RunUntil
+ *
+ */
+struct RunSummary {
+    // Number of instructions executed
+    long cycles = 0;
+
+    // Number of 60Hz timer updates performed
+    long frames = 0;
+
+    // Number of times the display was refreshed
+    long draws = 0;
+
+    // Number of the cycles spent in idle loops, skipped without executing them
+    long idle_cycles = 0;
+
+    // Why the batch ended
+    StopReason stop_reason = StopReason::Cycles;
+};
+
+/**
+ * @brief Condition checked by RunUntil after every instruction
+ *
+ */
+typedef function<bool(CHIP8_State*)> RunPredicate;
+
 class CHIP8
 {
 
@@ -33,18 +123,164 @@ public:
     CHIP8(DisplayInterface* display, InputInterface* input, CHIP8_State* state=NULL);
 
     /**
-     * @brief Loads a CHIP-8 Rom into the emulator memory
+     * @brief Destroy the CHIP8 object
+     *
+     */
+    ~CHIP8();
+
+    /**
+     * @brief Loads a CHIP-8 Rom into the emulator memory. A two page hires program of the COSMAC VIP, starting with
+     * 0x1260, switches the state to the 64x64 display and jumps past its hires interpreter.
      *
      * @param rom Byte array containing rom data
      */
     void LoadRom(vector<char> *rom);
 
     /**
-     * @brief Begins emulation of CHIP-8
+     * @brief Loads a ROM recompiled by chip-8-recompile into the emulator memory, enabling the recompiled mode and
+     * the quirks it was recompiled with
+     *
+     * @param rom The recompiled ROM, must outlive the emulator
+     */
+    void LoadRecompiledRom(const RecompiledRom* rom);
+
+    /**
+     * @brief Begins emulation of CHIP-8, running instructionsPerFrame() instructions then updating the timers
+     * 60 times per second, until the program exits
      *
      */
     void Start();
 
+    /**
+     * @brief Sets the number of instructions executed per 60Hz frame, which sets the emulation speed
+     *
+     * @param instructions The number of instructions per frame, at least 1
+     */
+    void SetInstructionsPerFrame(int instructions);
+
+    /**
+     * @brief The number of instructions executed per 60Hz frame
+     *
+     * @return int The number of instructions per frame
+     */
+    int instructionsPerFrame();
+
+    /**
+     * @brief Enables skipping the iterations of idle loops up to the next timer update in the batch API
+     *
+     * Skipped iterations are counted as executed cycles, the resulting state is the same as running them.
+     *
+     * @param enabled Whether idle loops are skipped, enabled by default
+     */
+    void SetIdleLoopSkipping(bool enabled);
+
+    /**
+     * @brief Selects when the display is updated
+     *
+     * @param mode The presentation mode, EveryDraw by default
+     */
+    void SetPresentationMode(PresentationMode mode);
+
+    /**
+     * @brief When the display is updated
+     *
+     * @return PresentationMode The active presentation mode
+     */
+    PresentationMode presentationMode();
+
+    /**
+     * @brief Shows the display again in full, after the terminal it is drawn on was resized
+     *
+     */
+    void Redraw();
+
+    /**
+     * @brief Measured speed and pacing accuracy of the frames run by Start
+     *
+     * @return const FrameStatistics& The statistics of the frame scheduler
+     */
+    const FrameStatistics& frameStatistics();
+
+    /**
+     * @brief Decrements the delay and sound timers, called at 60Hz
+     *
+     */
+    void UpdateTimers();
+
+    /**
+     * @brief The state the emulator operates on
+     *
+     * @return CHIP8_State* The internal state of the emulator
+     */
+    CHIP8_State* state();
+
+    /**
+     * @brief Selects how instructions are executed. Falls back to the interpreter if the mode is not supported,
+     * which is always the case for XO-CHIP states, and for recompiled code reproducing other quirks.
+     *
+     * @param mode The requested execution mode
+     */
+    void SetExecutionMode(ExecutionMode mode);
+
+    /**
+     * @brief The mode currently used to execute instructions
+     *
+     * @return ExecutionMode The active execution mode
+     */
+    ExecutionMode executionMode();
+
+    /**
+     * @brief Selects the CHIP-8 implementation whose quirks are reproduced, usually when the ROM is loaded. Every
+     * execution mode switches to the handlers instantiated for the profile.
+     *
+     * @param profile The quirks to reproduce
+     */
+    void SetQuirkProfile(QuirkProfile profile);
+
+    /**
+     * @brief The quirks currently reproduced
+     *
+     */
+    QuirkProfile quirkProfile();
+
+    /**
+     * @brief Executes the provided number of instructions with the active execution mode
+     *
+     * The timers are updated every instructionsPerFrame() instructions, counted across calls, so a run split in
+     * several batches updates the timers exactly like a single batch.
+     *
+     * @param cycles The number of instructions to execute
+     * @return RunSummary The summary of the batch
+     */
+    RunSummary RunCycles(long cycles);
+
+    /**
+     * @brief Executes instructions until the timers were updated the provided number of times
+     *
+     * @param frames The number of 60Hz frames to execute
+     * @return RunSummary The summary of the batch
+     */
+    RunSummary RunFrames(long frames);
+
+    /**
+     * @brief Executes instructions until the predicate returns true
+     *
+     * The predicate is checked after every instruction, so compiled execution modes run one instruction at a time.
+     *
+     * @param predicate The condition ending the batch
+     * @param max_cycles The maximum number of instructions to execute, 0 for no limit
+     * @return RunSummary The summary of the batch
+     */
+    RunSummary RunUntil(RunPredicate predicate, long max_cycles = 0);
+
+    /**
+     * @brief Moves the CHIP-8 state the provided number of frames forward with the active execution mode
+     *
+     * @param frame_count The number of frames to process
+     * @return int The number of frames processed
+     */
+    int ProcessFrames(int frame_count);
+
     /**
      * @brief Moves the CHIP-8 state a single frame forward
      *
@@ -80,6 +316,146 @@ private:
      */
     CHIP8_State* state_;
 
+    /**
+     * @brief Pre-decoded instructions for every address in memory
+     *
+     */
+    InstructionCache* instruction_cache_;
+
+    /**
+     * @brief Interpreter used in threaded mode
+     *
+     */
+    ThreadedInterpreter* threaded_interpreter_;
+
+    /**
+     * @brief Native code compiler, only created in JIT mode
+     *
+     */
+    JitCompiler* jit_compiler_ = NULL;
+
+    /**
+     * @brief Runtime of the recompiled ROM, only created once a recompiled ROM is loaded
+     *
+     */
+    RecompiledProgram* recompiled_program_ = NULL;
+
+    /**
+     * @brief The mode used to execute instructions
+     *
+     */
+    ExecutionMode execution_mode_ = ExecutionMode::Interpreter;
+
+    /**
+     * @brief Number of instructions executed per 60Hz frame
+     *
+     */
+    int instructions_per_frame_ = INSTRUCTIONS_PER_TIMER_TICK;
+
+    /**
+     * @brief Instructions left before the next timer update of the batch API
+     *
+     */
+    int cycles_until_timers_ = INSTRUCTIONS_PER_TIMER_TICK;
+
+    /**
+     * @brief Number of display refreshes since the emulator was created
+     *
+     */
+    long draw_count_ = 0;
+
+    /**
+     * @brief Finds the loops spinning until the next timer update
+     *
+     */
+    IdleLoopDetector* idle_loop_detector_;
+
+    /**
+     * @brief Whether the batch API skips idle loops
+     *
+     */
+    bool idle_loop_skipping_ = true;
+
+    /**
+     * @brief Runs the current loop once, then skips its following iterations if it left the state unchanged
+     *
+     * @param max_cycles The maximum number of cycles to run or skip
+     * @param summary Updated with the idle cycles skipped
+     * @return int The number of cycles run and skipped, 0 if the program counter is not in a candidate loop
+     */
+    int SkipIdleLoop(int max_cycles, RunSummary& summary);
+
+    /**
+     * @brief Executes instructions up to the next timer update
+     *
+     * @param max_cycles The maximum number of instructions to execute
+     * @param summary Updated with the instructions executed and the timer update
+     */
+    void RunBatch(long max_cycles, RunSummary& summary);
+
+    /**
+     * @brief When the display is updated
+     *
+     */
+    PresentationMode presentation_mode_ = PresentationMode::EveryDraw;
+
+    /**
+     * @brief The frame last shown on the display, used to compute the damage of coalesced presentations
+     *
+     */
+    uint64_t presented_display_[MAX_FRAME_BUFFER_WORDS] = {0};
+    int presented_width_ = DISPLAY_WIDTH;
+    int presented_height_ = DISPLAY_HEIGHT;
+
+    /**
+     * @brief The display as it was before the last clear
+     *
+     */
+    uint64_t clear_latch_[MAX_FRAME_BUFFER_WORDS] = {0};
+
+    /**
+     * @brief Number of display clears already presented
+     *
+     */
+    long presented_clears_ = 0;
+
+    /**
+     * @brief Number of timer updates since the display was last cleared
+     *
+     */
+    int frames_since_clear_ = 0;
+
+    /**
+     * @brief Handles an instruction that drew on the display according to the presentation mode
+     *
+     */
+    void OnDraw();
+
+    /**
+     * @brief Handles a 60Hz timer update according to the presentation mode
+     *
+     */
+    void OnVBlank();
+
+    /**
+     * @brief Shows the live display, with the damage tracked by the state
+     *
+     */
+    void Present();
+
+    /**
+     * @brief Shows the provided frame if it differs from the frame last shown
+     *
+     * @param frame The frame to show
+     */
+    void PresentFrame(const FrameBufferView& frame);
+
+    /**
+     * @brief Paces the frames run by Start
+     *
+     */
+    FrameScheduler scheduler_ = FrameScheduler(FRAMES_PER_SECOND);
+
     /**
      * @brief Flag set to true when the display must be refreshed
      *
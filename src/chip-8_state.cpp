@@ -8,13 +8,68 @@
  * @copyright Copyright (c) 2020
  *
  */
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <new>
+#include <stdexcept>
 #include <vector>
 #include "chip-8_state.hpp"
 #include "exceptions.hpp"
 
 using namespace std;
 
+// Hard coded definition of CHIP-8 font set
+static const uint8_t FONT_SET[80] = {
+    0xF0, 0x90, 0x90, 0x90, 0xF0, // 0
+    0x20, 0x60, 0x20, 0x20, 0x70, // 1
+    0xF0, 0x10, 0xF0, 0x80, 0xF0, // 2
+    0xF0, 0x10, 0xF0, 0x10, 0xF0, // 3
+    0x90, 0x90, 0xF0, 0x10, 0x10, // 4
+    0xF0, 0x80, 0xF0, 0x10, 0xF0, // 5
+    0xF0, 0x80, 0xF0, 0x90, 0xF0, // 6
+    0xF0, 0x10, 0x20, 0x40, 0x40, // 7
+    0xF0, 0x90, 0xF0, 0x90, 0xF0, // 8
+    0xF0, 0x90, 0xF0, 0x10, 0xF0, // 9
+    0xF0, 0x90, 0xF0, 0x90, 0x90, // A
+    0xE0, 0x90, 0xE0, 0x90, 0xE0, // B
+    0xF0, 0x80, 0x80, 0x80, 0xF0, // C
+    0xE0, 0x90, 0x90, 0x90, 0xE0, // D
+    0xF0, 0x80, 0xF0, 0x80, 0xF0, // E
+    0xF0, 0x80, 0xF0, 0x80, 0x80  // F
+};
+
+// SUPER-CHIP 8x10 digits, used by FX30
+static const uint8_t BIG_FONT_SET[100] = {
+    0x3C, 0x7E, 0xE7, 0xC3, 0xC3, 0xC3, 0xC3, 0xE7, 0x7E, 0x3C, // 0
+    0x18, 0x38, 0x58, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x3C, // 1
+    0x3E, 0x7F, 0xC3, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xFF, 0xFF, // 2
+    0x3C, 0x7E, 0xC3, 0x03, 0x0E, 0x0E, 0x03, 0xC3, 0x7E, 0x3C, // 3
+    0x06, 0x0E, 0x1E, 0x36, 0x66, 0xC6, 0xFF, 0xFF, 0x06, 0x06, // 4
+    0xFF, 0xFF, 0xC0, 0xC0, 0xFC, 0xFE, 0x03, 0xC3, 0x7E, 0x3C, // 5
+    0x3E, 0x7C, 0xC0, 0xC0, 0xFC, 0xFE, 0xC3, 0xC3, 0x7E, 0x3C, // 6
+    0xFF, 0xFF, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0x60, 0x60, // 7
+    0x3C, 0x7E, 0xC3, 0xC3, 0x7E, 0x7E, 0xC3, 0xC3, 0x7E, 0x3C, // 8
+    0x3C, 0x7E, 0xC3, 0xC3, 0x7F, 0x3F, 0x03, 0x03, 0x3E, 0x7C  // 9
+};
+
+/**
+ * @brief Allocates a block on its alignment, which new does not guarantee for over aligned types before C++17
+ *
+ * @tparam T The type of the block
+ * @return T* The uninitialized block, released with free
+ * @throws bad_alloc The block could not be allocated
+ */
+template <typename T>
+static T* AllocateAligned() {
+    void* block = NULL;
+    if (posix_memalign(&block, alignof(T), sizeof(T)) != 0) {
+        throw bad_alloc();
+    }
+    return static_cast<T*>(block);
+}
+
 CHIP8_State::CHIP8_State(
         int programCounter,
         uint16_t indexRegister,
@@ -23,6 +78,11 @@ CHIP8_State::CHIP8_State(
         uint8_t* vRegisters,
         uint8_t* memory) {
 
+    this->data_ = AllocateAligned<CHIP8_StateData>();
+
+    // Registers, memory and display start cleared, with the font loaded
+    memcpy(this->data_, &CHIP8_State::initialData(), sizeof(CHIP8_StateData));
+
     // Initialize program counter
     this->setProgramCounter(programCounter);
 
@@ -34,28 +94,47 @@ CHIP8_State::CHIP8_State(
     this->setSoundTimer(soundTimer);
 
     // Initialize the V Registers
-    if (vRegisters == NULL) {
-        this->vRegisters_ = new uint8_t[V_REGISTER_COUNT];
-    } else {
-        this->vRegisters_ = vRegisters;
+    if (vRegisters != NULL) {
+        memcpy(this->data_->v_registers, vRegisters, V_REGISTER_COUNT);
     }
 
-    // Initialize memory for CHIP-8 RAM
-    if (memory == NULL) {
-        this->memory_ = new uint8_t[RAM_SIZE];
-    } else {
-        this->memory_ = memory;
+    // Initialize memory for CHIP-8 RAM, the fonts always occupy the first 180 bytes
+    if (memory != NULL) {
+        memcpy(this->data_->memory, memory, RAM_SIZE);
+        memcpy(&this->data_->memory[FONT_MEMORY_LOCATION], FONT_SET, sizeof(FONT_SET));
+        memcpy(&this->data_->memory[BIG_FONT_MEMORY_LOCATION], BIG_FONT_SET, sizeof(BIG_FONT_SET));
     }
 
     // The 96 bytes below the display are reserved for the call stack
     // 0xEA0-0xEFF
-   this->stack_ = &(this->memory_[STACK_MEMORY_LOCATION]);
+    this->stack_ = &(this->data_->memory[STACK_MEMORY_LOCATION]);
+}
 
-    // Load the font set into the first 80 bytes of memory
-    for (uint8_t character_index = 0; character_index < 80; character_index++) {
-        uint8_t character_address = character_index + FONT_MEMORY_LOCATION;
-        this->memory_[character_address] = this->fontset_[character_index];
-    }
+CHIP8_State::~CHIP8_State() {
+    free(this->data_);
+    free(this->xo_);
+}
+
+/**
+ * @brief Builds the state of a machine that was just powered on
+ *
+ */
+static CHIP8_StateData MakeInitialData() {
+    CHIP8_StateData initial_data;
+    memset(&initial_data, 0, sizeof(CHIP8_StateData));
+    memcpy(&initial_data.memory[FONT_MEMORY_LOCATION], FONT_SET, sizeof(FONT_SET));
+    memcpy(&initial_data.memory[BIG_FONT_MEMORY_LOCATION], BIG_FONT_SET, sizeof(BIG_FONT_SET));
+    initial_data.program_counter = INITAL_PROGRAM_COUNTER;
+    initial_data.stack_pointer = -2;
+    initial_data.planes = 1;
+    SeedRandom(initial_data.random_state, DEFAULT_RANDOM_SEED);
+    return initial_data;
+}
+
+const CHIP8_StateData& CHIP8_State::initialData() {
+    // Built once, even when states are created from several threads at the same time
+    static const CHIP8_StateData initial_data = MakeInitialData();
+    return initial_data;
 }
 
 void CHIP8_State::pushStack(uint16_t address) {
@@ -63,23 +142,29 @@ void CHIP8_State::pushStack(uint16_t address) {
     uint8_t ms_address = (address & 0xFF00) >> 8;
     uint8_t ls_address = address & 0x00FF;
 
-    this->stackPointer_ += 2;
+    this->data_->stack_pointer += 2;
+
+    this->stack_[this->data_->stack_pointer] = ms_address;
+    this->stack_[this->data_->stack_pointer + 1] = ls_address;
 
-    this->stack_[this->stackPointer_] = ms_address;
-    this->stack_[this->stackPointer_ + 1] = ls_address;
+    // The stack lives in main memory, so listeners must see the write too
+    if (!this->memoryListeners_.empty()) {
+        this->notifyMemoryWrite(STACK_MEMORY_LOCATION + this->data_->stack_pointer);
+        this->notifyMemoryWrite(STACK_MEMORY_LOCATION + this->data_->stack_pointer + 1);
+    }
 }
 
 uint16_t CHIP8_State::popStack() {
     // If the stack is empty prevent pop
-    if (this->stackPointer_ < 0) {
+    if (this->data_->stack_pointer < 0) {
         throw InvalidStackOperationException("Stack is empty");
     }
 
     // Get 16 bit address from top of stack then decrement pointer
     // Stack is array of bytes, so 16 bit address is grabbed in two parts
-    uint16_t ms_address = (uint16_t)this->stack_[this->stackPointer_];
-    uint16_t ls_address = (uint16_t)this->stack_[this->stackPointer_ + 1];
-    this->stackPointer_ -= 2;
+    uint16_t ms_address = (uint16_t)this->stack_[this->data_->stack_pointer];
+    uint16_t ls_address = (uint16_t)this->stack_[this->data_->stack_pointer + 1];
+    this->data_->stack_pointer -= 2;
 
     uint16_t address = (ms_address << 8) | ls_address;
     return address;
@@ -87,79 +172,501 @@ uint16_t CHIP8_State::popStack() {
 
 uint16_t CHIP8_State::peekStack() {
     // If the stack is empty prevent pop
-    if (this->stackPointer_ < 0) {
+    if (this->data_->stack_pointer < 0) {
         throw InvalidStackOperationException("Stack is empty");
     }
 
     // Get 16 bit address from top of stack then decrement pointer
     // Stack is array of bytes, so 16 bit address is grabbed in two parts
-    uint16_t ms_address = (uint16_t)this->stack_[this->stackPointer_];
-    uint16_t ls_address = (uint16_t)this->stack_[this->stackPointer_ + 1];
+    uint16_t ms_address = (uint16_t)this->stack_[this->data_->stack_pointer];
+    uint16_t ls_address = (uint16_t)this->stack_[this->data_->stack_pointer + 1];
 
     uint16_t address = (ms_address << 8) | ls_address;
     return address;
 }
 
 int16_t CHIP8_State::stackPointer() {
-    return this->stackPointer_;
+    return this->data_->stack_pointer;
 }
 
 uint8_t CHIP8_State::vRegister(uint8_t register_index) {
-    return this->vRegisters_[register_index];
+    return this->data_->v_registers[register_index];
 }
 
 void CHIP8_State::setVRegister(uint8_t register_index, uint8_t value) {
-    this->vRegisters_[register_index] = value;
+    this->data_->v_registers[register_index] = value;
 }
 
 uint16_t CHIP8_State::indexRegister() {
-    return this->indexRegister_;
+    return this->data_->index_register;
 }
 
 void CHIP8_State::setIndexRegister(uint16_t value) {
-    this->indexRegister_ = value;
+    this->data_->index_register = value;
 }
 
 uint16_t CHIP8_State::programCounter() {
-    return this->programCounter_;
+    return this->data_->program_counter;
 }
 
 void CHIP8_State::setProgramCounter(uint16_t value) {
-    this->programCounter_ = value;
+    this->data_->program_counter = value;
 }
 
 void CHIP8_State::incrementProgramCounter(int value) {
-    this->programCounter_ += value;
+    this->data_->program_counter += value;
 }
 
 uint8_t CHIP8_State::delayTimer() {
-    return this->delayTimer_;
+    return this->data_->delay_timer;
 }
 
 void CHIP8_State::setDelayTimer(uint8_t value) {
-    this->delayTimer_ = value;
+    this->data_->delay_timer = value;
 }
 
 uint8_t CHIP8_State::soundTimer() {
-    return this->soundTimer_;
+    return this->data_->sound_timer;
 }
 
 void  CHIP8_State::setSoundTimer(uint8_t value) {
-    this->soundTimer_ = value;
+    this->data_->sound_timer = value;
+}
+
+void CHIP8_State::enableXOChip() {
+    if (this->xo_ != NULL) {
+        return;
+    }
+    this->xo_ = AllocateAligned<XOChipStateData>();
+    memset(this->xo_, 0, sizeof(XOChipStateData));
+    this->updateComposite();
+}
+
+bool CHIP8_State::xoChip() {
+    return this->xo_ != NULL;
+}
+
+int CHIP8_State::memorySize() {
+    return this->xo_ != NULL ? XO_CHIP_RAM_SIZE : RAM_SIZE;
+}
+
+uint8_t CHIP8_State::planes() {
+    return this->data_->planes;
+}
+
+void CHIP8_State::setPlanes(uint8_t planes) {
+    this->data_->planes = planes & 0x3;
+}
+
+void CHIP8_State::skipInstruction() {
+    uint16_t program_counter = this->data_->program_counter;
+    if (this->xo_ != NULL && this->memoryValue(program_counter) == 0xF0 && this->memoryValue(program_counter + 1) == 0x00) {
+        program_counter += 2;
+    }
+    this->data_->program_counter = program_counter + 2;
 }
 
 uint8_t CHIP8_State::memoryValue(uint16_t index) {
-    return this->memory_[index];
+    if (index < RAM_SIZE) {
+        return this->data_->memory[index];
+    }
+    return this->highMemoryValue(index);
 }
 
 void CHIP8_State::setMemoryValue(uint16_t index, uint8_t value) {
-    this->memory_[index] = value;
+    if (index < RAM_SIZE) {
+        this->data_->memory[index] = value;
+    } else {
+        this->setHighMemoryValue(index, value);
+    }
+
+    if (!this->memoryListeners_.empty()) {
+        this->notifyMemoryWrite(this->xo_ != NULL ? index : index % RAM_SIZE);
+    }
+}
+
+uint8_t CHIP8_State::highMemoryValue(uint16_t index) {
+    if (this->xo_ == NULL) {
+        return this->data_->memory[index % RAM_SIZE];
+    }
+    return this->xo_->high_memory[index - RAM_SIZE];
+}
+
+void CHIP8_State::setHighMemoryValue(uint16_t index, uint8_t value) {
+    if (this->xo_ == NULL) {
+        this->data_->memory[index % RAM_SIZE] = value;
+    } else {
+        this->xo_->high_memory[index - RAM_SIZE] = value;
+    }
+}
+
+void CHIP8_State::addMemoryListener(MemoryWriteListener* listener) {
+    this->memoryListeners_.push_back(listener);
+}
+
+void CHIP8_State::removeMemoryListener(MemoryWriteListener* listener) {
+    this->memoryListeners_.erase(
+        remove(this->memoryListeners_.begin(), this->memoryListeners_.end(), listener),
+        this->memoryListeners_.end());
+}
+
+void CHIP8_State::notifyMemoryWrite(uint16_t address) {
+    for (MemoryWriteListener* listener : this->memoryListeners_) {
+        listener->onMemoryWrite(address);
+    }
+}
+
+template <typename Operation>
+void CHIP8_State::forEachPlane(Operation operation) {
+    // The geometry is picked once, each framebuffer type then runs its own specialized loops
+    uint8_t planes = this->xo_ != NULL ? this->data_->planes : 1;
+    switch (this->data_->display_mode) {
+        case DisplayMode::Lores:
+            if (planes & 1) {
+                operation(this->data_->display);
+            }
+            if (planes & 2) {
+                operation(this->xo_->display);
+            }
+            break;
+        case DisplayMode::Hires:
+            if (planes & 1) {
+                operation(this->data_->hires_display);
+            }
+            if (planes & 2) {
+                operation(this->xo_->hires_display);
+            }
+            break;
+        case DisplayMode::VipHires:
+            if (planes & 1) {
+                operation(this->data_->vip_display);
+            }
+            break;
+    }
+    if (this->xo_ != NULL) {
+        this->updateComposite();
+    }
+}
+
+void CHIP8_State::updateComposite() {
+    FrameBufferView first = this->firstPlaneView();
+    const uint64_t* second = NULL;
+    if (this->data_->display_mode == DisplayMode::Lores) {
+        second = this->xo_->display.words;
+    } else if (this->data_->display_mode == DisplayMode::Hires) {
+        second = this->xo_->hires_display.words;
+    }
+    for (int word = 0; word < first.height * first.wordsPerRow(); word++) {
+        this->xo_->composite[word] = first.rows[word] | (second != NULL ? second[word] : 0);
+    }
+}
+
+FrameBufferView CHIP8_State::firstPlaneView() {
+    switch (this->data_->display_mode) {
+        case DisplayMode::Hires:
+            return this->data_->hires_display.view();
+        case DisplayMode::VipHires:
+            return this->data_->vip_display.view();
+        default:
+            return this->data_->display.view();
+    }
+}
+
+void CHIP8_State::damageDisplay() {
+    FrameBufferView view = this->displayView();
+    for (int y = 0; y < view.height; y++) {
+        for (int word = 0; word < view.wordsPerRow(); word++) {
+            this->displayDamage_.add(y, ~(uint64_t)0, word);
+        }
+    }
 }
 
 bool CHIP8_State::displayValue(int x, int y ) {
-    return this->display_[x][y];
+    return this->displayView().pixel(x, y);
 }
 
 void CHIP8_State::setDisplayValue(int x, int y, bool value) {
-    this->display_[x][y] = value;
-}
\ No newline at end of file
+    uint64_t* row = this->data_->display.row(y);
+    if (this->data_->display_mode == DisplayMode::Hires) {
+        row = this->data_->hires_display.row(y);
+    } else if (this->data_->display_mode == DisplayMode::VipHires) {
+        row = this->data_->vip_display.row(y);
+    }
+    uint64_t mask = (uint64_t)1 << (63 - x % 64);
+    uint64_t pixels = value ? row[x / 64] | mask : row[x / 64] & ~mask;
+    this->displayDamage_.add(y, row[x / 64] ^ pixels, x / 64);
+    row[x / 64] = pixels;
+
+    if (this->xo_ != NULL) {
+        this->updateComposite();
+    }
+}
+
+uint64_t CHIP8_State::displayRow(int y) {
+    return this->data_->display.words[y];
+}
+
+void CHIP8_State::setDisplayRow(int y, uint64_t pixels) {
+    this->displayDamage_.add(y, this->data_->display.words[y] ^ pixels);
+    this->data_->display.words[y] = pixels;
+}
+
+void CHIP8_State::clearDisplay() {
+    if (this->clearLatch_ != NULL) {
+        FrameBufferView view = this->displayView();
+        memcpy(this->clearLatch_, view.rows, view.height * view.wordsPerRow() * sizeof(uint64_t));
+        this->clearLatchView_ = view;
+        this->clearLatchView_.rows = this->clearLatch_;
+    }
+    this->clearCount_++;
+
+    DisplayDamage& damage = this->displayDamage_;
+    this->forEachPlane([&damage](auto& plane) { plane.clear(damage); });
+}
+
+template <bool WRAP>
+bool CHIP8_State::drawSprite(uint8_t x, uint8_t y, int height, int bytes_per_row) {
+    // Each selected plane reads its own sprite, following the sprite of the previous plane
+    int sprite_size = height * bytes_per_row;
+    int plane_count = this->xo_ != NULL ? __builtin_popcount(this->data_->planes) : 1;
+
+    // Sprites read past the end of memory wrap around to its start
+    uint8_t sprite[2 * 32];
+    uint16_t index_register = this->data_->index_register;
+    for (int i = 0; i < sprite_size * plane_count; i++) {
+        sprite[i] = this->memoryValue(index_register + i);
+    }
+
+    const uint8_t* plane_sprite = sprite;
+    bool collision = false;
+    DisplayDamage& damage = this->displayDamage_;
+    this->forEachPlane([&](auto& plane) {
+        collision |= plane.template draw<WRAP>(x, y, plane_sprite, height, bytes_per_row, damage);
+        plane_sprite += sprite_size;
+    });
+    return collision;
+}
+
+template bool CHIP8_State::drawSprite<false>(uint8_t x, uint8_t y, int height, int bytes_per_row);
+template bool CHIP8_State::drawSprite<true>(uint8_t x, uint8_t y, int height, int bytes_per_row);
+
+void CHIP8_State::scrollDisplayDown(int count) {
+    DisplayDamage& damage = this->displayDamage_;
+    this->forEachPlane([count, &damage](auto& plane) { plane.scrollDown(count, damage); });
+}
+
+void CHIP8_State::scrollDisplayUp(int count) {
+    DisplayDamage& damage = this->displayDamage_;
+    this->forEachPlane([count, &damage](auto& plane) { plane.scrollUp(count, damage); });
+}
+
+void CHIP8_State::scrollDisplayRight(int count) {
+    DisplayDamage& damage = this->displayDamage_;
+    this->forEachPlane([count, &damage](auto& plane) { plane.scrollRight(count, damage); });
+}
+
+void CHIP8_State::scrollDisplayLeft(int count) {
+    DisplayDamage& damage = this->displayDamage_;
+    this->forEachPlane([count, &damage](auto& plane) { plane.scrollLeft(count, damage); });
+}
+
+FrameBufferView CHIP8_State::displayView() {
+    FrameBufferView view = this->firstPlaneView();
+    if (this->xo_ != NULL) {
+        view.rows = this->xo_->composite;
+    }
+    return view;
+}
+
+bool CHIP8_State::hires() {
+    return this->data_->display_mode == DisplayMode::Hires;
+}
+
+void CHIP8_State::setHires(bool enabled) {
+    this->setDisplayMode(enabled ? DisplayMode::Hires : DisplayMode::Lores);
+}
+
+DisplayMode CHIP8_State::displayMode() {
+    return this->data_->display_mode;
+}
+
+void CHIP8_State::setDisplayMode(DisplayMode mode) {
+    if (this->data_->display_mode == mode) {
+        return;
+    }
+    this->data_->display_mode = mode;
+    if (this->xo_ != NULL) {
+        this->updateComposite();
+    }
+
+    // Everything shown on the new display is new
+    this->damageDisplay();
+}
+
+bool CHIP8_State::exited() {
+    return this->data_->exited != 0;
+}
+
+void CHIP8_State::setExited(bool exited) {
+    this->data_->exited = exited ? 1 : 0;
+}
+
+uint8_t CHIP8_State::rplFlag(uint8_t index) {
+    return this->data_->rpl_flags[index];
+}
+
+void CHIP8_State::setRplFlag(uint8_t index, uint8_t value) {
+    this->data_->rpl_flags[index] = value;
+}
+
+void CHIP8_State::seedRandom(uint64_t seed) {
+    this->randomSeed_ = seed;
+    SeedRandom(this->data_->random_state, seed);
+}
+
+uint64_t CHIP8_State::randomSeed() {
+    return this->randomSeed_;
+}
+
+uint8_t CHIP8_State::randomByte() {
+    // The high bits of xoshiro128** are the best ones
+    return (uint8_t)(NextRandom(this->data_->random_state) >> 24);
+}
+
+const DisplayDamage& CHIP8_State::displayDamage() {
+    return this->displayDamage_;
+}
+
+void CHIP8_State::clearDisplayDamage() {
+    this->displayDamage_ = DisplayDamage();
+}
+
+void CHIP8_State::setClearLatch(uint64_t* words) {
+    this->clearLatch_ = words;
+    this->clearLatchView_.rows = words;
+}
+
+FrameBufferView CHIP8_State::clearLatchView() {
+    return this->clearLatchView_;
+}
+
+long CHIP8_State::clearCount() {
+    return this->clearCount_;
+}
+
+uint64_t CHIP8_State::displayHash() {
+    FrameBufferView view = this->displayView();
+    uint64_t hash = 0xCBF29CE484222325;
+    for (int word = 0; word < view.height * view.wordsPerRow(); word++) {
+        for (int byte = 0; byte < 8; byte++) {
+            hash ^= (view.rows[word] >> (8 * byte)) & 0xFF;
+            hash *= 0x100000001B3;
+        }
+    }
+    return hash;
+}
+
+CHIP8_StateData* CHIP8_State::allocateSnapshot() {
+    CHIP8_StateData* snapshot = AllocateAligned<CHIP8_StateData>();
+    memset(snapshot, 0, sizeof(CHIP8_StateData));
+    return snapshot;
+}
+
+XOChipStateData* CHIP8_State::allocateXOChipSnapshot() {
+    XOChipStateData* xo_snapshot = AllocateAligned<XOChipStateData>();
+    memset(xo_snapshot, 0, sizeof(XOChipStateData));
+    return xo_snapshot;
+}
+
+void CHIP8_State::freeSnapshot(CHIP8_StateData* snapshot) {
+    free(snapshot);
+}
+
+void CHIP8_State::freeSnapshot(XOChipStateData* xo_snapshot) {
+    free(xo_snapshot);
+}
+
+void CHIP8_State::snapshot(CHIP8_StateData* snapshot, XOChipStateData* xo_snapshot) {
+    if (this->xo_ != NULL) {
+        if (xo_snapshot == NULL) {
+            throw invalid_argument("Snapshots of XO-CHIP states require a block for the XO-CHIP memory and planes");
+        }
+        memcpy(xo_snapshot, this->xo_, sizeof(XOChipStateData));
+    }
+    memcpy(snapshot, this->data_, sizeof(CHIP8_StateData));
+}
+
+void CHIP8_State::restore(const CHIP8_StateData& snapshot, const XOChipStateData* xo_snapshot) {
+    if (this->xo_ != NULL) {
+        if (xo_snapshot == NULL) {
+            throw invalid_argument("Restoring an XO-CHIP state requires its XO-CHIP memory and planes");
+        }
+        if (!this->memoryListeners_.empty()) {
+            for (int address = RAM_SIZE; address < XO_CHIP_RAM_SIZE; address++) {
+                if (this->xo_->high_memory[address - RAM_SIZE] != xo_snapshot->high_memory[address - RAM_SIZE]) {
+                    this->xo_->high_memory[address - RAM_SIZE] = xo_snapshot->high_memory[address - RAM_SIZE];
+                    this->notifyMemoryWrite(address);
+                }
+            }
+        }
+        // The composite is combined again from the restored planes
+        memcpy(this->xo_, xo_snapshot, sizeof(XOChipStateData));
+    }
+    this->restoreData(snapshot);
+}
+
+void CHIP8_State::restoreData(const CHIP8_StateData& snapshot) {
+    if (!this->memoryListeners_.empty()) {
+        // Listeners are only told about the addresses that actually change
+        for (int address = 0; address < RAM_SIZE; address++) {
+            if (this->data_->memory[address] != snapshot.memory[address]) {
+                this->data_->memory[address] = snapshot.memory[address];
+                this->notifyMemoryWrite(address);
+            }
+        }
+    }
+
+    // The damage covers the pixels that differ from the display shown before the restore. With XO-CHIP the
+    // composite is combined again from every plane and the whole display is redrawn.
+    if (this->data_->display_mode != snapshot.display_mode || this->xo_ != NULL) {
+        memcpy(this->data_, &snapshot, sizeof(CHIP8_StateData));
+        if (this->xo_ != NULL) {
+            this->updateComposite();
+        }
+        this->damageDisplay();
+        return;
+    }
+
+    FrameBufferView view = this->displayView();
+    const uint64_t* restored = snapshot.display.words;
+    if (snapshot.display_mode == DisplayMode::Hires) {
+        restored = snapshot.hires_display.words;
+    } else if (snapshot.display_mode == DisplayMode::VipHires) {
+        restored = snapshot.vip_display.words;
+    }
+    for (int y = 0; y < view.height; y++) {
+        for (int word = 0; word < view.wordsPerRow(); word++) {
+            this->displayDamage_.add(y, view.row(y)[word] ^ restored[y * view.wordsPerRow() + word], word);
+        }
+    }
+
+    memcpy(this->data_, &snapshot, sizeof(CHIP8_StateData));
+}
+
+void CHIP8_State::reset() {
+    if (this->xo_ != NULL) {
+        for (int address = RAM_SIZE; address < XO_CHIP_RAM_SIZE; address++) {
+            if (this->xo_->high_memory[address - RAM_SIZE] != 0) {
+                this->setMemoryValue(address, 0);
+            }
+        }
+        memset(&this->xo_->display, 0, sizeof(this->xo_->display));
+        memset(&this->xo_->hires_display, 0, sizeof(this->xo_->hires_display));
+    }
+    this->restoreData(CHIP8_State::initialData());
+    SeedRandom(this->data_->random_state, this->randomSeed_);
+}
+
+const CHIP8_StateData* CHIP8_State::data() {
+    return this->data_;
+}
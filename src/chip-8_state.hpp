@@ -11,17 +11,134 @@
 #ifndef CHIP_8_STATE_H
 #define CHIP_8_STATE_H
 
+#include <cstddef>
 #include <iostream>
+#include <type_traits>
+#include <vector>
+#include "packed_frame_buffer.hpp"
+#include "random.hpp"
 
 using namespace std;
 
-static int V_REGISTER_COUNT = 16;
-static int RAM_SIZE = 4096;
+static const int V_REGISTER_COUNT = 16;
+static const int RAM_SIZE = 4096;
+
+// Size of the XO-CHIP address space, reached with F000 NNNN
+static const int XO_CHIP_RAM_SIZE = 0x10000;
 
 static uint16_t INITAL_PROGRAM_COUNTER = 0x200;
 static uint16_t DISPLAY_MEMORY_LOCATION = 0xF00;
 static uint16_t STACK_MEMORY_LOCATION = 0xEA0;
 static uint16_t FONT_MEMORY_LOCATION = 0x0;
+static uint16_t BIG_FONT_MEMORY_LOCATION = 0x50;
+
+// Number of SUPER-CHIP flag registers saved by FX75
+static const int RPL_FLAG_COUNT = 16;
+
+// Seed of the random numbers of CXNN unless another one is set
+static const uint64_t DEFAULT_RANDOM_SEED = 0;
+
+/**
+ * @brief The display programs draw on
+ *
+ */
+enum class DisplayMode : uint8_t {
+    // The original 64x32 display
+    Lores,
+    // The SUPER-CHIP 128x64 display
+    Hires,
+    // The 64x64 display of the two page hires programs of the COSMAC VIP
+    VipHires
+};
+
+/**
+ * @brief Interface for objects that must be notified when the CHIP-8 memory is modified
+ *
+ */
+class MemoryWriteListener
+{
+public:
+    /**
+     * @brief Destroy the Memory Write Listener object
+     *
+     */
+    virtual ~MemoryWriteListener() = default;
+
+    /**
+     * @brief Called after a value in memory has been modified
+     *
+     * @param address The memory address that was written to
+     */
+    virtual void onMemoryWrite(uint16_t address) = 0;
+};
+
+/**
+ * @brief Every value making up the state of a CHIP-8 machine, in a single cache line aligned block
+ *
+ * The block is trivially copyable, so a snapshot or a restore is a single memcpy. Layout, in bytes:
+ *
+ *     0x0000 - 0x0FFF  memory, with the font at 0x000, the big font at 0x050, programs from 0x200 and the call
+ *                      stack at 0xEA0
+ *     0x1000 - 0x100F  V registers
+ *     0x1010           index register, 16 bits
+ *     0x1012           program counter, 16 bits
+ *     0x1014           stack pointer, 16 bits signed, -2 when the stack is empty
+ *     0x1016           delay timer, 8 bits
+ *     0x1017           sound timer, 8 bits
+ *     0x1018           active display, a DisplayMode
+ *     0x1019           1 once the program exited with 00FD
+ *     0x101A - 0x1029  SUPER-CHIP flag registers
+ *     0x102A           XO-CHIP planes selected by FN01, bit 0 for the first plane and bit 1 for the second
+ *     0x1030 - 0x103F  state of the xoshiro128** generator used by CXNN
+ *     0x1040 - 0x113F  64x32 display, one 64 bit word per row, the most significant bit being the leftmost pixel
+ *     0x1140 - 0x153F  128x64 display, two 64 bit words per row
+ *     0x1540 - 0x173F  64x64 display, one 64 bit word per row
+ */
+struct alignas(64) CHIP8_StateData {
+    uint8_t memory[RAM_SIZE];
+    uint8_t v_registers[V_REGISTER_COUNT];
+    uint16_t index_register;
+    uint16_t program_counter;
+    int16_t stack_pointer;
+    uint8_t delay_timer;
+    uint8_t sound_timer;
+    DisplayMode display_mode;
+    uint8_t exited;
+    uint8_t rpl_flags[RPL_FLAG_COUNT];
+    uint8_t planes;
+    uint8_t reserved[5];
+    uint32_t random_state[RANDOM_STATE_WORDS];
+
+    LoresFrameBuffer display;
+    HiresFrameBuffer hires_display;
+    VipHiresFrameBuffer vip_display;
+};
+
+static_assert(is_trivially_copyable<CHIP8_StateData>::value, "The state must be copyable with memcpy");
+static_assert(offsetof(CHIP8_StateData, v_registers) == 0x1000, "Unexpected V register offset");
+static_assert(offsetof(CHIP8_StateData, program_counter) == 0x1012, "Unexpected program counter offset");
+static_assert(offsetof(CHIP8_StateData, random_state) == 0x1030, "Unexpected random state offset");
+static_assert(offsetof(CHIP8_StateData, display) == 0x1040, "Unexpected display offset");
+static_assert(offsetof(CHIP8_StateData, hires_display) == 0x1140, "Unexpected high resolution display offset");
+static_assert(offsetof(CHIP8_StateData, vip_display) == 0x1540, "Unexpected COSMAC VIP display offset");
+
+/**
+ * @brief The parts of an XO-CHIP machine a CHIP-8 machine does not have, allocated only by XO-CHIP states
+ *
+ * The first plane of each display is the one of the state block, the second plane is stored here as a separate
+ * packed framebuffer so drawing and scrolling stay word-parallel on each plane.
+ */
+struct alignas(64) XOChipStateData {
+    // Memory from 0x1000 to 0xFFFF, the first 4KB are in the state block
+    uint8_t high_memory[XO_CHIP_RAM_SIZE - RAM_SIZE];
+
+    // Second plane of each display
+    LoresFrameBuffer display;
+    HiresFrameBuffer hires_display;
+
+    // Pixels set in any plane of the active display, what monochrome displays show
+    uint64_t composite[MAX_FRAME_BUFFER_WORDS];
+};
 
 class CHIP8_State
 {
@@ -35,8 +152,8 @@ public:
      * @param indexRegister
      * @param delayTimer
      * @param soundTimer
-     * @param vRegisters
-     * @param memory
+     * @param vRegisters (optional) Initial values of the V registers, copied into the state
+     * @param memory (optional) Initial content of the memory, copied into the state before the font is loaded
      */
     CHIP8_State(
         int programCounter=INITAL_PROGRAM_COUNTER,
@@ -46,59 +163,106 @@ public:
         uint8_t* vRegisters=NULL,
         uint8_t* memory=NULL);
 
+    /**
+     * @brief Destroy the chip8 state object and its state block
+     *
+     */
+    ~CHIP8_State();
+
+    // The state block is owned by a single state, use snapshot and restore to copy it
+    CHIP8_State(const CHIP8_State&) = delete;
+    CHIP8_State& operator=(const CHIP8_State&) = delete;
+
+    // Compiled code and the threaded interpreter access the registers directly
+    friend class JitCompiler;
+    friend class ThreadedInterpreter;
+
 private:
 
-    // CHIP-8 VM has 4096 bytes of memory
-    uint8_t* memory_;
+    // Memory, registers, timers and display, in a single block
+    CHIP8_StateData* data_;
+
+    // Extended memory and second display plane, NULL unless XO-CHIP is enabled
+    XOChipStateData* xo_ = NULL;
 
     // The stack is an array of 16 16-bit values, used to store the address that the interpreter
     // should return to when finished with a subroutine. Chip-8 allows for up to 16 levels of nested subroutines.
+    // Points into the memory of the state block.
     uint8_t* stack_;
 
-    // 64x32-pixel monochrome display
-    // Represented as an array of bool arrays
-    bool display_[64][32];
-
-    // The current stack pointer
-    int16_t stackPointer_ = -2;
-
-    // Registers
-    // CHIP-8 has 16 8-bit data registers named V0 to VF
-    // Each register is 8 bits
-    uint8_t* vRegisters_;
-
-    // 16bit index register
-    uint16_t indexRegister_;
-
-    // Program counter, 16 bits
-    uint16_t programCounter_;
-
-    // Delay and sound timers are 8 bits each
-    // Delay timer is intended to be used for timing the events of games. Its value can be set and read
-    uint8_t delayTimer_;
-
-    // When the sound timer value is nonzero, a beeping sound is made.
-    uint8_t soundTimer_;
-
-    // Hard coded definition of CHIP-8 font set
-    uint8_t fontset_[80] = {
-        0xF0, 0x90, 0x90, 0x90, 0xF0, // 0
-        0x20, 0x60, 0x20, 0x20, 0x70, // 1
-        0xF0, 0x10, 0xF0, 0x80, 0xF0, // 2
-        0xF0, 0x10, 0xF0, 0x10, 0xF0, // 3
-        0x90, 0x90, 0xF0, 0x10, 0x10, // 4
-        0xF0, 0x80, 0xF0, 0x10, 0xF0, // 5
-        0xF0, 0x80, 0xF0, 0x90, 0xF0, // 6
-        0xF0, 0x10, 0x20, 0x40, 0x40, // 7
-        0xF0, 0x90, 0xF0, 0x90, 0xF0, // 8
-        0xF0, 0x90, 0xF0, 0x10, 0xF0, // 9
-        0xF0, 0x90, 0xF0, 0x90, 0x90, // A
-        0xE0, 0x90, 0xE0, 0x90, 0xE0, // B
-        0xF0, 0x80, 0x80, 0x80, 0xF0, // C
-        0xE0, 0x90, 0x90, 0x90, 0xE0, // D
-        0xF0, 0x80, 0xF0, 0x80, 0xF0, // E
-        0xF0, 0x80, 0xF0, 0x80, 0x80  // F
-    };
+    // Objects notified of every memory write, such as decoded instruction caches
+    vector<MemoryWriteListener*> memoryListeners_;
+
+    // Seed the random state is set to by reset, not part of the machine state
+    uint64_t randomSeed_ = DEFAULT_RANDOM_SEED;
+
+    // Display region modified since the last refresh, not part of the machine state
+    DisplayDamage displayDamage_;
+
+    // Receives the display before every clear when set, and the number of clears, not part of the machine state
+    uint64_t* clearLatch_ = NULL;
+    FrameBufferView clearLatchView_ = {NULL, 64, 32};
+    long clearCount_ = 0;
+
+    /**
+     * @brief Notifies all memory listeners that a memory address was modified
+     *
+     * @param address The modified memory address
+     */
+    void notifyMemoryWrite(uint16_t address);
+
+    /**
+     * @brief The state of a machine that was just powered on, with the font loaded and an empty stack
+     *
+     * @return const CHIP8_StateData& The initial state block
+     */
+    static const CHIP8_StateData& initialData();
+
+    /**
+     * @brief Reads memory past the first 4KB, which wraps around on a CHIP-8 machine
+     *
+     */
+    uint8_t highMemoryValue(uint16_t index);
+
+    /**
+     * @brief Writes memory past the first 4KB, which wraps around on a CHIP-8 machine
+     *
+     */
+    void setHighMemoryValue(uint16_t index, uint8_t value);
+
+    /**
+     * @brief Applies an operation to the framebuffer of every selected plane of the active display. The 64x64
+     * display has a single plane.
+     *
+     * @param operation Called with a LoresFrameBuffer, a HiresFrameBuffer or a VipHiresFrameBuffer
+     */
+    template <typename Operation>
+    void forEachPlane(Operation operation);
+
+    /**
+     * @brief Combines the planes of the active display into the composite framebuffer
+     *
+     */
+    void updateComposite();
+
+    /**
+     * @brief A view over the first plane of the active display
+     *
+     */
+    FrameBufferView firstPlaneView();
+
+    /**
+     * @brief Marks every pixel of the active display as modified
+     *
+     */
+    void damageDisplay();
+
+    /**
+     * @brief Replaces the state block with a snapshot, leaving the XO-CHIP memory and planes as they are
+     *
+     * @param snapshot The state block to restore
+     */
+    void restoreData(const CHIP8_StateData& snapshot);
 
 public:
 
@@ -209,6 +373,46 @@ public:
      */
     void  setSoundTimer(uint8_t value);
 
+    /**
+     * @brief Gives the state the 64KB memory and the second display plane of XO-CHIP, which plain CHIP-8 states
+     * do not allocate. Must be called before the state is handed to an emulator.
+     *
+     */
+    void enableXOChip();
+
+    /**
+     * @brief Whether the XO-CHIP memory and display plane are available
+     *
+     */
+    bool xoChip();
+
+    /**
+     * @brief The size of the address space, 4KB or 64KB with XO-CHIP
+     *
+     * @return int The number of addressable bytes
+     */
+    int memorySize();
+
+    /**
+     * @brief The display planes affected by drawing, clearing and scrolling
+     *
+     * @return uint8_t Bit 0 for the first plane, bit 1 for the second plane
+     */
+    uint8_t planes();
+
+    /**
+     * @brief Selects the display planes affected by drawing, clearing and scrolling, ignored without XO-CHIP
+     *
+     * @param planes Bit 0 for the first plane, bit 1 for the second plane
+     */
+    void setPlanes(uint8_t planes);
+
+    /**
+     * @brief Moves the program counter past the next instruction, the 4 byte F000 NNNN included
+     *
+     */
+    void skipInstruction();
+
     /**
      * @brief Gets the value stored in memory at the provided address
      *
@@ -226,20 +430,284 @@ public:
     void setMemoryValue(uint16_t index, uint8_t value);
 
     /**
-     * @brief Gets the value of a display byte at a specified memory location
+     * @brief Registers a listener notified each time a memory value is modified
+     *
+     * @param listener The listener to register
+     */
+    void addMemoryListener(MemoryWriteListener* listener);
+
+    /**
+     * @brief Unregisters a previously added memory listener
      *
-     * @param index The index of the display byte
-     * @return uint8_t The value stored in the display memory at the specified index
+     * @param listener The listener to remove
+     */
+    void removeMemoryListener(MemoryWriteListener* listener);
+
+    /**
+     * @brief Gets the value of a single pixel of the active display
+     *
+     * @param x The column of the pixel
+     * @param y The row of the pixel
+     * @return bool True if the pixel is set
      */
     bool displayValue(int x, int y);
 
     /**
-     * @brief Sets the byte in the display memory at the provided location
+     * @brief Sets a single pixel of the active display
      *
-     * @param index The index of the byte to set
-     * @param value The value to set in the display memory
+     * @param x The column of the pixel, 0 - 63, or 0 - 127 in SUPER-CHIP high resolution
+     * @param y The row of the pixel, 0 - 31, or 0 - 63 in either high resolution
+     * @param value True to set the pixel
      */
     void setDisplayValue(int x, int y, bool value);
+
+    /**
+     * @brief Gets a complete row of the 64x32 display
+     *
+     * @param y The row, 0 - 31
+     * @return uint64_t The pixels of the row, the most significant bit being the leftmost pixel
+     */
+    uint64_t displayRow(int y);
+
+    /**
+     * @brief Replaces a complete row of the 64x32 display
+     *
+     * @param y The row, 0 - 31
+     * @param pixels The pixels of the row, the most significant bit being the leftmost pixel
+     */
+    void setDisplayRow(int y, uint64_t pixels);
+
+    /**
+     * @brief Clears every pixel of the active display
+     *
+     */
+    void clearDisplay();
+
+    /**
+     * @brief Draws the sprite stored at the index register on the active display. With XO-CHIP each selected
+     * plane draws its own sprite, stored one after the other.
+     *
+     * @tparam WRAP Whether the pixels past the right and bottom edges wrap around instead of being dropped
+     * @param x The column of the leftmost pixel, wrapped around the display
+     * @param y The row of the top pixel, wrapped around the display
+     * @param height The number of rows of the sprite
+     * @param bytes_per_row 1 for 8 pixels wide sprites, 2 for 16 pixels wide sprites
+     * @return true A pixel that was set has been cleared
+     */
+    template <bool WRAP = false>
+    bool drawSprite(uint8_t x, uint8_t y, int height, int bytes_per_row);
+
+    /**
+     * @brief Moves the active display down, blank rows enter at the top
+     *
+     * @param count The number of rows
+     */
+    void scrollDisplayDown(int count);
+
+    /**
+     * @brief Moves the active display up, blank rows enter at the bottom
+     *
+     * @param count The number of rows
+     */
+    void scrollDisplayUp(int count);
+
+    /**
+     * @brief Moves the active display right, blank pixels enter on the left
+     *
+     * @param count The number of pixels
+     */
+    void scrollDisplayRight(int count);
+
+    /**
+     * @brief Moves the active display left, blank pixels enter on the right
+     *
+     * @param count The number of pixels
+     */
+    void scrollDisplayLeft(int count);
+
+    /**
+     * @brief A read only view over the active display, with every plane combined on XO-CHIP
+     *
+     * @return FrameBufferView The view, valid until the display resolution changes
+     */
+    FrameBufferView displayView();
+
+    /**
+     * @brief Whether the SUPER-CHIP 128x64 display is active
+     *
+     */
+    bool hires();
+
+    /**
+     * @brief Switches between the 64x32 and the 128x64 display
+     *
+     * @param enabled True for the 128x64 display
+     */
+    void setHires(bool enabled);
+
+    /**
+     * @brief The active display
+     *
+     */
+    DisplayMode displayMode();
+
+    /**
+     * @brief Switches to another display, the new display is redrawn entirely
+     *
+     * @param mode The display to show
+     */
+    void setDisplayMode(DisplayMode mode);
+
+    /**
+     * @brief Whether the program exited with 00FD
+     *
+     */
+    bool exited();
+
+    /**
+     * @brief Marks the program as exited
+     *
+     */
+    void setExited(bool exited);
+
+    /**
+     * @brief Gets a SUPER-CHIP flag register
+     *
+     * @param index The flag register, 0 - 15
+     */
+    uint8_t rplFlag(uint8_t index);
+
+    /**
+     * @brief Sets a SUPER-CHIP flag register
+     *
+     * @param index The flag register, 0 - 15
+     * @param value The new value
+     */
+    void setRplFlag(uint8_t index, uint8_t value);
+
+    /**
+     * @brief Restarts the random numbers of CXNN from a seed, kept by reset
+     *
+     * @param seed Equal seeds give equal sequences
+     */
+    void seedRandom(uint64_t seed);
+
+    /**
+     * @brief The seed of the random numbers, DEFAULT_RANDOM_SEED unless another one was set
+     *
+     */
+    uint64_t randomSeed();
+
+    /**
+     * @brief Draws the next random number of the state
+     *
+     * @return uint8_t A value from 0 to 255
+     */
+    uint8_t randomByte();
+
+    /**
+     * @brief Region of the display modified since the damage was last cleared
+     *
+     * @return const DisplayDamage& The modified rows and columns
+     */
+    const DisplayDamage& displayDamage();
+
+    /**
+     * @brief Forgets the modified region, called once the display was refreshed
+     *
+     */
+    void clearDisplayDamage();
+
+    /**
+     * @brief Sets words receiving a copy of the display every time it is cleared, the last complete frame of most games
+     *
+     * @param words MAX_FRAME_BUFFER_WORDS words written before each clear, laid out like displayView, NULL to stop
+     */
+    void setClearLatch(uint64_t* words);
+
+    /**
+     * @brief The display as it was before the last clear, with the resolution it had then
+     *
+     * @return FrameBufferView A view over the clear latch
+     */
+    FrameBufferView clearLatchView();
+
+    /**
+     * @brief The number of times the display was cleared
+     *
+     * @return long The clear count
+     */
+    long clearCount();
+
+    /**
+     * @brief Computes a 64 bit FNV-1a hash of the display, used to compare runs without storing every pixel
+     *
+     * @return uint64_t The hash of the display content
+     */
+    uint64_t displayHash();
+
+    /**
+     * @brief Allocates a block receiving a snapshot on the cache line it must start on, which new does not
+     * guarantee for over aligned types before C++17. Blocks declared on the stack are aligned as well.
+     *
+     * @return CHIP8_StateData* The zeroed block, released with freeSnapshot
+     * @throws bad_alloc The block could not be allocated
+     */
+    static CHIP8_StateData* allocateSnapshot();
+
+    /**
+     * @brief Allocates a block receiving the XO-CHIP memory and planes of a snapshot on its cache line
+     *
+     * @return XOChipStateData* The zeroed block, released with freeSnapshot
+     * @throws bad_alloc The block could not be allocated
+     */
+    static XOChipStateData* allocateXOChipSnapshot();
+
+    /**
+     * @brief Releases a block returned by allocateSnapshot, NULL being ignored
+     *
+     */
+    static void freeSnapshot(CHIP8_StateData* snapshot);
+
+    /**
+     * @brief Releases a block returned by allocateXOChipSnapshot, NULL being ignored
+     *
+     */
+    static void freeSnapshot(XOChipStateData* xo_snapshot);
+
+    /**
+     * @brief Copies the complete state into a snapshot
+     *
+     * The blocks must be 64 byte aligned, allocate them with allocateSnapshot and allocateXOChipSnapshot rather
+     * than new.
+     *
+     * @param snapshot The block receiving the state
+     * @param xo_snapshot (optional) The block receiving the XO-CHIP memory and planes, required with XO-CHIP
+     * @throws invalid_argument XO-CHIP is enabled and xo_snapshot is NULL
+     */
+    void snapshot(CHIP8_StateData* snapshot, XOChipStateData* xo_snapshot = NULL);
+
+    /**
+     * @brief Replaces the complete state with a snapshot. Memory listeners are notified of every modified address.
+     *
+     * @param snapshot The state to restore
+     * @param xo_snapshot (optional) The XO-CHIP memory and planes to restore, required with XO-CHIP
+     * @throws invalid_argument XO-CHIP is enabled and xo_snapshot is NULL
+     */
+    void restore(const CHIP8_StateData& snapshot, const XOChipStateData* xo_snapshot = NULL);
+
+    /**
+     * @brief Restores the state of a machine that was just powered on
+     *
+     */
+    void reset();
+
+    /**
+     * @brief Read only access to the state block
+     *
+     * @return const CHIP8_StateData* The state block
+     */
+    const CHIP8_StateData* data();
 };
 
 #endif
\ No newline at end of file
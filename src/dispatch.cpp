@@ -0,0 +1,467 @@
+/**
+ * @file dispatch.cpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Implementation of the lookup table used to map op codes to their handlers
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "chip-8_state.hpp"
+#include "dispatch.hpp"
+#include "exceptions.hpp"
+#include "instruction.hpp"
+#include "op_codes.hpp"
+#include "input/input_interface.hpp"
+
+using namespace std;
+
+const OpCodeTable OP_CODE_TABLE;
+
+// Adapters giving every op code function the common handler signature
+
+static int _executeUnused(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    // 0NNN - Calls machine code routine, ignored by the emulator
+    return DEFAULT_OP_CYCLES;
+}
+
+static int _executeNotImplemented(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    stringstream error_string;
+    error_string << "Op Code " << instruction.op_code << " has not yet been implemented." << endl;
+    throw OperationNotImplementedException(error_string.str());
+}
+
+static int _execute00E0(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return Execute00E0(state);
+}
+
+static int _execute00EE(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return Execute00EE(state);
+}
+
+static int _execute1NNN(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return Execute1NNN(state, instruction);
+}
+
+static int _execute2NNN(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return Execute2NNN(state, instruction);
+}
+
+static int _execute3XNN(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return Execute3XNN(state, instruction);
+}
+
+static int _execute4XNN(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return Execute4XNN(state, instruction);
+}
+
+static int _execute5XY0(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return Execute5XY0(state, instruction);
+}
+
+static int _execute6XNN(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return Execute6XNN(state, instruction);
+}
+
+static int _execute7XNN(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return Execute7XNN(state, instruction);
+}
+
+static int _execute8XY0(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return Execute8XY0(state, instruction);
+}
+
+template <typename Quirks>
+static int _execute8XY1(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return Execute8XY1<Quirks>(state, instruction);
+}
+
+template <typename Quirks>
+static int _execute8XY2(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return Execute8XY2<Quirks>(state, instruction);
+}
+
+template <typename Quirks>
+static int _execute8XY3(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return Execute8XY3<Quirks>(state, instruction);
+}
+
+static int _execute8XY4(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return Execute8XY4(state, instruction);
+}
+
+static int _execute8XY5(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return Execute8XY5(state, instruction);
+}
+
+template <typename Quirks>
+static int _execute8XY6(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return Execute8XY6<Quirks>(state, instruction);
+}
+
+static int _execute8XY7(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return Execute8XY7(state, instruction);
+}
+
+template <typename Quirks>
+static int _execute8XYE(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return Execute8XYE<Quirks>(state, instruction);
+}
+
+static int _execute9XY0(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return Execute9XY0(state, instruction);
+}
+
+static int _executeANNN(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return ExecuteANNN(state, instruction);
+}
+
+template <typename Quirks>
+static int _executeBNNN(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return ExecuteBNNN<Quirks>(state, instruction);
+}
+
+static int _executeCNNN(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return ExecuteCNNN(state, instruction);
+}
+
+template <typename Quirks>
+static int _executeDXYN(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return ExecuteDXYN<Quirks>(state, instruction);
+}
+
+static int _executeEX9E(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return ExecuteEX9E(state, instruction, input);
+}
+
+static int _executeEXA1(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return ExecuteEXA1(state, instruction, input);
+}
+
+static int _executeFX07(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return ExecuteFX07(state, instruction);
+}
+
+static int _executeFX0A(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return ExecuteFX0A(state, instruction, input);
+}
+
+static int _executeFX15(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return ExecuteFX15(state, instruction);
+}
+
+static int _executeFX18(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return ExecuteFX18(state, instruction);
+}
+
+static int _executeFX1E(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return ExecuteFX1E(state, instruction);
+}
+
+static int _executeFX29(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return ExecuteFX29(state, instruction);
+}
+
+static int _executeFX33(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return ExecuteFX33(state, instruction);
+}
+
+template <typename Quirks>
+static int _executeFX55(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return ExecuteFX55<Quirks>(state, instruction);
+}
+
+template <typename Quirks>
+static int _executeFX65(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return ExecuteFX65<Quirks>(state, instruction);
+}
+
+// The SUPER-CHIP op codes are machine code calls, ignored, or unknown op codes on the other profiles
+
+template <typename Quirks>
+static int _execute00CN(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    if (!Quirks::SUPER_CHIP_INSTRUCTIONS) {
+        return _executeUnused(state, input, instruction);
+    }
+    return Execute00CN(state, instruction);
+}
+
+template <typename Quirks>
+static int _execute00FB(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    if (!Quirks::SUPER_CHIP_INSTRUCTIONS) {
+        return _executeUnused(state, input, instruction);
+    }
+    return Execute00FB(state);
+}
+
+template <typename Quirks>
+static int _execute00FC(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    if (!Quirks::SUPER_CHIP_INSTRUCTIONS) {
+        return _executeUnused(state, input, instruction);
+    }
+    return Execute00FC(state);
+}
+
+template <typename Quirks>
+static int _execute00FD(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    if (!Quirks::SUPER_CHIP_INSTRUCTIONS) {
+        return _executeUnused(state, input, instruction);
+    }
+    return Execute00FD(state);
+}
+
+template <typename Quirks>
+static int _execute00FE(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    if (!Quirks::SUPER_CHIP_INSTRUCTIONS) {
+        return _executeUnused(state, input, instruction);
+    }
+    return Execute00FE(state);
+}
+
+template <typename Quirks>
+static int _execute00FF(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    if (!Quirks::SUPER_CHIP_INSTRUCTIONS) {
+        return _executeUnused(state, input, instruction);
+    }
+    return Execute00FF(state);
+}
+
+template <typename Quirks>
+static int _executeFX30(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    if (!Quirks::SUPER_CHIP_INSTRUCTIONS) {
+        return _executeNotImplemented(state, input, instruction);
+    }
+    return ExecuteFX30(state, instruction);
+}
+
+template <typename Quirks>
+static int _executeFX75(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    if (!Quirks::SUPER_CHIP_INSTRUCTIONS) {
+        return _executeNotImplemented(state, input, instruction);
+    }
+    return ExecuteFX75(state, instruction);
+}
+
+template <typename Quirks>
+static int _executeFX85(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    if (!Quirks::SUPER_CHIP_INSTRUCTIONS) {
+        return _executeNotImplemented(state, input, instruction);
+    }
+    return ExecuteFX85(state, instruction);
+}
+
+// The XO-CHIP op codes reusing CHIP-8 encodings keep their CHIP-8 meaning on plain states
+
+static int _execute00DN(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    if (!state->xoChip()) {
+        return _executeUnused(state, input, instruction);
+    }
+    return Execute00DN(state, instruction);
+}
+
+static int _execute5XY2(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    if (!state->xoChip()) {
+        return Execute5XY0(state, instruction);
+    }
+    return Execute5XY2(state, instruction);
+}
+
+static int _execute5XY3(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    if (!state->xoChip()) {
+        return Execute5XY0(state, instruction);
+    }
+    return Execute5XY3(state, instruction);
+}
+
+static int _executeF000(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    if (!state->xoChip()) {
+        return _executeNotImplemented(state, input, instruction);
+    }
+    return ExecuteF000(state);
+}
+
+static int _executeFN01(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    if (!state->xoChip()) {
+        return _executeNotImplemented(state, input, instruction);
+    }
+    return ExecuteFN01(state, instruction);
+}
+
+static int _execute0230(CHIP8_State* state, InputInterface* input, const Instruction& instruction) {
+    return Execute0230(state);
+}
+
+/**
+ * @brief The handlers of every op code for a quirk policy
+ *
+ */
+template <typename Quirks>
+struct QuirkHandlers {
+    static const OpCodeEntry entries[OP_CODE_ID_COUNT];
+};
+
+// Must be listed in the same order as OpCodeId
+template <typename Quirks>
+const OpCodeEntry QuirkHandlers<Quirks>::entries[OP_CODE_ID_COUNT] = {
+    {OP_UNUSED, _executeUnused, false},
+    {OP_NOT_IMPLEMENTED, _executeNotImplemented, false},
+    {OP_00E0, _execute00E0, true},
+    {OP_00EE, _execute00EE, false},
+    {OP_1NNN, _execute1NNN, false},
+    {OP_2NNN, _execute2NNN, false},
+    {OP_3XNN, _execute3XNN, false},
+    {OP_4XNN, _execute4XNN, false},
+    {OP_5XY0, _execute5XY0, false},
+    {OP_6XNN, _execute6XNN, false},
+    {OP_7XNN, _execute7XNN, false},
+    {OP_8XY0, _execute8XY0, false},
+    {OP_8XY1, _execute8XY1<Quirks>, false},
+    {OP_8XY2, _execute8XY2<Quirks>, false},
+    {OP_8XY3, _execute8XY3<Quirks>, false},
+    {OP_8XY4, _execute8XY4, false},
+    {OP_8XY5, _execute8XY5, false},
+    {OP_8XY6, _execute8XY6<Quirks>, false},
+    {OP_8XY7, _execute8XY7, false},
+    {OP_8XYE, _execute8XYE<Quirks>, false},
+    {OP_9XY0, _execute9XY0, false},
+    {OP_ANNN, _executeANNN, false},
+    {OP_BNNN, _executeBNNN<Quirks>, false},
+    {OP_CNNN, _executeCNNN, false},
+    {OP_DXYN, _executeDXYN<Quirks>, true},
+    {OP_EX9E, _executeEX9E, false},
+    {OP_EXA1, _executeEXA1, false},
+    {OP_FX07, _executeFX07, false},
+    {OP_FX0A, _executeFX0A, false},
+    {OP_FX15, _executeFX15, false},
+    {OP_FX18, _executeFX18, false},
+    {OP_FX1E, _executeFX1E, false},
+    {OP_FX29, _executeFX29, false},
+    {OP_FX33, _executeFX33, false},
+    {OP_FX55, _executeFX55<Quirks>, false},
+    {OP_FX65, _executeFX65<Quirks>, false},
+    {OP_00CN, _execute00CN<Quirks>, true},
+    {OP_00FB, _execute00FB<Quirks>, true},
+    {OP_00FC, _execute00FC<Quirks>, true},
+    {OP_00FD, _execute00FD<Quirks>, false},
+    {OP_00FE, _execute00FE<Quirks>, true},
+    {OP_00FF, _execute00FF<Quirks>, true},
+    {OP_FX30, _executeFX30<Quirks>, false},
+    {OP_FX75, _executeFX75<Quirks>, false},
+    {OP_FX85, _executeFX85<Quirks>, false},
+    {OP_00DN, _execute00DN, true},
+    {OP_5XY2, _execute5XY2, false},
+    {OP_5XY3, _execute5XY3, false},
+    {OP_F000, _executeF000, false},
+    {OP_FN01, _executeFN01, false},
+    {OP_0230, _execute0230, true}
+};
+
+// Must be listed in the same order as QuirkProfile
+const OpCodeEntry* const OpCodeTable::handlers_[QUIRK_PROFILE_COUNT] = {
+    QuirkHandlers<VipQuirks>::entries,
+    QuirkHandlers<Chip48Quirks>::entries,
+    QuirkHandlers<SuperChipQuirks>::entries,
+    QuirkHandlers<ModernQuirks>::entries,
+    QuirkHandlers<XOChipQuirks>::entries
+};
+
+OpCodeTable::OpCodeTable() {
+    for (uint32_t op_code = 0; op_code <= 0xFFFF; op_code++) {
+        this->index_[op_code] = OpCodeTable::decode((uint16_t)op_code);
+    }
+}
+
+uint8_t OpCodeTable::decode(uint16_t op_code) {
+    uint8_t nyble_1 = (uint8_t)((op_code & 0xF000) >> 12);
+    uint8_t nyble_4 = (uint8_t)(op_code & 0x000F);
+    uint8_t low_byte = (uint8_t)(op_code & 0x00FF);
+
+    switch(nyble_1) {
+        case 0x00: {
+            switch (op_code) {
+                case 0x00E0: return OP_00E0;
+                case 0x00EE: return OP_00EE;
+                case 0x00FB: return OP_00FB;
+                case 0x00FC: return OP_00FC;
+                case 0x00FD: return OP_00FD;
+                case 0x00FE: return OP_00FE;
+                case 0x00FF: return OP_00FF;
+                case 0x0230: return OP_0230;
+            }
+            if ((op_code & 0xFFF0) == 0x00C0) {
+                return OP_00CN;
+            }
+            if ((op_code & 0xFFF0) == 0x00D0) {
+                return OP_00DN;
+            }
+            return OP_UNUSED;
+        }
+        case 0x01: return OP_1NNN;
+        case 0x02: return OP_2NNN;
+        case 0x03: return OP_3XNN;
+        case 0x04: return OP_4XNN;
+        case 0x05: {
+            switch (nyble_4) {
+                case 0x02: return OP_5XY2;
+                case 0x03: return OP_5XY3;
+            }
+            return OP_5XY0;
+        }
+        case 0x06: return OP_6XNN;
+        case 0x07: return OP_7XNN;
+        case 0x08: {
+            switch (nyble_4) {
+                case 0x00: return OP_8XY0;
+                case 0x01: return OP_8XY1;
+                case 0x02: return OP_8XY2;
+                case 0x03: return OP_8XY3;
+                case 0x04: return OP_8XY4;
+                case 0x05: return OP_8XY5;
+                case 0x06: return OP_8XY6;
+                case 0x07: return OP_8XY7;
+                case 0x0E: return OP_8XYE;
+            }
+            // The original switch fell through into the 9XY0 case for the remaining 8XYN codes.
+            // Kept so that ROMs relying on it behave exactly as before.
+            return OP_9XY0;
+        }
+        case 0x09: return OP_9XY0;
+        case 0x0A: return OP_ANNN;
+        case 0x0B: return OP_BNNN;
+        case 0x0C: return OP_CNNN;
+        case 0x0D: return OP_DXYN;
+        case 0x0E: {
+            if (low_byte == 0x9E) {
+                return OP_EX9E;
+            } else if (low_byte == 0xA1) {
+                return OP_EXA1;
+            }
+            return OP_NOT_IMPLEMENTED;
+        }
+        case 0x0F: {
+            if (op_code == 0xF000) {
+                return OP_F000;
+            }
+            switch (low_byte) {
+                case 0x07: return OP_FX07;
+                case 0x0A: return OP_FX0A;
+                case 0x15: return OP_FX15;
+                case 0x18: return OP_FX18;
+                case 0x1E: return OP_FX1E;
+                case 0x29: return OP_FX29;
+                case 0x33: return OP_FX33;
+                case 0x55: return OP_FX55;
+                case 0x65: return OP_FX65;
+                case 0x30: return OP_FX30;
+                case 0x75: return OP_FX75;
+                case 0x85: return OP_FX85;
+                case 0x01: return OP_FN01;
+            }
+            return OP_NOT_IMPLEMENTED;
+        }
+    }
+
+    return OP_NOT_IMPLEMENTED;
+}
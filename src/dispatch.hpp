@@ -0,0 +1,115 @@
+/**
+ * @file dispatch.hpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Definition of the lookup table used to map op codes to their handlers
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef DISPATCH_HPP
+#define DISPATCH_HPP
+
+#include <iostream>
+#include "chip-8_state.hpp"
+#include "instruction.hpp"
+#include "quirks.hpp"
+#include "input/input_interface.hpp"
+
+/**
+ * @brief Common signature shared by every entry in the op code table
+ *
+ * @param state Current chip state
+ * @param input The input interface used to retrieve info on what keys are pressed
+ * @param instruction The decoded op code to execute
+ *
+ * @return The number of cycles needed to perform the operation
+ */
+typedef int (*OpCodeHandler)(CHIP8_State* state, InputInterface* input, const Instruction& instruction);
+
+/**
+ * @brief Identifies the operation performed by each handler in the op code table
+ *
+ */
+enum OpCodeId : uint8_t {
+    OP_UNUSED, OP_NOT_IMPLEMENTED,
+    OP_00E0, OP_00EE, OP_1NNN, OP_2NNN, OP_3XNN, OP_4XNN, OP_5XY0, OP_6XNN, OP_7XNN,
+    OP_8XY0, OP_8XY1, OP_8XY2, OP_8XY3, OP_8XY4, OP_8XY5, OP_8XY6, OP_8XY7, OP_8XYE,
+    OP_9XY0, OP_ANNN, OP_BNNN, OP_CNNN, OP_DXYN, OP_EX9E, OP_EXA1,
+    OP_FX07, OP_FX0A, OP_FX15, OP_FX18, OP_FX1E, OP_FX29, OP_FX33, OP_FX55, OP_FX65,
+    // SUPER-CHIP extensions
+    OP_00CN, OP_00FB, OP_00FC, OP_00FD, OP_00FE, OP_00FF, OP_FX30, OP_FX75, OP_FX85,
+    // XO-CHIP extensions
+    OP_00DN, OP_5XY2, OP_5XY3, OP_F000, OP_FN01,
+    // COSMAC VIP two page hires
+    OP_0230,
+    OP_CODE_ID_COUNT
+};
+
+/**
+ * @brief A single handler in the op code table
+ *
+ */
+struct OpCodeEntry {
+    // The operation performed by the handler
+    OpCodeId id;
+
+    // Function executing the op code against the chip state
+    OpCodeHandler execute;
+
+    // True if the op code modifies the display and a refresh is needed
+    bool refreshes_display;
+};
+
+/**
+ * @brief Dense table mapping all 65536 possible op codes to their handler
+ *
+ * Every op code is resolved once when the table is built, so dispatching an instruction is two loads
+ * and an indirect call instead of a walk through nested switch statements. Each quirk profile has its own list of
+ * handlers, instantiated for its quirk policy, so the handlers never test a quirk at run time.
+ */
+class OpCodeTable
+{
+
+public:
+
+    /**
+     * @brief Construct a new Op Code Table, decoding every possible op code
+     *
+     */
+    OpCodeTable();
+
+    /**
+     * @brief Gets the handler for an op code
+     *
+     * @param op_code A 2 byte instruction
+     * @param profile (optional) The quirks the handler reproduces
+     * @return const OpCodeEntry& The handler used to execute the op code
+     */
+    inline const OpCodeEntry& lookup(uint16_t op_code, QuirkProfile profile = QuirkProfile::Modern) const {
+        return this->handlers_[(int)profile][this->index_[op_code]];
+    }
+
+private:
+
+    /**
+     * @brief Decodes a single op code and returns the index of its handler
+     *
+     * @param op_code A 2 byte instruction
+     * @return uint8_t The index of the handler used for the op code
+     */
+    static uint8_t decode(uint16_t op_code);
+
+    // Index into the handler list for every possible op code
+    uint8_t index_[0x10000];
+
+    // Every distinct handler referenced by the index, for each quirk profile
+    static const OpCodeEntry* const handlers_[QUIRK_PROFILE_COUNT];
+};
+
+/**
+ * @brief The op code table shared by all emulator instances. Built once at startup.
+ *
+ */
+extern const OpCodeTable OP_CODE_TABLE;
+
+#endif
@@ -0,0 +1,266 @@
+/**
+ * @file ansi_display.cpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Implementation of a display writing ANSI escape sequences straight to a file descriptor
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <unistd.h>
+#include "ansi_display.hpp"
+#include "../chip-8_state.hpp"
+
+using namespace std;
+
+// Escape sequences used to set up and restore the terminal
+static const char CLEAR_SCREEN[] = "\x1b[?25l\x1b[2J";
+static const char SHOW_CURSOR[] = "\x1b[?25h";
+
+// A full block cell is one pixel, two terminal columns wide
+static const AnsiGlyph FULL_BLOCK_GLYPHS[2] = {
+    {"  ", 2},
+    {"██", 6}
+};
+
+// On the high resolution display a full block cell is a single terminal column wide
+static const AnsiGlyph NARROW_FULL_BLOCK_GLYPHS[2] = {
+    {" ", 1},
+    {"█", 3}
+};
+
+// A half block cell is indexed by its top pixel in bit 0 and its bottom pixel in bit 1
+static const AnsiGlyph HALF_BLOCK_GLYPHS[4] = {
+    {" ", 1},
+    {"▀", 3},
+    {"▄", 3},
+    {"█", 3}
+};
+
+// Braille dots set by the left and right pixels of each of the four rows of a cell
+static const uint8_t BRAILLE_DOTS[4][2] = {
+    {0x01, 0x08},
+    {0x02, 0x10},
+    {0x04, 0x20},
+    {0x40, 0x80}
+};
+
+/**
+ * @brief Lookup tables used to draw braille cells
+ *
+ */
+struct BrailleTables {
+    // UTF-8 encoding of the 256 braille patterns, U+2800 to U+28FF
+    AnsiGlyph glyphs[256];
+
+    // Dots set in each row of a cell by its two pixels, the left pixel being bit 1
+    uint8_t row_dots[4][4];
+};
+
+/**
+ * @brief Builds the braille lookup tables
+ *
+ */
+static BrailleTables MakeBrailleTables() {
+    BrailleTables tables;
+    for (int dots = 0; dots < 256; dots++) {
+        tables.glyphs[dots].bytes[0] = (char)0xE2;
+        tables.glyphs[dots].bytes[1] = (char)(0xA0 | (dots >> 6));
+        tables.glyphs[dots].bytes[2] = (char)(0x80 | (dots & 0x3F));
+        tables.glyphs[dots].bytes[3] = 0;
+        tables.glyphs[dots].length = 3;
+    }
+    for (int row = 0; row < 4; row++) {
+        for (int pixels = 0; pixels < 4; pixels++) {
+            tables.row_dots[row][pixels] = ((pixels & 2) ? BRAILLE_DOTS[row][0] : 0) | ((pixels & 1) ? BRAILLE_DOTS[row][1] : 0);
+        }
+    }
+    return tables;
+}
+
+/**
+ * @brief The braille lookup tables, built once on first use whatever the thread
+ *
+ */
+static const BrailleTables& Braille() {
+    static const BrailleTables tables = MakeBrailleTables();
+    return tables;
+}
+
+AnsiDisplay::AnsiDisplay(int fd, AnsiGlyphs glyphs) {
+    this->fd_ = fd;
+    this->glyph_mode_ = glyphs;
+    switch (glyphs) {
+        case AnsiGlyphs::FullBlock:
+            this->glyphs_ = FULL_BLOCK_GLYPHS;
+            this->cell_width_ = 1;
+            this->cell_height_ = 1;
+            this->cell_columns_ = 2;
+            break;
+        case AnsiGlyphs::HalfBlock:
+            this->glyphs_ = HALF_BLOCK_GLYPHS;
+            this->cell_width_ = 1;
+            this->cell_height_ = 2;
+            this->cell_columns_ = 1;
+            break;
+        case AnsiGlyphs::Braille:
+            this->glyphs_ = Braille().glyphs;
+            this->cell_width_ = 2;
+            this->cell_height_ = 4;
+            this->cell_columns_ = 1;
+            break;
+    }
+    this->buffer_ = new char[ANSI_BUFFER_SIZE];
+    memset(this->shadow_, 0, sizeof(this->shadow_));
+}
+
+AnsiDisplay::~AnsiDisplay() {
+    if (this->initialized_) {
+        this->appendCursorMove(this->height_ / this->cell_height_ + 1, 1);
+        this->append(SHOW_CURSOR, sizeof(SHOW_CURSOR) - 1);
+        this->flush();
+    }
+    delete[] this->buffer_;
+}
+
+void AnsiDisplay::updateDisplay(const FrameBufferView& frame, const DisplayDamage& damage) {
+    if (!this->initialized_) {
+        // A cleared screen matches the blank shadow copy
+        this->append(CLEAR_SCREEN, sizeof(CLEAR_SCREEN) - 1);
+        this->initialized_ = true;
+    }
+    if (frame.width != this->width_ || frame.height != this->height_) {
+        this->resize(frame.width, frame.height);
+    }
+    int words_per_row = frame.wordsPerRow();
+
+    // Position the cursor would be at after the last glyph, moves to it are skipped
+    int cursor_row = -1;
+    int cursor_x = -1;
+
+    for (int cell_y = 0; cell_y < frame.height / this->cell_height_; cell_y++) {
+        const uint64_t* rows = frame.row(cell_y * this->cell_height_);
+        uint64_t* shadow = &this->shadow_[cell_y * this->cell_height_ * words_per_row];
+        int cell_words = this->cell_height_ * words_per_row;
+
+        // Cells are only compared when a pixel row they cover changed
+        uint64_t changed = 0;
+        for (int word = 0; word < cell_words; word++) {
+            changed |= rows[word] ^ shadow[word];
+        }
+        if (changed == 0) {
+            continue;
+        }
+
+        for (int cell_x = 0; cell_x < frame.width / this->cell_width_; cell_x++) {
+            uint8_t value = this->cellValue(rows, words_per_row, cell_x);
+            if (value == this->cellValue(shadow, words_per_row, cell_x)) {
+                continue;
+            }
+            if (cursor_row != cell_y || cursor_x != cell_x) {
+                this->appendCursorMove(cell_y + 1, cell_x * this->cell_columns_ + 1);
+            }
+            this->append(this->glyphs_[value].bytes, this->glyphs_[value].length);
+            cursor_row = cell_y;
+            cursor_x = cell_x + 1;
+        }
+
+        for (int word = 0; word < cell_words; word++) {
+            shadow[word] = rows[word];
+        }
+    }
+
+    this->flush();
+}
+
+long AnsiDisplay::bytesWritten() {
+    return this->bytes_written_;
+}
+
+long AnsiDisplay::writeCount() {
+    return this->write_count_;
+}
+
+uint8_t AnsiDisplay::cellValue(const uint64_t* rows, int words_per_row, int cell_x) {
+    int x = cell_x * this->cell_width_;
+    const uint64_t* words = &rows[x / 64];
+    switch (this->glyph_mode_) {
+        case AnsiGlyphs::HalfBlock: {
+            int shift = 63 - x % 64;
+            return ((words[0] >> shift) & 1) | (((words[words_per_row] >> shift) & 1) << 1);
+        }
+        case AnsiGlyphs::Braille: {
+            const uint8_t (*row_dots)[4] = Braille().row_dots;
+            int shift = 62 - x % 64;
+            return row_dots[0][(words[0] >> shift) & 3] | row_dots[1][(words[words_per_row] >> shift) & 3]
+                | row_dots[2][(words[2 * words_per_row] >> shift) & 3] | row_dots[3][(words[3 * words_per_row] >> shift) & 3];
+        }
+        default:
+            return (words[0] >> (63 - x % 64)) & 1;
+    }
+}
+
+void AnsiDisplay::invalidate() {
+    // An unknown size clears the screen and the shadow copy before the next frame
+    this->width_ = 0;
+    this->height_ = 0;
+}
+
+void AnsiDisplay::resize(int width, int height) {
+    this->append(CLEAR_SCREEN, sizeof(CLEAR_SCREEN) - 1);
+    memset(this->shadow_, 0, sizeof(this->shadow_));
+    this->width_ = width;
+    this->height_ = height;
+
+    // Two columns per pixel would not fit the high resolution display on most terminals
+    if (this->glyph_mode_ == AnsiGlyphs::FullBlock) {
+        bool narrow = width > DISPLAY_WIDTH;
+        this->glyphs_ = narrow ? NARROW_FULL_BLOCK_GLYPHS : FULL_BLOCK_GLYPHS;
+        this->cell_columns_ = narrow ? 1 : 2;
+    }
+}
+
+void AnsiDisplay::appendCursorMove(int row, int column) {
+    char* out = this->buffer_ + this->length_;
+    *out++ = '\x1b';
+    *out++ = '[';
+    if (row >= 10) {
+        *out++ = '0' + row / 10;
+    }
+    *out++ = '0' + row % 10;
+    *out++ = ';';
+    if (column >= 100) {
+        *out++ = '0' + column / 100;
+    }
+    if (column >= 10) {
+        *out++ = '0' + (column / 10) % 10;
+    }
+    *out++ = '0' + column % 10;
+    *out++ = 'H';
+    this->length_ = out - this->buffer_;
+}
+
+void AnsiDisplay::append(const char* text, int length) {
+    memcpy(this->buffer_ + this->length_, text, length);
+    this->length_ += length;
+}
+
+void AnsiDisplay::flush() {
+    int offset = 0;
+    while (offset < this->length_) {
+        ssize_t written = write(this->fd_, this->buffer_ + offset, this->length_ - offset);
+        this->write_count_++;
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // The terminal went away, the frame is lost
+            break;
+        }
+        offset += written;
+        this->bytes_written_ += written;
+    }
+    this->length_ = 0;
+}
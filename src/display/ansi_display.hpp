@@ -0,0 +1,158 @@
+/**
+ * @file ansi_display.hpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Definition of a display writing ANSI escape sequences straight to a file descriptor
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef ANSI_DISPLAY_H
+#define ANSI_DISPLAY_H
+
+#include <iostream>
+#include <unistd.h>
+#include "display_interface.hpp"
+#include "../chip-8_state.hpp"
+
+using namespace std;
+
+// Largest output of one update: a cursor move and a glyph for every pixel of the largest display, plus the screen setup
+const static int ANSI_BUFFER_SIZE = HIRES_DISPLAY_WIDTH * HIRES_DISPLAY_HEIGHT * 16 + 64;
+
+/**
+ * @brief How pixels are grouped into terminal cells
+ *
+ */
+enum class AnsiGlyphs {
+    // One pixel per cell, drawn as two full blocks, or a single one on the high resolution display
+    FullBlock,
+    // Two vertically stacked pixels per cell, drawn with upper and lower half blocks
+    HalfBlock,
+    // Two by four pixels per cell, drawn with braille patterns
+    Braille
+};
+
+/**
+ * @brief UTF-8 encoding of a terminal cell
+ *
+ */
+struct AnsiGlyph {
+    char bytes[7];
+    uint8_t length;
+};
+
+/**
+ * @brief A display that bypasses ncurses and writes ANSI escape sequences to a file descriptor
+ *
+ * The last frame written is kept as a shadow copy. Each update only emits the cells that differ from it,
+ * moving the cursor only when it is not already on the next cell, and flushes everything with a single write.
+ * Cells can pack several pixels using half blocks or braille patterns, looked up from precomputed tables.
+ */
+class AnsiDisplay : public DisplayInterface
+{
+public:
+    /**
+     * @brief Construct a new Ansi Display object
+     *
+     * @param fd The file descriptor receiving the output, usually a terminal
+     * @param glyphs How pixels are grouped into terminal cells
+     */
+    AnsiDisplay(int fd = STDOUT_FILENO, AnsiGlyphs glyphs = AnsiGlyphs::FullBlock);
+
+    /**
+     * @brief Destroy the Ansi Display object, the cursor is shown again below the display
+     *
+     */
+    ~AnsiDisplay();
+
+    using DisplayInterface::updateDisplay;
+
+    /**
+     * @brief Writes the cells that differ from the last frame written
+     *
+     * @param frame The complete display content
+     * @param damage The rows and columns modified since the last update, the shadow copy is used instead
+     */
+    virtual void updateDisplay(const FrameBufferView& frame, const DisplayDamage& damage);
+
+    /**
+     * @brief Clears the screen on the next update, which then writes every cell
+     *
+     */
+    virtual void invalidate();
+
+    /**
+     * @brief The number of bytes written to the file descriptor
+     *
+     * @return long The byte count
+     */
+    long bytesWritten();
+
+    /**
+     * @brief The number of write calls made on the file descriptor
+     *
+     * @return long The write count
+     */
+    long writeCount();
+
+private:
+
+    /**
+     * @brief Index in the glyph table of a cell
+     *
+     * @param rows The first word of the top pixel row covered by the cell
+     * @param words_per_row The number of words between two pixel rows
+     * @param cell_x The column of the cell
+     */
+    uint8_t cellValue(const uint64_t* rows, int words_per_row, int cell_x);
+
+    /**
+     * @brief Clears the screen and the shadow copy, and sets the cell layout up for a display size
+     *
+     */
+    void resize(int width, int height);
+
+    /**
+     * @brief Appends a cursor move to a one based terminal position to the output buffer
+     *
+     */
+    void appendCursorMove(int row, int column);
+
+    /**
+     * @brief Appends a string to the output buffer
+     *
+     */
+    void append(const char* text, int length);
+
+    /**
+     * @brief Writes the output buffer to the file descriptor and empties it
+     *
+     */
+    void flush();
+
+    int fd_;
+
+    // Glyph table indexed by cell value, and the pixels and terminal columns covered by a cell
+    const AnsiGlyph* glyphs_;
+    AnsiGlyphs glyph_mode_;
+    int cell_width_;
+    int cell_height_;
+    int cell_columns_;
+
+    // The display content currently shown on the terminal, and its size in pixels
+    uint64_t shadow_[MAX_FRAME_BUFFER_WORDS];
+    int width_ = DISPLAY_WIDTH;
+    int height_ = DISPLAY_HEIGHT;
+
+    // The screen is cleared and the cursor hidden before the first frame
+    bool initialized_ = false;
+
+    // Output of the update in progress, allocated once
+    char* buffer_;
+    int length_ = 0;
+
+    long bytes_written_ = 0;
+    long write_count_ = 0;
+};
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include "../chip-8_state.hpp"
+#include "../packed_frame_buffer.hpp"
 
 const static int DISPLAY_WIDTH = 64;
 const static int DISPLAY_HEIGHT = 32;
@@ -24,10 +25,32 @@ public:
     /**
      * @brief Updates the emulator display using the provided display state
      *
-     * @param display_state A byte array containing the current display data
+     * Passes the active display of the state and the region modified since the last refresh to the framebuffer
+     * overload.
+     *
+     * @param state The current chip state
+     */
+    virtual void updateDisplay(CHIP8_State* state) {
+        this->updateDisplay(state->displayView(), state->displayDamage());
+    }
+
+    /**
+     * @brief Updates the emulator display, only the damaged region needs to be redrawn
+     *
+     * The whole display must be redrawn when the size of the frame changes.
+     *
+     * @param frame The complete display content
+     * @param damage The rows and columns modified since the last update
+     */
+    virtual void updateDisplay(const FrameBufferView& frame, const DisplayDamage& damage) = 0;
+
+    /**
+     * @brief Forgets what the screen shows, the next update redraws everything. Called once the terminal was
+     * resized.
+     *
      */
-    virtual void updateDisplay(CHIP8_State* state) = 0;
+    virtual void invalidate() {}
 
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -5,12 +5,12 @@ using namespace std;
 
 MockDisplay::MockDisplay() { }
 
-void MockDisplay::updateDisplay(CHIP8_State* state) {
+void MockDisplay::updateDisplay(const FrameBufferView& frame, const DisplayDamage& damage) {
     // clear the emulator window
     // for each byte in the display
-    for (int j = 0; j < DISPLAY_HEIGHT; j++) {
-        for (int i = 0; i < DISPLAY_WIDTH; i++) {
-            bool is_pixel_active = state->displayValue(i, j);
+    for (int j = 0; j < frame.height; j++) {
+        for (int i = 0; i < frame.width; i++) {
+            bool is_pixel_active = frame.pixel(i, j);
             if (is_pixel_active) {
                 cout << "#";
             } else {
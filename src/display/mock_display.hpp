@@ -24,12 +24,15 @@ public:
      */
     ~MockDisplay() = default;
 
+    using DisplayInterface::updateDisplay;
+
     /**
-     * @brief Updates the emulator display using the provided display state
+     * @brief Prints the complete display to the standard output
      *
-     * @param display_state A byte array containing the current display data
+     * @param frame The complete display content
+     * @param damage The rows and columns modified since the last update
      */
-    virtual void updateDisplay(CHIP8_State* state);
+    virtual void updateDisplay(const FrameBufferView& frame, const DisplayDamage& damage);
 };
 
 #endif
\ No newline at end of file
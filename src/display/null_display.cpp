@@ -0,0 +1,12 @@
+#include "null_display.hpp"
+#include "../chip-8_state.hpp"
+
+using namespace std;
+
+void NullDisplay::updateDisplay(const FrameBufferView& frame, const DisplayDamage& damage) {
+    this->update_count_++;
+}
+
+long NullDisplay::updateCount() {
+    return this->update_count_;
+}
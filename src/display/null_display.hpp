@@ -0,0 +1,48 @@
+#ifndef NULL_DISPLAY_H
+#define NULL_DISPLAY_H
+
+#include "display_interface.hpp"
+#include "../chip-8_state.hpp"
+
+/**
+ * @brief A display that discards every update. Used when running the emulator headless.
+ *
+ */
+class NullDisplay : public DisplayInterface
+{
+public:
+    /**
+     * @brief Construct a new Null Display object
+     *
+     */
+    NullDisplay() = default;
+
+    /**
+     * @brief Destroy the Null Display object
+     *
+     */
+    ~NullDisplay() = default;
+
+    using DisplayInterface::updateDisplay;
+
+    /**
+     * @brief Counts the update without drawing anything
+     *
+     * @param frame The complete display content
+     * @param damage The rows and columns modified since the last update
+     */
+    virtual void updateDisplay(const FrameBufferView& frame, const DisplayDamage& damage);
+
+    /**
+     * @brief The number of times the display was updated
+     *
+     * @return long The update count
+     */
+    long updateCount();
+
+private:
+
+    long update_count_ = 0;
+};
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ * @file render_thread.cpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Implementation of a display presenting frames on its own thread
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include "render_thread.hpp"
+
+using namespace std;
+
+// Longest time the render thread sleeps without checking for a frame, bounds the delay of a missed notification
+static const int RENDER_WAIT_MS = 16;
+
+RenderThread::RenderThread(DisplayInterface* display)
+    : published_count_(0), presented_count_(0), running_(true), invalidated_(false) {
+    this->display_ = display;
+    memset(this->presented_rows_, 0, sizeof(this->presented_rows_));
+    this->presented_width_ = DISPLAY_WIDTH;
+    this->presented_height_ = DISPLAY_HEIGHT;
+
+    this->render_thread_ = new thread(&RenderThread::renderLoop, this);
+}
+
+RenderThread::~RenderThread() {
+    {
+        lock_guard<mutex> lock(this->wake_mutex_);
+        this->running_.store(false);
+    }
+    this->wake_.notify_one();
+    this->render_thread_->join();
+    delete this->render_thread_;
+}
+
+void RenderThread::updateDisplay(const FrameBufferView& frame, const DisplayDamage& damage) {
+    RenderFrame& back = this->frames_.writeBuffer();
+    memcpy(back.rows, frame.rows, frame.height * frame.wordsPerRow() * sizeof(uint64_t));
+    back.width = frame.width;
+    back.height = frame.height;
+    back.sequence = this->published_count_.load(memory_order_relaxed);
+    this->frames_.publish();
+    this->published_count_.fetch_add(1, memory_order_relaxed);
+
+    // Notifying without the lock keeps the emulator from ever waiting on the render thread
+    this->wake_.notify_one();
+}
+
+void RenderThread::invalidate() {
+    this->invalidated_.store(true);
+}
+
+long RenderThread::publishedFrames() {
+    return this->published_count_.load();
+}
+
+long RenderThread::presentedFrames() {
+    return this->presented_count_.load();
+}
+
+void RenderThread::renderLoop() {
+    while (this->running_.load()) {
+        {
+            unique_lock<mutex> lock(this->wake_mutex_);
+            this->wake_.wait_for(lock, chrono::milliseconds(RENDER_WAIT_MS), [this] {
+                return this->frames_.fresh() || !this->running_.load();
+            });
+        }
+        if (this->frames_.update()) {
+            this->present();
+        }
+    }
+
+    // The last frame published is always shown
+    if (this->frames_.update()) {
+        this->present();
+    }
+}
+
+void RenderThread::present() {
+    const RenderFrame& front = this->frames_.readBuffer();
+
+    FrameBufferView frame = {front.rows, front.width, front.height};
+    if (this->invalidated_.exchange(false)) {
+        this->display_->invalidate();
+    }
+
+    // A frame of a different size is redrawn entirely
+    bool resized = front.width != this->presented_width_ || front.height != this->presented_height_;
+    DisplayDamage damage;
+    for (int y = 0; y < frame.height; y++) {
+        for (int word = 0; word < frame.wordsPerRow(); word++) {
+            uint64_t presented = resized ? ~frame.row(y)[word] : this->presented_rows_[y * frame.wordsPerRow() + word];
+            damage.add(y, frame.row(y)[word] ^ presented, word);
+        }
+    }
+    memcpy(this->presented_rows_, front.rows, frame.height * frame.wordsPerRow() * sizeof(uint64_t));
+    this->presented_width_ = front.width;
+    this->presented_height_ = front.height;
+
+    this->display_->updateDisplay(frame, damage);
+    this->presented_count_.fetch_add(1, memory_order_relaxed);
+}
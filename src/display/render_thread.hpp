@@ -0,0 +1,128 @@
+/**
+ * @file render_thread.hpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Definition of a display presenting frames on its own thread
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef RENDER_THREAD_H
+#define RENDER_THREAD_H
+
+#include <atomic>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include "display_interface.hpp"
+#include "../chip-8_state.hpp"
+#include "../triple_buffer.hpp"
+
+using namespace std;
+
+/**
+ * @brief A complete display handed from the emulator to the render thread
+ *
+ */
+struct RenderFrame {
+    uint64_t rows[MAX_FRAME_BUFFER_WORDS];
+
+    // Size of the display in pixels
+    int width;
+    int height;
+
+    // Number of frames published before this one
+    long sequence;
+};
+
+/**
+ * @brief A display that copies each frame into a triple buffer and presents it on a separate thread
+ *
+ * The emulator never waits on the wrapped display. The render thread always presents the newest frame, frames
+ * published while it is busy are dropped. The damage passed to the wrapped display is computed against the last
+ * frame it presented, so dropped frames never leave stale cells.
+ */
+class RenderThread : public DisplayInterface
+{
+public:
+    /**
+     * @brief Construct a new Render Thread object and starts the thread
+     *
+     * @param display The display updated from the render thread
+     */
+    RenderThread(DisplayInterface* display);
+
+    /**
+     * @brief Destroy the Render Thread object, the last frame published is presented before the thread stops
+     *
+     */
+    ~RenderThread();
+
+    using DisplayInterface::updateDisplay;
+
+    /**
+     * @brief Publishes a copy of the frame to the render thread without waiting
+     *
+     * @param frame The complete display content
+     * @param damage The rows and columns modified since the last update, recomputed by the render thread
+     */
+    virtual void updateDisplay(const FrameBufferView& frame, const DisplayDamage& damage);
+
+    /**
+     * @brief Invalidates the wrapped display from the render thread, before the next frame is presented
+     *
+     */
+    virtual void invalidate();
+
+    /**
+     * @brief The number of frames published by the emulator
+     *
+     * @return long The frame count
+     */
+    long publishedFrames();
+
+    /**
+     * @brief The number of frames presented on the wrapped display
+     *
+     * @return long The frame count
+     */
+    long presentedFrames();
+
+private:
+
+    /**
+     * @brief Presents frames until the render thread is stopped
+     *
+     */
+    void renderLoop();
+
+    /**
+     * @brief Updates the wrapped display with the front buffer
+     *
+     */
+    void present();
+
+    DisplayInterface* display_;
+
+    TripleBuffer<RenderFrame> frames_;
+
+    // The frame shown by the wrapped display
+    uint64_t presented_rows_[MAX_FRAME_BUFFER_WORDS];
+    int presented_width_;
+    int presented_height_;
+
+    atomic<long> published_count_;
+    atomic<long> presented_count_;
+    atomic<bool> running_;
+
+    // Set when the wrapped display must be invalidated before the next frame
+    atomic<bool> invalidated_;
+
+    // Wakes the render thread up when a frame is published
+    mutex wake_mutex_;
+    condition_variable wake_;
+
+    thread* render_thread_;
+};
+
+#endif
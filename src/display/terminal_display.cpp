@@ -1,5 +1,7 @@
 #include <iostream>
 #include <ncurses.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
 #include "terminal_display.hpp"
 #include "../chip-8_state.hpp"
 
@@ -13,14 +15,48 @@ TerminalDisplay::TerminalDisplay() {
     this->window_ = newwin(DISPLAY_HEIGHT, DISPLAY_WIDTH*2, 0, 0);
 }
 
-void TerminalDisplay::updateDisplay(CHIP8_State* state) {
-    // clear the emulator window
-    werase(this->window_);
-    // for each byte in the display
-    for (int j = 0; j < DISPLAY_HEIGHT; j++) {
-        for (int i = 0; i < DISPLAY_WIDTH; i++) {
-            bool is_pixel_active = state->displayValue(i, j);
-            if (is_pixel_active) {
+TerminalDisplay::~TerminalDisplay() {
+    // Gives the terminal back in the state it was found
+    delwin(this->window_);
+    endwin();
+}
+
+void TerminalDisplay::invalidate() {
+    // ncurses does not see SIGWINCH when it is handled by an event loop, the new size is read here
+    struct winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0) {
+        resizeterm(size.ws_row, size.ws_col);
+    }
+    clearok(curscr, TRUE);
+
+    // An unknown size redraws every pixel on the next update
+    this->width_ = 0;
+    this->height_ = 0;
+}
+
+void TerminalDisplay::updateDisplay(const FrameBufferView& frame, const DisplayDamage& damage) {
+    // The high resolution display uses a single column per pixel to fit the terminal
+    bool narrow = frame.width > DISPLAY_WIDTH;
+    bool resized = frame.width != this->width_ || frame.height != this->height_;
+    if (resized) {
+        wresize(this->window_, frame.height, narrow ? frame.width : frame.width * 2);
+        werase(this->window_);
+        this->width_ = frame.width;
+        this->height_ = frame.height;
+    }
+
+    // Cells outside of the damage already show the right pixels
+    int x_begin = resized ? 0 : damage.x_begin;
+    int x_end = resized ? frame.width : damage.x_end;
+    for (int j = 0; j < frame.height; j++) {
+        if (!resized && (damage.rows & ((uint64_t)1 << j)) == 0) {
+            continue;
+        }
+        for (int i = x_begin; i < x_end; i++) {
+            bool is_pixel_active = frame.pixel(i, j);
+            if (narrow) {
+                mvwprintw(this->window_, j, i, is_pixel_active ? "█" : " ");
+            } else if (is_pixel_active) {
                 mvwprintw(this->window_, j, i*2, "██");
             } else {
                 mvwprintw(this->window_, j, i*2, "  ");
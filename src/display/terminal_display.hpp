@@ -29,14 +29,23 @@ public:
      * @brief Destroy the Terminal Display object
      *
      */
-    ~TerminalDisplay() = default;
+    ~TerminalDisplay();
+
+    using DisplayInterface::updateDisplay;
+
+    /**
+     * @brief Redraws the damaged region of the display
+     *
+     * @param frame The complete display content
+     * @param damage The rows and columns modified since the last update
+     */
+    virtual void updateDisplay(const FrameBufferView& frame, const DisplayDamage& damage);
 
     /**
-     * @brief Updates the emulator display using the provided display state
+     * @brief Resizes ncurses to the terminal and repaints the whole screen on the next update
      *
-     * @param display_state A byte array containing the current display data
      */
-    virtual void updateDisplay(CHIP8_State* state);
+    virtual void invalidate();
 
     /**
      * @brief Gets the Window object
@@ -49,6 +58,10 @@ private:
 
     WINDOW* window_;
 
+    // Size in pixels of the frame currently shown
+    int width_ = DISPLAY_WIDTH;
+    int height_ = DISPLAY_HEIGHT;
+
 };
 
 #endif
\ No newline at end of file
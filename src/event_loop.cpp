@@ -0,0 +1,205 @@
+/**
+ * @file event_loop.cpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Implementation of the single threaded loop running the emulator, its input and its signals
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <algorithm>
+#include <chrono>
+#include "event_loop.hpp"
+
+#if defined(__linux__)
+#include <cerrno>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using std::chrono::steady_clock;
+
+// Epoll data of the timer and the signals, the inputs use their index
+static const uint64_t TIMER_EVENT = UINT64_MAX;
+static const uint64_t SIGNAL_EVENT = UINT64_MAX - 1;
+
+// Number of events handled per wake up, the remaining ones are returned by the next epoll_wait
+static const int MAX_EVENTS = 16;
+
+bool EventLoop::isSupported() {
+#if defined(__linux__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+#if defined(__linux__)
+
+/**
+ * @brief Adds a file descriptor to an epoll instance, watched for reads
+ *
+ */
+static void Watch(int epoll_fd, int fd, uint64_t data) {
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.u64 = data;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        throw "Could not watch a file descriptor";
+    }
+}
+
+EventLoop::EventLoop(CHIP8* chip_8, int frames_per_second, int max_late_frames) {
+    this->chip_8_ = chip_8;
+    this->frame_duration_ = chrono::nanoseconds(1000000000 / frames_per_second);
+    this->max_late_frames_ = max_late_frames;
+
+    // The signals are only delivered through the signalfd
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGHUP);
+    sigaddset(&signals, SIGWINCH);
+    pthread_sigmask(SIG_BLOCK, &signals, &this->previous_mask_);
+
+    this->epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    this->timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    this->signal_fd_ = signalfd(-1, &signals, SFD_CLOEXEC | SFD_NONBLOCK);
+    if (this->epoll_fd_ < 0 || this->timer_fd_ < 0 || this->signal_fd_ < 0) {
+        throw "Could not create the event loop";
+    }
+    Watch(this->epoll_fd_, this->timer_fd_, TIMER_EVENT);
+    Watch(this->epoll_fd_, this->signal_fd_, SIGNAL_EVENT);
+}
+
+EventLoop::~EventLoop() {
+    close(this->signal_fd_);
+    close(this->timer_fd_);
+    close(this->epoll_fd_);
+    pthread_sigmask(SIG_SETMASK, &this->previous_mask_, NULL);
+}
+
+void EventLoop::addInput(int fd, InputHandler handler) {
+    Watch(this->epoll_fd_, fd, this->inputs_.size());
+    this->inputs_.push_back(handler);
+    this->input_fds_.push_back(fd);
+}
+
+int EventLoop::run() {
+    this->statistics_ = FrameStatistics();
+    this->total_jitter_us_ = 0.0;
+    this->wake_ups_ = 0;
+    this->ticks_ = 0;
+
+    // The timer expires every period from now on, the first frame ends one period from now
+    itimerspec period = {};
+    period.it_interval.tv_sec = this->frame_duration_.count() / 1000000000;
+    period.it_interval.tv_nsec = this->frame_duration_.count() % 1000000000;
+    period.it_value = period.it_interval;
+    this->start_ = steady_clock::now();
+    timerfd_settime(this->timer_fd_, 0, &period, NULL);
+
+    int stop_signal = 0;
+    epoll_event events[MAX_EVENTS];
+    while (stop_signal == 0 && !this->chip_8_->state()->exited()) {
+        int count = epoll_wait(this->epoll_fd_, events, MAX_EVENTS, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw "Could not wait for events";
+        }
+
+        // Signals and inputs are handled before the frames they happened during are run
+        uint64_t expirations = 0;
+        for (int i = 0; i < count; i++) {
+            uint64_t data = events[i].data.u64;
+            if (data == SIGNAL_EVENT) {
+                stop_signal = this->handleSignals();
+            } else if (data == TIMER_EVENT) {
+                if (read(this->timer_fd_, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+                    expirations = 0;
+                }
+            } else if (!this->inputs_[data]()) {
+                epoll_ctl(this->epoll_fd_, EPOLL_CTL_DEL, this->input_fds_[data], NULL);
+            }
+        }
+
+        if (stop_signal == 0 && expirations > 0) {
+            this->runFrames(expirations);
+        }
+    }
+
+    itimerspec disarmed = {};
+    timerfd_settime(this->timer_fd_, 0, &disarmed, NULL);
+    return stop_signal;
+}
+
+int EventLoop::handleSignals() {
+    int stop_signal = 0;
+    signalfd_siginfo info;
+    while (read(this->signal_fd_, &info, sizeof(info)) == sizeof(info)) {
+        if (info.ssi_signo == SIGWINCH) {
+            this->chip_8_->Redraw();
+        } else {
+            stop_signal = info.ssi_signo;
+        }
+    }
+    return stop_signal;
+}
+
+#else
+
+EventLoop::EventLoop(CHIP8* chip_8, int frames_per_second, int max_late_frames) {
+    throw "The event loop is only available on Linux";
+}
+
+EventLoop::~EventLoop() {}
+
+void EventLoop::addInput(int fd, InputHandler handler) {}
+
+int EventLoop::run() {
+    return 0;
+}
+
+int EventLoop::handleSignals() {
+    return 0;
+}
+
+#endif
+
+void EventLoop::runFrames(uint64_t expirations) {
+    steady_clock::time_point now = steady_clock::now();
+
+    // How late the thread woke up after the last deadline
+    this->ticks_ += expirations;
+    steady_clock::time_point deadline = this->start_ + chrono::duration_cast<steady_clock::duration>(
+        this->frame_duration_ * this->ticks_);
+    chrono::duration<double, micro> jitter = now - deadline;
+    this->wake_ups_++;
+    this->total_jitter_us_ += jitter.count();
+    this->statistics_.mean_jitter_us = this->total_jitter_us_ / this->wake_ups_;
+    this->statistics_.max_jitter_us = max(this->statistics_.max_jitter_us, jitter.count());
+
+    // Too far behind to catch up, drop the missed frames instead of running them in a burst
+    long frames = expirations;
+    if (frames - 1 > this->max_late_frames_) {
+        this->statistics_.dropped_frames += frames - 1;
+        frames = 1;
+    }
+
+    RunSummary summary = this->chip_8_->RunFrames(frames);
+    this->statistics_.frames += summary.frames;
+    this->statistics_.instructions += summary.cycles;
+
+    chrono::duration<double> elapsed = steady_clock::now() - this->start_;
+    this->statistics_.seconds = elapsed.count();
+}
+
+const FrameStatistics& EventLoop::statistics() {
+    return this->statistics_;
+}
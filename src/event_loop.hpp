@@ -0,0 +1,135 @@
+/**
+ * @file event_loop.hpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Definition of the single threaded loop running the emulator, its input and its signals
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef EVENT_LOOP_HPP
+#define EVENT_LOOP_HPP
+
+#include <csignal>
+#include <functional>
+#include <iostream>
+#include <vector>
+#include "chip-8.hpp"
+#include "frame_scheduler.hpp"
+
+using namespace std;
+
+/**
+ * @brief Runs the emulator, its inputs and the process signals from a single thread
+ *
+ * The thread sleeps in epoll until the next 60Hz deadline of a timerfd, an input file descriptor becomes readable
+ * or a signal arrives through a signalfd. Inputs are drained first, then the frames due are run, each presenting
+ * its display, so nothing ever spins. SIGINT, SIGTERM and SIGHUP stop the loop, SIGWINCH redraws the display.
+ *
+ * Only available on Linux. The signals are blocked for the calling thread while the loop exists, threads started
+ * meanwhile inherit the mask.
+ */
+class EventLoop
+{
+
+public:
+
+    /**
+     * @brief Called when an input file descriptor is readable
+     *
+     * @return false The file descriptor was closed and is no longer watched
+     */
+    typedef function<bool()> InputHandler;
+
+    /**
+     * @brief Whether the event loop is available on this platform
+     *
+     */
+    static bool isSupported();
+
+    /**
+     * @brief Construct a new Event Loop object, blocking the signals it handles
+     *
+     * @param chip_8 The emulator run by the loop
+     * @param frames_per_second The frame rate of the timer
+     * @param max_late_frames Number of frames emulation may fall behind before the missed frames are dropped
+     */
+    EventLoop(CHIP8* chip_8, int frames_per_second = FRAMES_PER_SECOND, int max_late_frames = 5);
+
+    /**
+     * @brief Destroy the Event Loop object, the signals it handled are unblocked
+     *
+     */
+    ~EventLoop();
+
+    /**
+     * @brief Watches a file descriptor, drained before the frames due are run
+     *
+     * @param fd The file descriptor, watched for reads
+     * @param handler Called each time fd is readable
+     */
+    void addInput(int fd, InputHandler handler);
+
+    /**
+     * @brief Runs frames at the timer rate until the program exits or a signal stops the loop
+     *
+     * @return int The signal that stopped the loop, 0 when the program exited
+     */
+    int run();
+
+    /**
+     * @brief Measured speed and pacing accuracy of the frames run
+     *
+     * @return const FrameStatistics& The statistics of the last run
+     */
+    const FrameStatistics& statistics();
+
+private:
+
+    /**
+     * @brief Handles the pending signals
+     *
+     * @return int The signal stopping the loop, 0 to keep running
+     */
+    int handleSignals();
+
+    /**
+     * @brief Runs the frames due since the timer last expired, dropping them when too far behind
+     *
+     * @param expirations The number of timer periods elapsed since the last frame
+     */
+    void runFrames(uint64_t expirations);
+
+    CHIP8* chip_8_;
+
+    chrono::nanoseconds frame_duration_;
+
+    int max_late_frames_;
+
+    int epoll_fd_ = -1;
+
+    int timer_fd_ = -1;
+
+    int signal_fd_ = -1;
+
+    // The watched inputs, indexed by the epoll data of their file descriptor
+    vector<InputHandler> inputs_;
+
+    vector<int> input_fds_;
+
+    // When the timer started and how many periods elapsed since, to measure how late each frame started
+    chrono::steady_clock::time_point start_;
+
+    uint64_t ticks_ = 0;
+
+    // The signal mask restored when the loop is destroyed
+    sigset_t previous_mask_;
+
+    // Sum of every wake up delay and number of wake ups, used to compute the mean jitter
+    double total_jitter_us_ = 0.0;
+
+    long wake_ups_ = 0;
+
+    FrameStatistics statistics_;
+};
+
+#endif
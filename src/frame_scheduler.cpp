@@ -0,0 +1,86 @@
+/**
+ * @file frame_scheduler.cpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Implementation of the scheduler pacing emulated frames against a monotonic clock
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include "frame_scheduler.hpp"
+
+#if defined(__linux__)
+#include <cerrno>
+#include <time.h>
+#endif
+
+using namespace std;
+using std::chrono::steady_clock;
+
+double FrameStatistics::instructionsPerSecond() const {
+    return this->seconds > 0.0 ? this->instructions / this->seconds : 0.0;
+}
+
+FrameScheduler::FrameScheduler(int frames_per_second, int max_late_frames) {
+    this->frame_duration_ = chrono::duration_cast<steady_clock::duration>(
+        chrono::nanoseconds(1000000000 / frames_per_second));
+    this->max_late_frames_ = max_late_frames;
+    this->start();
+}
+
+void FrameScheduler::start() {
+    this->start_ = steady_clock::now();
+    this->deadline_ = this->start_ + this->frame_duration_;
+    this->total_jitter_us_ = 0.0;
+    this->slept_frames_ = 0;
+    this->statistics_ = FrameStatistics();
+}
+
+void FrameScheduler::endFrame(int instructions) {
+    this->statistics_.frames++;
+    this->statistics_.instructions += instructions;
+
+    steady_clock::time_point now = steady_clock::now();
+    if (now < this->deadline_) {
+        this->sleepUntil(this->deadline_);
+
+        // How late the thread woke up
+        chrono::duration<double, micro> jitter = steady_clock::now() - this->deadline_;
+        this->slept_frames_++;
+        this->total_jitter_us_ += jitter.count();
+        this->statistics_.max_jitter_us = max(this->statistics_.max_jitter_us, jitter.count());
+        this->statistics_.mean_jitter_us = this->total_jitter_us_ / this->slept_frames_;
+    } else if (now - this->deadline_ > this->max_late_frames_ * this->frame_duration_) {
+        // Too far behind to catch up, drop the missed frames instead of running them in a burst
+        long missed = (now - this->deadline_) / this->frame_duration_;
+        this->statistics_.dropped_frames += missed;
+        this->deadline_ += missed * this->frame_duration_;
+    }
+
+    // Late frames keep their deadline so the next ones run back to back until emulation caught up
+    this->deadline_ += this->frame_duration_;
+
+    chrono::duration<double> elapsed = steady_clock::now() - this->start_;
+    this->statistics_.seconds = elapsed.count();
+}
+
+const FrameStatistics& FrameScheduler::statistics() {
+    return this->statistics_;
+}
+
+void FrameScheduler::sleepUntil(steady_clock::time_point deadline) {
+#if defined(__linux__)
+    // The steady clock of libstdc++ and libc++ is CLOCK_MONOTONIC on Linux
+    chrono::nanoseconds since_epoch = chrono::duration_cast<chrono::nanoseconds>(deadline.time_since_epoch());
+    struct timespec request;
+    request.tv_sec = since_epoch.count() / 1000000000;
+    request.tv_nsec = since_epoch.count() % 1000000000;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &request, NULL) == EINTR) {
+        // Interrupted by a signal, the deadline is absolute so sleeping again is safe
+    }
+#else
+    this_thread::sleep_until(deadline);
+#endif
+}
@@ -0,0 +1,112 @@
+/**
+ * @file frame_scheduler.hpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Definition of the scheduler pacing emulated frames against a monotonic clock
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef FRAME_SCHEDULER_HPP
+#define FRAME_SCHEDULER_HPP
+
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+/**
+ * @brief Measurements collected while pacing frames
+ *
+ */
+struct FrameStatistics {
+    // Number of frames completed
+    long frames = 0;
+
+    // Number of frames skipped because emulation fell too far behind
+    long dropped_frames = 0;
+
+    // Number of instructions executed over every frame
+    long instructions = 0;
+
+    // Time elapsed since the scheduler was started
+    double seconds = 0.0;
+
+    // Average delay between a deadline and the moment the thread woke up, in microseconds
+    double mean_jitter_us = 0.0;
+
+    // Largest delay between a deadline and the moment the thread woke up, in microseconds
+    double max_jitter_us = 0.0;
+
+    /**
+     * @brief Instructions executed per second of wall clock time
+     *
+     */
+    double instructionsPerSecond() const;
+};
+
+/**
+ * @brief Paces frames on absolute deadlines of a monotonic clock
+ *
+ * Each frame is given a deadline computed from the start of the run rather than from the end of the previous frame,
+ * so the error of every sleep does not accumulate. Frames running late are caught up by skipping the sleep, and
+ * the schedule is reset once it falls more than a few frames behind.
+ */
+class FrameScheduler
+{
+
+public:
+
+    /**
+     * @brief Construct a new Frame Scheduler object
+     *
+     * @param frames_per_second The frame rate to pace
+     * @param max_late_frames Number of frames emulation may fall behind before the schedule is reset
+     */
+    FrameScheduler(int frames_per_second = 60, int max_late_frames = 5);
+
+    /**
+     * @brief Starts the schedule and clears the statistics. The first frame ends one period from now.
+     *
+     */
+    void start();
+
+    /**
+     * @brief Records the frame that was just emulated, then sleeps until the deadline of the next one
+     *
+     * @param instructions The number of instructions executed during the frame
+     */
+    void endFrame(int instructions);
+
+    /**
+     * @brief Measurements since the scheduler was started
+     *
+     * @return const FrameStatistics& The statistics of the run
+     */
+    const FrameStatistics& statistics();
+
+private:
+
+    /**
+     * @brief Sleeps until the provided absolute time of the steady clock
+     *
+     */
+    void sleepUntil(chrono::steady_clock::time_point deadline);
+
+    chrono::steady_clock::duration frame_duration_;
+
+    int max_late_frames_;
+
+    chrono::steady_clock::time_point start_;
+
+    chrono::steady_clock::time_point deadline_;
+
+    // Sum of every wake up delay, used to compute the mean jitter
+    double total_jitter_us_ = 0.0;
+
+    // Number of frames that finished early and slept until their deadline
+    long slept_frames_ = 0;
+
+    FrameStatistics statistics_;
+};
+
+#endif
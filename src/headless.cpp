@@ -0,0 +1,65 @@
+/**
+ * @file headless.cpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Implementation of the headless runner
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <chrono>
+#include <stdexcept>
+#include "chip-8.hpp"
+#include "frame_scheduler.hpp"
+#include "headless.hpp"
+#include "input/scripted_input.hpp"
+
+using namespace std;
+using std::chrono::steady_clock;
+
+double HeadlessReport::instructionsPerSecond() const {
+    return this->seconds > 0.0 ? this->instructions / this->seconds : 0.0;
+}
+
+HeadlessReport RunHeadless(CHIP8* chip_8, ScriptedInput* input, const HeadlessOptions& options) {
+    if (options.instructions <= 0 && options.frames <= 0) {
+        throw invalid_argument("A headless run requires an instruction or frame budget");
+    }
+
+    HeadlessReport report;
+    FrameScheduler scheduler(FRAMES_PER_SECOND);
+    steady_clock::time_point start = steady_clock::now();
+
+    while ((options.frames <= 0 || report.frames < options.frames)
+        && (options.instructions <= 0 || report.instructions < options.instructions)) {
+
+        input->setFrame(report.frames);
+
+        // A frame runs the instructions of the frame then updates the timers, unless the budget ends first
+        RunSummary summary;
+        long remaining = options.instructions - report.instructions;
+        if (options.instructions > 0 && remaining < chip_8->instructionsPerFrame()) {
+            summary = chip_8->RunCycles(remaining);
+        } else {
+            summary = chip_8->RunFrames(1);
+        }
+        report.instructions += summary.cycles;
+        report.idle_instructions += summary.idle_cycles;
+        report.draws += summary.draws;
+        report.frames++;
+
+        if (!options.turbo) {
+            scheduler.endFrame(summary.cycles);
+        }
+        if (summary.stop_reason == StopReason::Exit) {
+            break;
+        }
+    }
+
+    chrono::duration<double> duration = steady_clock::now() - start;
+    report.seconds = duration.count();
+    report.display_hash = chip_8->state()->displayHash();
+    report.mean_jitter_us = scheduler.statistics().mean_jitter_us;
+    report.max_jitter_us = scheduler.statistics().max_jitter_us;
+    report.dropped_frames = scheduler.statistics().dropped_frames;
+    return report;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file headless.hpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Definition of the headless runner, executing a ROM without drawing anything for a fixed budget
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef HEADLESS_HPP
+#define HEADLESS_HPP
+
+#include <iostream>
+#include "chip-8.hpp"
+#include "input/scripted_input.hpp"
+
+using namespace std;
+
+/**
+ * @brief Limits and pacing of a headless run
+ *
+ */
+struct HeadlessOptions {
+    // Maximum number of instructions to execute, 0 for no limit
+    long instructions = 0;
+
+    // Maximum number of 60Hz frames to emulate, 0 for no limit
+    long frames = 0;
+
+    // Runs as fast as the host allows instead of pacing frames in real time
+    bool turbo = false;
+};
+
+/**
+ * @brief Outcome of a headless run
+ *
+ */
+struct HeadlessReport {
+    // Number of instructions executed
+    long instructions = 0;
+
+    // Number of 60Hz frames emulated, including a partial last frame
+    long frames = 0;
+
+    // Number of the instructions spent in idle loops, skipped without executing them
+    long idle_instructions = 0;
+
+    // Number of times the display was updated
+    long draws = 0;
+
+    // Wall clock duration of the run
+    double seconds = 0.0;
+
+    // Hash of the display once the run is over
+    uint64_t display_hash = 0;
+
+    // Pacing accuracy of the frames, only measured when not running in turbo
+    double mean_jitter_us = 0.0;
+    double max_jitter_us = 0.0;
+    long dropped_frames = 0;
+
+    /**
+     * @brief Instructions executed per second of wall clock time
+     *
+     */
+    double instructionsPerSecond() const;
+};
+
+/**
+ * @brief Runs the emulator until either budget of the options is spent
+ *
+ * Every frame executes CHIP8::instructionsPerFrame() instructions, then moves the scripted input to the next frame
+ * and updates the timers. Exceptions thrown by the emulator are propagated.
+ *
+ * @param chip_8 The emulator to run, with its ROM already loaded
+ * @param input The input device the emulator was created with
+ * @param options The budgets of the run. At least one budget must be set.
+ * @return HeadlessReport The summary of the run
+ */
+HeadlessReport RunHeadless(CHIP8* chip_8, ScriptedInput* input, const HeadlessOptions& options);
+
+#endif
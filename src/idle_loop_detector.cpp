@@ -0,0 +1,101 @@
+/**
+ * @file idle_loop_detector.cpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Implementation of the detector finding loops that spin until the next timer update
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <cstring>
+#include "chip-8_state.hpp"
+#include "dispatch.hpp"
+#include "idle_loop_detector.hpp"
+#include "instruction.hpp"
+
+using namespace std;
+
+bool StateFingerprint::operator==(const StateFingerprint& other) const {
+    return this->program_counter == other.program_counter
+        && this->index_register == other.index_register
+        && this->delay_timer == other.delay_timer
+        && memcmp(this->v_registers, other.v_registers, sizeof(this->v_registers)) == 0;
+}
+
+IdleLoopDetector::IdleLoopDetector(CHIP8_State* state) {
+    this->state_ = state;
+}
+
+bool IdleLoopDetector::inCandidateLoop() {
+    uint16_t program_counter = this->state_->programCounter();
+
+    // Look for the jump closing the loop, at most one loop length ahead
+    for (int i = 0; i < MAX_IDLE_LOOP_LENGTH; i++) {
+        uint16_t address = program_counter + 2 * i;
+        if (address + 1 >= RAM_SIZE || !this->isPure(address)) {
+            return false;
+        }
+
+        Instruction instruction(this->opCode(address));
+        if (OP_CODE_TABLE.lookup(instruction.op_code).id != OP_1NNN) {
+            continue;
+        }
+
+        // The loop runs from the jump target to the jump, and must contain the program counter
+        uint16_t start = instruction.nnn;
+        if (start > program_counter || (address - start) / 2 >= MAX_IDLE_LOOP_LENGTH) {
+            return false;
+        }
+        for (uint16_t before = start; before < program_counter; before += 2) {
+            if (!this->isPure(before)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    return false;
+}
+
+StateFingerprint IdleLoopDetector::fingerprint() {
+    StateFingerprint fingerprint;
+    fingerprint.program_counter = this->state_->programCounter();
+    fingerprint.index_register = this->state_->indexRegister();
+    fingerprint.delay_timer = this->state_->delayTimer();
+    for (uint8_t i = 0; i < V_REGISTER_COUNT; i++) {
+        fingerprint.v_registers[i] = this->state_->vRegister(i);
+    }
+    return fingerprint;
+}
+
+bool IdleLoopDetector::isPure(uint16_t address) {
+    switch (OP_CODE_TABLE.lookup(this->opCode(address)).id) {
+        case OP_1NNN:
+        case OP_3XNN:
+        case OP_4XNN:
+        case OP_5XY0:
+        case OP_6XNN:
+        case OP_7XNN:
+        case OP_8XY0:
+        case OP_8XY1:
+        case OP_8XY2:
+        case OP_8XY3:
+        case OP_8XY4:
+        case OP_8XY5:
+        case OP_8XY6:
+        case OP_8XY7:
+        case OP_8XYE:
+        case OP_9XY0:
+        case OP_ANNN:
+        case OP_FX07:
+        case OP_FX1E:
+        case OP_FX29:
+            return true;
+        default:
+            // Memory, stack, display, input and random number accesses have effects outside of the registers
+            return false;
+    }
+}
+
+uint16_t IdleLoopDetector::opCode(uint16_t address) {
+    return ((uint16_t)this->state_->memoryValue(address) << 8) | this->state_->memoryValue(address + 1);
+}
@@ -0,0 +1,82 @@
+/**
+ * @file idle_loop_detector.hpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Definition of the detector finding loops that spin until the next timer update
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef IDLE_LOOP_DETECTOR_HPP
+#define IDLE_LOOP_DETECTOR_HPP
+
+#include <iostream>
+#include "chip-8_state.hpp"
+
+using namespace std;
+
+// Longest loop, in instructions, considered by the idle loop detector
+static const int MAX_IDLE_LOOP_LENGTH = 8;
+
+/**
+ * @brief The part of the state an idle loop could modify
+ *
+ */
+struct StateFingerprint {
+    uint16_t program_counter;
+    uint16_t index_register;
+    uint8_t delay_timer;
+    uint8_t v_registers[16];
+
+    bool operator==(const StateFingerprint& other) const;
+};
+
+/**
+ * @brief Finds loops that leave the state unchanged after every iteration, such as a jump to itself or a loop
+ * reading the delay timer until it reaches 0.
+ *
+ * Such a loop keeps doing the same thing until something outside of the instructions changes, which only happens
+ * when the timers are updated. A loop is only considered when every instruction in it is deterministic and only
+ * touches registers, so skipping its iterations gives the exact same state as running them.
+ */
+class IdleLoopDetector
+{
+
+public:
+
+    /**
+     * @brief Construct a new Idle Loop Detector object
+     *
+     * @param state The state instructions are read from
+     */
+    IdleLoopDetector(CHIP8_State* state);
+
+    /**
+     * @brief Whether the program counter is inside a short backward jump loop made of register only instructions
+     *
+     * Only looks at the instructions in memory. The loop must still be run once to know whether it is idle.
+     *
+     * @return true If the current loop could be idle
+     */
+    bool inCandidateLoop();
+
+    /**
+     * @brief Captures the part of the state an idle loop could modify
+     *
+     * @return StateFingerprint The current fingerprint
+     */
+    StateFingerprint fingerprint();
+
+private:
+
+    /**
+     * @brief Whether the instruction at the address only reads and writes registers and is deterministic
+     *
+     */
+    bool isPure(uint16_t address);
+
+    uint16_t opCode(uint16_t address);
+
+    CHIP8_State* state_;
+};
+
+#endif
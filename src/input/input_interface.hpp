@@ -41,6 +41,26 @@ public:
      * @return uint8_t A value in the range of 0x0 to 0xF
      */
     virtual uint8_t getInput() = 0;
+
+    /**
+     * @brief Takes a key pressed since the last frame without waiting, used by FX0A so a program waiting for a key
+     * never blocks the emulator. Waits with getInput unless overridden.
+     *
+     * @param key Receives a value in the range of 0x0 to 0xF
+     * @return true A key was pressed
+     * @return false No key was pressed yet, key is unchanged
+     */
+    virtual bool pollInput(uint8_t& key) {
+        key = this->getInput();
+        return true;
+    }
+
+    /**
+     * @brief Called by the emulator at the end of every frame, inputs collected in the background are applied here
+     * so the keys do not change in the middle of a frame
+     *
+     */
+    virtual void endFrame() {}
 };
 
 #endif
\ No newline at end of file
@@ -3,11 +3,14 @@
 
 using namespace std;
 
+MockInput::MockInput(uint64_t seed) {
+    SeedRandom(this->random_state_, seed);
+}
 
 bool MockInput::isPressed(uint8_t input_code) {
-    return (bool)rand() % 2;
+    return (NextRandom(this->random_state_) >> 31) != 0;
 }
 
 uint8_t MockInput::getInput() {
-    return (uint8_t)rand() % 9;
-}
\ No newline at end of file
+    return (uint8_t)(NextRandom(this->random_state_) % 9);
+}
@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include "input_interface.hpp"
+#include "../random.hpp"
 
 using namespace std;
 
@@ -17,8 +18,9 @@ public:
     /**
      * @brief Constructs a new Mock Input object
      *
+     * @param seed (optional) Seed of the keys reported, equal seeds report the same keys
      */
-    MockInput() = default;
+    MockInput(uint64_t seed = 0);
 
         /**
      * @brief Method used to determine whether or not a current input button is currently pressed
@@ -32,10 +34,18 @@ public:
     /**
      * @brief Blocks until one of the 16 valid keys is pressd
      *
-     * @return uint8_t A random value in the range of 0x0 to 0xF
+     * @return uint8_t A random value in the range of 0x0 to 0x8
      */
     virtual uint8_t getInput();
 
+private:
+
+    /**
+     * @brief State of the generator of the keys reported
+     *
+     */
+    uint32_t random_state_[RANDOM_STATE_WORDS];
+
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "scripted_input.hpp"
+
+using namespace std;
+
+void ScriptedInput::loadScript(istream& script) {
+    string line;
+    int line_number = 0;
+    while (getline(script, line)) {
+        line_number++;
+        if (line.find_first_not_of(" \t\r") == string::npos || line[line.find_first_not_of(" \t")] == '#') {
+            continue;
+        }
+
+        long frame;
+        unsigned int key;
+        long duration;
+        istringstream fields(line);
+        if (!(fields >> frame >> hex >> key >> dec >> duration) || key > 0xF || frame < 0 || duration < 1) {
+            throw invalid_argument("Invalid key press on line " + to_string(line_number) + ": " + line);
+        }
+        this->addKeyPress(frame, (uint8_t)key, duration);
+    }
+}
+
+void ScriptedInput::addKeyPress(long frame, uint8_t key, long duration) {
+    KeyPress press = {frame, key, duration};
+    auto position = upper_bound(this->presses_.begin(), this->presses_.end(), press,
+        [](const KeyPress& a, const KeyPress& b) { return a.frame < b.frame; });
+    this->presses_.insert(position, press);
+}
+
+void ScriptedInput::setFrame(long frame) {
+    this->frame_ = frame;
+}
+
+bool ScriptedInput::isPressed(uint8_t input_code) {
+    for (KeyPress& press : this->presses_) {
+        if (press.frame > this->frame_) {
+            break;
+        }
+        if (press.key == input_code && this->frame_ < press.frame + press.duration) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint8_t ScriptedInput::getInput() {
+    for (KeyPress& press : this->presses_) {
+        if (this->frame_ < press.frame + press.duration) {
+            return press.key;
+        }
+    }
+    return 0x0;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file scripted_input.hpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Definition of an input device replaying key presses from a script
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef SCRIPTED_INPUT_H
+#define SCRIPTED_INPUT_H
+
+#include <iostream>
+#include <vector>
+#include "input_interface.hpp"
+
+using namespace std;
+
+/**
+ * @brief A key held down for a number of frames
+ *
+ */
+struct KeyPress {
+    // Frame the key is pressed on
+    long frame;
+
+    // Hex code of the key, 0x0 to 0xF
+    uint8_t key;
+
+    // Number of frames the key is held for
+    long duration;
+};
+
+/**
+ * @brief An input device pressing keys on predetermined frames, so headless runs are reproducible
+ *
+ */
+class ScriptedInput : public InputInterface
+{
+
+public:
+    /**
+     * @brief Constructs a new Scripted Input object without any key press
+     *
+     */
+    ScriptedInput() = default;
+
+    /**
+     * @brief Reads key presses from a script
+     *
+     * Each line holds the frame the key is pressed on, the key in hex and the number of frames it is held for,
+     * separated by spaces. Empty lines and lines starting with # are ignored.
+     *
+     * @param script The script to read
+     * @throws invalid_argument If a line cannot be parsed
+     */
+    void loadScript(istream& script);
+
+    /**
+     * @brief Adds a single key press to the script
+     *
+     * @param frame Frame the key is pressed on
+     * @param key Hex code of the key
+     * @param duration Number of frames the key is held for
+     */
+    void addKeyPress(long frame, uint8_t key, long duration);
+
+    /**
+     * @brief Moves the script to the provided frame
+     *
+     * @param frame The frame currently emulated
+     */
+    void setFrame(long frame);
+
+    /**
+     * @brief Whether the key is held down on the current frame
+     *
+     * @param input_code Hex code for one of the 16 inputs to the Chip-8 emulator
+     * @return true If a key press of the script covers the current frame
+     * @return false Otherwise
+     */
+    virtual bool isPressed(uint8_t input_code);
+
+    /**
+     * @brief Returns the next key pressed by the script without waiting for its frame
+     *
+     * @return uint8_t The key held on the current frame, or the next key pressed. 0x0 once the script is over.
+     */
+    virtual uint8_t getInput();
+
+private:
+
+    // Key presses sorted by frame
+    vector<KeyPress> presses_;
+
+    long frame_ = 0;
+};
+
+#endif
@@ -1,86 +1,195 @@
+#include <cerrno>
 #include <exception>
 #include <iostream>
-#include <map>
 #include <ncurses.h>
+#include <poll.h>
 #include <stdio.h>
 #include <thread>
+#include <unistd.h>
 #include "terminal_input.hpp"
 
 using namespace std;
 
-TerminalInput::TerminalInput(WINDOW* window) {
-    // each key the user hits is returned immediately by getch()
-    cbreak();
-    noecho();
+const chrono::milliseconds TerminalInput::DEFAULT_KEY_HOLD_TIME = chrono::milliseconds(100);
+const chrono::milliseconds TerminalInput::KEY_WAIT_TIMEOUT = chrono::milliseconds(50);
 
+TerminalInput::TerminalInput(WINDOW* window, chrono::milliseconds hold_time, bool input_thread)
+    : keys_(0), running_(true) {
     this->window_ = window;
-    nodelay(this->window_, TRUE);
+    this->hold_time_ = hold_time;
 
+    // Raw mode: each key the user hits is readable immediately and is not echoed, Ctrl-C still interrupts
+    if (isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &this->saved_terminal_) == 0) {
+        termios raw = this->saved_terminal_;
+        raw.c_lflag &= ~(ICANON | ECHO | IEXTEN);
+        raw.c_iflag &= ~(IXON | ICRNL);
+        raw.c_cc[VMIN] = 1;
+        raw.c_cc[VTIME] = 0;
+        this->raw_ = tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0;
+    }
+
+    if (!input_thread) {
+        return;
+    }
+    if (pipe(this->wakeup_pipe_) != 0) {
+        throw "Could not create the input wakeup pipe";
+    }
     this->input_thread_ = new thread(&TerminalInput::updateInputState, this);
 }
 
 TerminalInput::~TerminalInput() {
-    this->input_thread_->join();
+    if (this->input_thread_ != NULL) {
+        char wakeup = 0;
+        if (write(this->wakeup_pipe_[1], &wakeup, 1) != 1) {
+            cerr << "Could not wake the input thread up" << endl;
+        }
+        this->input_thread_->join();
+        delete this->input_thread_;
+        close(this->wakeup_pipe_[0]);
+        close(this->wakeup_pipe_[1]);
+    }
+
+    if (this->raw_) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &this->saved_terminal_);
+    }
 }
 
 bool TerminalInput::isPressed(uint8_t input_code) {
+    // Pairs with the release store of endFrame
+    uint16_t keys = this->keys_.load(memory_order_acquire);
+    return (keys >> (input_code & 0xF)) & 1;
+}
+
+uint8_t TerminalInput::getInput() {
+    uint8_t key;
+    while (!this->pollInput(key)) {
+        if (!this->running_.load()) {
+            return this->last_key_;
+        }
+
+        if (this->input_thread_ == NULL) {
+            // Nobody else reads stdin
+            this->readKeys();
+            continue;
+        }
 
-    if (this->input_stale) {
-        // No input since last check, return false
+        // The timeout covers a notification sent between the check and the wait
+        unique_lock<mutex> lock(this->press_mutex_);
+        this->press_condition_.wait_for(lock, KEY_WAIT_TIMEOUT, [this]() {
+            return !this->events_.empty() || !this->running_.load();
+        });
+    }
+    return key;
+}
+
+bool TerminalInput::pollInput(uint8_t& key) {
+    KeyEvent event;
+    if (!this->events_.pop(event)) {
         return false;
-    } else {
-        // otherwise check for input match
-        bool is_pressed = input_code == this->last_keypress;
-        return is_pressed;
     }
+
+    // The following keys stay queued for the end of the frame
+    this->_applyEvent(event);
+    this->_publishKeys(chrono::steady_clock::now(), (uint16_t)1 << event.key);
+    this->last_key_ = event.key;
+    key = event.key;
+    return true;
 }
 
-uint8_t TerminalInput::getInput() {
-    // Wait for input thread to release lock
-    this->read_input_mutext_.lock();
-    uint8_t input = this->last_keypress;
-    this->read_input_mutext_.unlock();
+void TerminalInput::endFrame() {
+    KeyEvent event;
+    uint16_t typed = 0;
+    while (this->events_.pop(event)) {
+        this->_applyEvent(event);
+        typed |= (uint16_t)1 << event.key;
+    }
+    this->_publishKeys(chrono::steady_clock::now(), typed);
+}
+
+void TerminalInput::setHoldTime(chrono::milliseconds hold_time) {
+    this->hold_time_ = hold_time;
+}
+
+chrono::milliseconds TerminalInput::holdTime() {
+    return this->hold_time_;
+}
+
+bool TerminalInput::readKeys() {
+    char buffer[64];
+    ssize_t count;
+    do {
+        count = read(STDIN_FILENO, buffer, sizeof(buffer));
+    } while (count < 0 && errno == EINTR);
+
+    if (count <= 0) {
+        // Closed input, nothing will ever be pressed again so a pending getInput no longer waits
+        this->running_.store(false);
+        lock_guard<mutex> lock(this->press_mutex_);
+        this->press_condition_.notify_all();
+        return false;
+    }
 
-    return input;
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    bool queued = false;
+    for (ssize_t i = 0; i < count; i++) {
+        KeyEvent event = {_decodeKey(buffer[i]), now};
+        if (event.key != UINT8_MAX) {
+            queued |= this->events_.push(event);
+        }
+    }
+
+    if (queued) {
+        lock_guard<mutex> lock(this->press_mutex_);
+        this->press_condition_.notify_all();
+    }
+    return true;
 }
 
 void TerminalInput::updateInputState() {
-    map<char, uint8_t> char_to_code {
-        {'0', 0x0},
-        {'1', 0x1},
-        {'2', 0x2},
-        {'3', 0x3},
-        {'4', 0x4},
-        {'5', 0x5},
-        {'6', 0x6},
-        {'7', 0x7},
-        {'8', 0x8},
-        {'9', 0x9},
-        {'a', 0xa},
-        {'b', 0xb},
-        {'c', 0xc},
-        {'d', 0xd},
-        {'e', 0xe},
-        {'f', 0xf},
+    pollfd fds[2] = {
+        {STDIN_FILENO, POLLIN, 0},
+        {this->wakeup_pipe_[0], POLLIN, 0}
     };
 
-    while(true) {
-        // Enter critical section to update input
-        this->read_input_mutext_.lock();
-        // wait for input
-        this->input_stale = true;
-        char input = getchar();
-        // Flush input that accumulated during wait time
-        // Do not want the input buffer to accumulate
-        fflush(stdin);
-        this->last_keypress = char_to_code[input];
-        // leave critical section
-        this->read_input_mutext_.unlock();
-
-        // Update the flag indicating new input has been set
-        this->input_stale = false;
-
-        // Sleep for a short amount of time before marking input as stale
-        this_thread::sleep_for (chrono::milliseconds(100));
-    }
-}
\ No newline at end of file
+    while (true) {
+        // Sleep until keys are typed or the input is destroyed
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (fds[1].revents != 0 || !this->readKeys()) {
+            break;
+        }
+    }
+}
+
+uint8_t TerminalInput::_decodeKey(char input) {
+    if (input >= '0' && input <= '9') {
+        return input - '0';
+    }
+    if (input >= 'a' && input <= 'f') {
+        return input - 'a' + 0xa;
+    }
+    if (input >= 'A' && input <= 'F') {
+        return input - 'A' + 0xa;
+    }
+    return UINT8_MAX;
+}
+
+void TerminalInput::_applyEvent(const KeyEvent& event) {
+    this->held_ |= (uint16_t)1 << event.key;
+    this->last_press_[event.key] = event.time;
+}
+
+void TerminalInput::_publishKeys(chrono::steady_clock::time_point now, uint16_t typed) {
+    for (uint8_t key = 0; key < 16; key++) {
+        if (now - this->last_press_[key] >= this->hold_time_) {
+            this->held_ &= ~((uint16_t)1 << key);
+        }
+    }
+
+    // Keys typed during the frame are seen for at least one frame, whatever the hold time
+    this->keys_.store(this->held_ | typed, memory_order_release);
+}
@@ -1,33 +1,77 @@
 #ifndef TERMINAL_INPUT_H
 #define TERMINAL_INPUT_H
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
-#include <map>
 #include <mutex>
 #include <ncurses.h>
+#include <termios.h>
 #include <thread>
 #include "input_interface.hpp"
+#include "../spsc_queue.hpp"
 
 using namespace std;
 
+/**
+ * @brief A key typed in the terminal
+ *
+ */
+struct KeyEvent {
+    // Hex code of the key, 0x0 to 0xF
+    uint8_t key;
+
+    // When the key was read from the terminal
+    chrono::steady_clock::time_point time;
+};
+
 /**
  * @brief An implementation of the InputInterface that uses the terminal for keyboard input
  *
+ * The terminal is put in raw mode and a background thread waits on stdin with poll, queueing every key read as a
+ * timestamped event. Without the thread, an event loop watching stdin calls readKeys instead. The emulator applies
+ * the queued events at the end of each frame and publishes the keypad as a bitmask, so checking a key never takes
+ * a lock. Terminals only report key presses, a key is considered held for the hold time following its last press,
+ * which the key repeat of the terminal keeps extending.
  */
 class TerminalInput : public InputInterface
 {
 
 public:
 
+    /**
+     * @brief How long a key stays pressed after the terminal reported it, unless configured
+     *
+     */
+    static const chrono::milliseconds DEFAULT_KEY_HOLD_TIME;
+
+    /**
+     * @brief How long getInput sleeps before checking whether the input was closed
+     *
+     */
+    static const chrono::milliseconds KEY_WAIT_TIMEOUT;
+
+    /**
+     * @brief Number of key events that can wait for the end of a frame, keys typed past it are dropped
+     *
+     */
+    static const size_t KEY_EVENT_CAPACITY = 256;
+
     /**
      * @brief Construct a new Terminal Input object
      *
      * @param window Window instance from which key presses are retrieved from
+     * @param hold_time (optional) How long a key stays pressed after the terminal reported it
+     * @param input_thread (optional) Whether keys are read by a background thread, or by calling readKeys
      */
-    TerminalInput(WINDOW* window);
+    TerminalInput(
+        WINDOW* window,
+        chrono::milliseconds hold_time = DEFAULT_KEY_HOLD_TIME,
+        bool input_thread = true);
 
     /**
-     * @brief Destroys the Terminal Input object
+     * @brief Destroys the Terminal Input object, stopping the input thread and restoring the terminal
      *
      */
     ~TerminalInput();
@@ -44,18 +88,77 @@ public:
     /**
      * @brief Blocks until one of the 16 valid keys is pressd
      *
+     * Returns the first key typed since the end of the last frame, or waits for the next one.
+     *
      * @return The key pressed
      */
     virtual uint8_t getInput();
 
     /**
-     * @brief Method used to update the input state map
+     * @brief Takes the first key typed since the end of the last frame without waiting
+     *
+     * @param key Receives the key
+     * @return true A key was typed
+     */
+    virtual bool pollInput(uint8_t& key);
+
+    /**
+     * @brief Applies the keys typed during the frame and releases the keys held for longer than the hold time
+     *
+     */
+    virtual void endFrame();
+
+    /**
+     * @brief Sets how long a key stays pressed after the terminal reported it
+     *
+     * Shorter times release keys sooner, longer times bridge the delay before the key repeat of the terminal
+     * starts.
+     */
+    void setHoldTime(chrono::milliseconds hold_time);
+
+    /**
+     * @brief How long a key stays pressed after the terminal reported it
+     *
+     */
+    chrono::milliseconds holdTime();
+
+    /**
+     * @brief Queues the keys available on stdin, waiting for them if none are
+     *
+     * @return false stdin was closed, nothing will ever be typed again
+     */
+    bool readKeys();
+
+    /**
+     * @brief Method used to update the input state, run by the input thread until the input is destroyed or
+     * stdin is closed
      *
      */
     virtual void updateInputState();
 
 private:
 
+    /**
+     * @brief The key of a character typed in the terminal
+     *
+     * @return The hex code of the key, or UINT8_MAX for characters outside the keypad
+     */
+    static uint8_t _decodeKey(char input);
+
+    /**
+     * @brief Marks the key of an event as held from the time of the event
+     *
+     */
+    void _applyEvent(const KeyEvent& event);
+
+    /**
+     * @brief Releases the keys pressed longer than the hold time ago and publishes the keypad
+     *
+     * @param now The current time
+     * @param typed The keys typed since the last publication, pressed even if their hold time already elapsed
+     */
+    void _publishKeys(chrono::steady_clock::time_point now, uint16_t typed);
+
     /**
      * @brief Instance of the window input is retrieved from
      *
@@ -63,29 +166,82 @@ private:
     WINDOW* window_;
 
     /**
-     * @brief Last character retrieved from input
+     * @brief Keys typed and not yet applied, written by the input thread and read by the emulator
+     *
+     */
+    SpscQueue<KeyEvent, KEY_EVENT_CAPACITY> events_;
+
+    /**
+     * @brief Bit N is set while key N is pressed, published by the emulator at the end of each frame
+     *
+     */
+    atomic<uint16_t> keys_;
+
+    /**
+     * @brief Bit N is set when key N was pressed less than the hold time ago, used by the emulator only
      *
      */
-    uint8_t last_keypress;
+    uint16_t held_ = 0;
 
     /**
-     * @brief Mutext to control thread access
+     * @brief Time of the last press of each key, used by the emulator only
      *
      */
-    mutex read_input_mutext_;
+    chrono::steady_clock::time_point last_press_[16];
 
     /**
-     * @brief A flag used to indicate whether or not the last input char has already been read
+     * @brief Last key returned by getInput, returned again once stdin was closed
      *
      */
-    bool input_stale = false;
+    uint8_t last_key_ = 0;
 
+    /**
+     * @brief How long a key stays pressed after the terminal reported it
+     *
+     */
+    chrono::milliseconds hold_time_;
+
+    /**
+     * @brief Cleared once stdin was closed
+     *
+     */
+    atomic<bool> running_;
+
+    /**
+     * @brief Only used to wait on the press condition
+     *
+     */
+    mutex press_mutex_;
+
+    /**
+     * @brief Notified when keys were queued or the input thread stopped
+     *
+     */
+    condition_variable press_condition_;
+
+    /**
+     * @brief Written to by the destructor to wake the input thread up
+     *
+     */
+    int wakeup_pipe_[2];
+
+    /**
+     * @brief The terminal settings restored by the destructor
+     *
+     */
+    termios saved_terminal_;
+
+    /**
+     * @brief Whether stdin is a terminal that was put in raw mode
+     *
+     */
+    bool raw_ = false;
 
     /**
-     * @brief Thread used to continuously update the input state
+     * @brief Thread used to continuously update the input state, NULL when readKeys is called by an event loop
      *
      */
-    thread* input_thread_;
+    thread* input_thread_ = NULL;
 };
 
-#endif
\ No newline at end of file
+#endif
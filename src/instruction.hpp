@@ -0,0 +1,54 @@
+/**
+ * @file instruction.hpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Definition of a decoded CHIP-8 instruction
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef INSTRUCTION_HPP
+#define INSTRUCTION_HPP
+
+#include <iostream>
+
+/**
+ * @brief A 2 byte op code split into the operands used by the op code handlers
+ *
+ * Constructing an instruction from a raw op code decodes it, so op code handlers can be called with
+ * either a raw op code or an instruction that was decoded ahead of time.
+ */
+struct Instruction
+{
+    /**
+     * @brief Decodes a new Instruction from an op code
+     *
+     * @param op_code A 2 byte instruction
+     */
+    Instruction(uint16_t op_code=0)
+        : op_code(op_code),
+          nnn(op_code & 0x0FFF),
+          x((uint8_t)((op_code & 0x0F00) >> 8)),
+          y((uint8_t)((op_code & 0x00F0) >> 4)),
+          n((uint8_t)(op_code & 0x000F)),
+          nn((uint8_t)(op_code & 0x00FF)) { }
+
+    // The raw op code
+    uint16_t op_code;
+
+    // Lowest 12 bits, an address
+    uint16_t nnn;
+
+    // Index of the VX register
+    uint8_t x;
+
+    // Index of the VY register
+    uint8_t y;
+
+    // Lowest 4 bits
+    uint8_t n;
+
+    // Lowest 8 bits
+    uint8_t nn;
+};
+
+#endif
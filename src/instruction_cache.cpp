@@ -0,0 +1,171 @@
+/**
+ * @file instruction_cache.cpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Implementation of the cache holding pre-decoded instructions
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <iostream>
+#include <vector>
+#include "chip-8_state.hpp"
+#include "dispatch.hpp"
+#include "instruction.hpp"
+#include "instruction_cache.hpp"
+
+using namespace std;
+
+InstructionCache::InstructionCache(CHIP8_State* state) {
+    this->state_ = state;
+    this->micro_ops_.resize(state->memorySize() / 2);
+    this->invalidateAll();
+
+    this->state_->addMemoryListener(this);
+}
+
+InstructionCache::~InstructionCache() {
+    this->state_->removeMemoryListener(this);
+}
+
+void InstructionCache::onMemoryWrite(uint16_t address) {
+    // Both bytes of an even address instruction share the same slot.
+    // Instructions at odd addresses are never cached.
+    uint16_t slot = address >> 1;
+    if (slot >= this->micro_ops_.size()) {
+        return;
+    }
+    this->micro_ops_[slot].execute = NULL;
+
+    // Drop the sequences fused over the modified instruction
+    for (int distance = 1; distance < MAX_FUSED_LENGTH && distance <= slot; distance++) {
+        MicroOp& head = this->micro_ops_[slot - distance];
+        if (head.fused_length > distance) {
+            head.execute = NULL;
+        }
+    }
+}
+
+void InstructionCache::setQuirkProfile(QuirkProfile profile) {
+    // Cached entries point at the handlers of the previous profile
+    this->quirk_profile_ = profile;
+    this->invalidateAll();
+}
+
+QuirkProfile InstructionCache::quirkProfile() {
+    return this->quirk_profile_;
+}
+
+void InstructionCache::invalidateAll() {
+    for (MicroOp& micro_op : this->micro_ops_) {
+        micro_op.execute = NULL;
+    }
+}
+
+/**
+ * @brief Decodes the instruction stored at the provided address into a micro op
+ *
+ */
+static void _decodeInstruction(CHIP8_State* state, QuirkProfile profile, uint16_t address, MicroOp& micro_op) {
+    // All instructions are 2 bytes long and are stored most-significant-byte first.
+    uint8_t ms_op_code = state->memoryValue(address);
+    uint8_t ls_op_code = state->memoryValue(address + 1);
+    uint16_t op_code = ((uint16_t)ms_op_code << 8) | ls_op_code;
+
+    const OpCodeEntry& entry = OP_CODE_TABLE.lookup(op_code, profile);
+
+    micro_op.instruction = Instruction(op_code);
+    micro_op.refreshes_display = entry.refreshes_display;
+    micro_op.id = entry.id;
+    micro_op.fused = FUSED_NONE;
+    micro_op.fused_length = 1;
+    micro_op.execute = entry.execute;
+}
+
+const MicroOp& InstructionCache::decode(uint16_t address) {
+    uint16_t slot = address >> 1;
+    if ((address & 1) != 0 || slot >= this->micro_ops_.size()) {
+        _decodeInstruction(this->state_, this->quirk_profile_, address, this->uncached_);
+        return this->uncached_;
+    }
+
+    MicroOp& micro_op = this->decodeSlot(slot);
+    this->fuse(slot);
+    return micro_op;
+}
+
+MicroOp& InstructionCache::decodeSlot(uint16_t slot) {
+    MicroOp& micro_op = this->micro_ops_[slot];
+    _decodeInstruction(this->state_, this->quirk_profile_, slot << 1, micro_op);
+    return micro_op;
+}
+
+void InstructionCache::fuse(uint16_t slot) {
+    MicroOp& head = this->micro_ops_[slot];
+    uint16_t address = slot << 1;
+
+    // Decode the instructions following the head without caching them yet
+    MicroOp next[MAX_FUSED_LENGTH - 1];
+    int available = 0;
+    while (available < MAX_FUSED_LENGTH - 1 && slot + available + 1 < this->micro_ops_.size()) {
+        _decodeInstruction(this->state_, this->quirk_profile_, address + 2 * (available + 1), next[available]);
+        available++;
+    }
+
+    FusedOpId fused = FUSED_NONE;
+    int length = 1;
+    switch (head.id) {
+        case OP_3XNN:
+        case OP_4XNN:
+        case OP_5XY0:
+        case OP_9XY0:
+            if (available >= 1 && next[0].id == OP_1NNN) {
+                fused = FUSED_SKIP_JUMP;
+                length = 2;
+            }
+            break;
+        case OP_6XNN:
+            while (length - 1 < available && next[length - 1].id == OP_6XNN) {
+                length++;
+            }
+            if (length > 1) {
+                fused = FUSED_LOAD_CHAIN;
+            }
+            break;
+        case OP_ANNN:
+            if (available >= 1 && next[0].id == OP_DXYN) {
+                fused = FUSED_LOAD_DRAW;
+                length = 2;
+            }
+            break;
+        case OP_1NNN:
+            if (head.instruction.nnn == address) {
+                fused = FUSED_JUMP_SELF;
+            }
+            break;
+        case OP_FX07:
+            if (available >= 2
+                    && next[0].id == OP_3XNN && next[0].instruction.x == head.instruction.x
+                    && next[0].instruction.nn == 0
+                    && next[1].id == OP_1NNN && next[1].instruction.nnn == address) {
+                fused = FUSED_TIMER_WAIT;
+                length = 3;
+            }
+            break;
+        default:
+            break;
+    }
+
+    if (fused == FUSED_NONE) {
+        return;
+    }
+
+    // The fused handler reads the operands of the following instructions from their own entries
+    for (int i = 1; i < length; i++) {
+        if (this->micro_ops_[slot + i].execute == NULL) {
+            this->decodeSlot(slot + i);
+        }
+    }
+
+    head.fused = fused;
+    head.fused_length = (uint8_t)length;
+}
@@ -0,0 +1,186 @@
+/**
+ * @file instruction_cache.hpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Definition of the cache holding pre-decoded instructions for every address in memory
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef INSTRUCTION_CACHE_HPP
+#define INSTRUCTION_CACHE_HPP
+
+#include <iostream>
+#include <vector>
+#include "chip-8_state.hpp"
+#include "dispatch.hpp"
+#include "instruction.hpp"
+
+using namespace std;
+
+/**
+ * @brief Common instruction sequences executed as a single handler by the threaded interpreter
+ *
+ */
+enum FusedOpId : uint8_t {
+    // The instruction is executed on its own
+    FUSED_NONE,
+    // 3XNN, 4XNN, 5XY0 or 9XY0 followed by 1NNN, a conditional jump
+    FUSED_SKIP_JUMP,
+    // Consecutive 6XNN loads
+    FUSED_LOAD_CHAIN,
+    // ANNN followed by DXYN, drawing a sprite
+    FUSED_LOAD_DRAW,
+    // FX07, 3X00 and a 1NNN back to the FX07, waiting for the delay timer to run out
+    FUSED_TIMER_WAIT,
+    // 1NNN jumping to itself, used by ROMs to halt
+    FUSED_JUMP_SELF,
+    FUSED_OP_ID_COUNT
+};
+
+// Longest sequence of instructions covered by a fused entry
+static const int MAX_FUSED_LENGTH = 4;
+
+/**
+ * @brief An instruction decoded ahead of time, along with the handler used to execute it
+ *
+ * The first entry of a fused sequence describes the whole sequence, the entries following it in the cache
+ * hold the decoded operands of the remaining instructions.
+ */
+struct MicroOp {
+    // Function executing the instruction, NULL if the entry has not been decoded yet
+    OpCodeHandler execute;
+
+    // Identifies the op code family, used by the threaded interpreter to jump to its handler
+    OpCodeId id;
+
+    // The decoded operands of the instruction
+    Instruction instruction;
+
+    // True if the instruction modifies the display and a refresh is needed
+    bool refreshes_display;
+
+    // The sequence starting with this instruction, FUSED_NONE if it is executed on its own
+    FusedOpId fused;
+
+    // Number of instructions covered by the fused sequence
+    uint8_t fused_length;
+};
+
+/**
+ * @brief Cache holding one pre-decoded instruction for each even address in memory
+ *
+ * Entries are decoded the first time their address is executed and stay valid until the memory they were
+ * decoded from is modified, so ROMs that rewrite their own code are still executed correctly.
+ */
+class InstructionCache : public MemoryWriteListener
+{
+
+public:
+
+    /**
+     * @brief Construct a new Instruction Cache and start listening to memory writes on the state
+     *
+     * @param state The state instructions are fetched from
+     */
+    InstructionCache(CHIP8_State* state);
+
+    /**
+     * @brief Destroy the Instruction Cache object and stop listening to memory writes
+     *
+     */
+    ~InstructionCache();
+
+    /**
+     * @brief Fetches the decoded instruction stored at the provided address
+     *
+     * @param address The memory address of the instruction
+     * @return const MicroOp& The decoded instruction
+     */
+    inline const MicroOp& fetch(uint16_t address) {
+        uint16_t slot = address >> 1;
+        if ((address & 1) == 0 && slot < this->micro_ops_.size()) {
+            MicroOp& micro_op = this->micro_ops_[slot];
+            if (micro_op.execute != NULL) {
+                return micro_op;
+            }
+        }
+        return this->decode(address);
+    }
+
+    /**
+     * @brief Invalidates the instruction overlapping the modified address and the sequences fused over it
+     *
+     * @param address The memory address that was written to
+     */
+    virtual void onMemoryWrite(uint16_t address);
+
+    /**
+     * @brief Invalidates every decoded instruction
+     *
+     */
+    void invalidateAll();
+
+    /**
+     * @brief Selects the quirks reproduced by the handlers of the decoded instructions, invalidating every entry
+     *
+     * @param profile The quirks to reproduce
+     */
+    void setQuirkProfile(QuirkProfile profile);
+
+    /**
+     * @brief The quirks reproduced by the handlers of the decoded instructions
+     *
+     */
+    QuirkProfile quirkProfile();
+
+private:
+
+    /**
+     * @brief Decodes the instruction at the provided address, caching it if the address is even
+     *
+     * @param address The memory address of the instruction
+     * @return const MicroOp& The decoded instruction
+     */
+    const MicroOp& decode(uint16_t address);
+
+    /**
+     * @brief Decodes the instruction stored in a cache slot, without looking for a sequence to fuse
+     *
+     * @param slot Index of the entry, the instruction address divided by 2
+     * @return MicroOp& The decoded instruction
+     */
+    MicroOp& decodeSlot(uint16_t slot);
+
+    /**
+     * @brief Looks for a fusable sequence starting at a decoded entry and records it on the entry
+     *
+     * @param slot Index of the first entry of the sequence
+     */
+    void fuse(uint16_t slot);
+
+    /**
+     * @brief The state instructions are decoded from
+     *
+     */
+    CHIP8_State* state_;
+
+    /**
+     * @brief One entry per even memory address
+     *
+     */
+    vector<MicroOp> micro_ops_;
+
+    /**
+     * @brief Scratch entry used for instructions that cannot be cached, such as those at odd addresses
+     *
+     */
+    MicroOp uncached_;
+
+    /**
+     * @brief The quirks the handlers are looked up for
+     *
+     */
+    QuirkProfile quirk_profile_ = QuirkProfile::Modern;
+};
+
+#endif
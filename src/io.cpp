@@ -6,6 +6,8 @@
  * @copyright Copyright (c) 2020
  *
  */
+#include <dirent.h>
+#include <algorithm>
 #include <iostream>
 #include<iterator>
 #include <fstream>
@@ -31,4 +33,38 @@ vector<char>* ReadRom(string filename) {
     }
 
     throw "Could not load rom";
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Appends the path of every .ch8 file under a directory
+ *
+ */
+static void _findRoms(const string& directory, vector<string>* roms) {
+    DIR* dir = opendir(directory.c_str());
+    if (dir == NULL) {
+        return;
+    }
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        string name = string(entry->d_name);
+        if (name == "." || name == "..") {
+            continue;
+        }
+
+        string path = directory + "/" + name;
+        if (entry->d_type == DT_DIR) {
+            _findRoms(path, roms);
+        } else if (name.size() > 4 && name.substr(name.size() - 4) == ".ch8") {
+            roms->push_back(path);
+        }
+    }
+    closedir(dir);
+}
+
+vector<string>* FindRoms(string directory) {
+    vector<string>* roms = new vector<string>();
+    _findRoms(directory, roms);
+    sort(roms->begin(), roms->end());
+    return roms;
+}
@@ -9,6 +9,7 @@
  * @copyright Copyright (c) 2020
  *
  */
+#include<string>
 #include<vector>
 
 using namespace std;
@@ -21,4 +22,12 @@ using namespace std;
  */
 vector<char>* ReadRom(string filename);
 
+/**
+ * @brief Recursively lists every CHIP-8 Rom (.ch8 file) under a directory
+ *
+ * @param directory The directory to search
+ * @return vector<string>* Sorted paths of the ROMs found
+ */
+vector<string>* FindRoms(string directory);
+
 #endif
\ No newline at end of file
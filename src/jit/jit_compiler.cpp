@@ -0,0 +1,595 @@
+/**
+ * @file jit_compiler.cpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Implementation of the x86-64 basic block compiler used by the JIT execution mode
+ *
+ * Register usage while compiled code runs:
+ *   RBX - Base address of the V registers, VX is addressed as [RBX + X]
+ *   R12 - The JitContext
+ *   R13 - Remaining instruction budget
+ *   R15 - The index register I
+ * The program counter is never held in a register, every block knows its own address at compile time and the
+ * program counter is only written back to the state when compiled code exits or calls into the interpreter.
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <initializer_list>
+#include <iostream>
+#include <vector>
+#include "jit_compiler.hpp"
+#include "../chip-8_state.hpp"
+#include "../dispatch.hpp"
+#include "../instruction.hpp"
+#include "../input/input_interface.hpp"
+
+#if defined(__x86_64__) && (defined(__unix__) || defined(__APPLE__))
+#define JIT_SUPPORTED 1
+#include <sys/mman.h>
+#else
+#define JIT_SUPPORTED 0
+#endif
+
+using namespace std;
+
+// Size of the executable memory reserved by each compiler
+static const size_t JIT_CODE_SIZE = 1024 * 1024;
+
+// Longest run of instructions compiled into a single block
+static const int MAX_BLOCK_INSTRUCTIONS = 32;
+
+// Upper bound of the native code emitted for a single instruction
+static const int MAX_INSTRUCTION_BYTES = 96;
+
+/**
+ * @brief Called from compiled code to execute an instruction with the interpreter
+ *
+ */
+static int _jitFallback(JitContext* context, uint32_t op_code) {
+    return context->compiler->executeFallback((uint16_t)op_code);
+}
+
+#if JIT_SUPPORTED
+static uint8_t* _allocateCode(size_t size) {
+    // Writable until the code is emitted, never writable and executable at the same time
+    void* memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        return NULL;
+    }
+    return (uint8_t*)memory;
+}
+
+static bool _protectCode(uint8_t* code, size_t size, bool writable) {
+    return mprotect(code, size, writable ? PROT_READ | PROT_WRITE : PROT_READ | PROT_EXEC) == 0;
+}
+
+static void _releaseCode(uint8_t* code, size_t size) {
+    munmap(code, size);
+}
+#else
+static uint8_t* _allocateCode(size_t size) {
+    return NULL;
+}
+
+static bool _protectCode(uint8_t* code, size_t size, bool writable) {
+    return false;
+}
+
+static void _releaseCode(uint8_t* code, size_t size) { }
+#endif
+
+JitCompiler::JitCompiler(CHIP8_State* state, InputInterface* input, QuirkProfile profile) {
+    this->state_ = state;
+    this->input_ = input;
+
+    this->quirk_profile_ = profile;
+    this->shift_reads_vy_ = WithQuirks(profile, [](auto quirks) { return decltype(quirks)::SHIFT_READS_VY; });
+    this->logic_resets_vf_ = WithQuirks(profile, [](auto quirks) { return decltype(quirks)::LOGIC_RESETS_VF; });
+
+    this->context_.v_registers = state->data_->v_registers;
+    this->context_.index_register = &state->data_->index_register;
+    this->context_.program_counter = &state->data_->program_counter;
+    this->context_.budget = 0;
+    this->context_.compiler = this;
+
+    this->blocks_.resize(RAM_SIZE, NULL);
+    this->pending_links_.resize(RAM_SIZE);
+    this->compiled_memory_.resize(RAM_SIZE, false);
+
+    this->code_size_ = JIT_CODE_SIZE;
+    this->code_ = _allocateCode(this->code_size_);
+    this->code_pointer_ = this->code_;
+    if (this->code_ != NULL) {
+        this->emitStubs();
+        this->setWritable(false);
+    }
+
+    this->state_->addMemoryListener(this);
+}
+
+JitCompiler::~JitCompiler() {
+    this->state_->removeMemoryListener(this);
+
+    if (this->code_ != NULL) {
+        _releaseCode(this->code_, this->code_size_);
+    }
+}
+
+bool JitCompiler::isSupported() {
+    uint8_t* code = _allocateCode(4096);
+    if (code == NULL) {
+        return false;
+    }
+    bool executable = _protectCode(code, 4096, false);
+    _releaseCode(code, 4096);
+    return executable;
+}
+
+int JitCompiler::run(int budget, bool& refresh_display) {
+    this->context_.budget = budget;
+    this->draw_flag_ = false;
+
+    while (this->context_.budget > 0 && this->draw_flag_ == false) {
+        if (this->flush_pending_) {
+            this->flush();
+        }
+
+        uint16_t program_counter = this->state_->programCounter();
+
+        uint8_t* block = NULL;
+        if (program_counter + 1 < RAM_SIZE) {
+            block = this->blocks_[program_counter];
+            if (block == NULL) {
+                this->setWritable(true);
+                block = this->compileBlock(program_counter);
+                if (block == NULL) {
+                    // The code buffer is full, start over with an empty one
+                    this->flush();
+                    block = this->compileBlock(program_counter);
+                }
+                this->setWritable(false);
+            }
+        }
+
+        bool interpret = block == NULL;
+        if (block != NULL) {
+            int32_t budget_before = this->context_.budget;
+            this->enter_(&this->context_, block);
+
+            // The block is longer than the remaining budget, finish one instruction at a time
+            interpret = this->context_.budget == budget_before;
+        }
+
+        if (interpret) {
+            // Fetch and interpret the instruction the same way the interpreter would
+            uint8_t ms_op_code = this->state_->memoryValue(program_counter);
+            uint8_t ls_op_code = this->state_->memoryValue(program_counter + 1);
+            this->state_->setProgramCounter(program_counter + 2);
+            this->context_.budget--;
+            this->executeFallback(((uint16_t)ms_op_code << 8) | ls_op_code);
+        }
+
+        if (this->exception_) {
+            exception_ptr exception = this->exception_;
+            this->exception_ = nullptr;
+            rethrow_exception(exception);
+        }
+    }
+
+    refresh_display = this->draw_flag_;
+    return budget - this->context_.budget;
+}
+
+void JitCompiler::onMemoryWrite(uint16_t address) {
+    if (address < this->compiled_memory_.size() && this->compiled_memory_[address]) {
+        // Blocks cannot be discarded while they may still be running, they are dropped by run()
+        this->flush_pending_ = true;
+    }
+}
+
+int JitCompiler::executeFallback(uint16_t op_code) {
+    const OpCodeEntry& entry = OP_CODE_TABLE.lookup(op_code, this->quirk_profile_);
+
+    try {
+        entry.execute(this->state_, this->input_, Instruction(op_code));
+    } catch (...) {
+        // Exceptions cannot unwind through compiled code
+        this->exception_ = current_exception();
+        return 1;
+    }
+
+    if (entry.refreshes_display) {
+        this->draw_flag_ = true;
+    }
+
+    return (this->draw_flag_ || this->flush_pending_) ? 1 : 0;
+}
+
+uint8_t* JitCompiler::compileBlock(uint16_t address) {
+    if (this->code_ == NULL) {
+        return NULL;
+    }
+
+    size_t worst_case = MAX_BLOCK_INSTRUCTIONS * MAX_INSTRUCTION_BYTES + 64;
+    if (this->code_pointer_ + worst_case > this->code_ + this->code_size_) {
+        return NULL;
+    }
+
+    uint8_t* entry = this->code_pointer_;
+
+    // Return to the compiler when the block does not fit in the remaining budget
+    emit({0x41, 0x81, 0xFD});                       // cmp r13d, instruction_count
+    uint8_t* budget_check_field = this->code_pointer_;
+    emit32(0);
+    emit({0x7D, 0x0A});                             // jge +10
+    emit8(0xB8); emit32(address);                   // mov eax, address
+    emitJump(this->exit_stub_);                     // jmp exit
+    emit({0x41, 0x81, 0xED});                       // sub r13d, instruction_count
+    uint8_t* instruction_count_field = this->code_pointer_;
+    emit32(0);
+
+    int instruction_count = 0;
+    uint16_t program_counter = address;
+    bool block_ended = false;
+
+    while (block_ended == false) {
+        if (program_counter + 1 >= RAM_SIZE || instruction_count == MAX_BLOCK_INSTRUCTIONS) {
+            this->emitExit(program_counter);
+            break;
+        }
+
+        uint16_t op_code = ((uint16_t)this->state_->memoryValue(program_counter) << 8)
+            | this->state_->memoryValue(program_counter + 1);
+        Instruction instruction(op_code);
+        uint8_t x = instruction.x;
+        uint8_t y = instruction.y;
+        uint8_t nn = instruction.nn;
+
+        this->compiled_memory_[program_counter] = true;
+        this->compiled_memory_[program_counter + 1] = true;
+        instruction_count++;
+
+        uint16_t next = program_counter + 2;
+
+        switch (OP_CODE_TABLE.lookup(op_code).id) {
+            case OP_UNUSED:
+                break;
+
+            case OP_1NNN:
+                this->emitExit(instruction.nnn);
+                block_ended = true;
+                break;
+
+            case OP_2NNN:
+                // The interpreter pushes the return address, the target is known statically
+                this->emitFallback(program_counter, op_code);
+                this->emitExit(instruction.nnn);
+                block_ended = true;
+                break;
+
+            case OP_3XNN:
+            case OP_4XNN: {
+                emit({0x80, 0x7B, x, nn});                                  // cmp byte [rbx+x], nn
+                bool skip_if_equal = OP_CODE_TABLE.lookup(op_code).id == OP_3XNN;
+                emit({0x0F, (uint8_t)(skip_if_equal ? 0x85 : 0x84)});      // jne/je no_skip
+                uint8_t* no_skip = this->code_pointer_;
+                emit32(0);
+                this->emitExit(next + 2);
+                this->patchRel32(no_skip, this->code_pointer_);
+                this->emitExit(next);
+                block_ended = true;
+                break;
+            }
+
+            case OP_5XY0:
+            case OP_9XY0: {
+                emit({0x8A, 0x43, x});                                      // mov al, [rbx+x]
+                emit({0x3A, 0x43, y});                                      // cmp al, [rbx+y]
+                bool skip_if_equal = OP_CODE_TABLE.lookup(op_code).id == OP_5XY0;
+                emit({0x0F, (uint8_t)(skip_if_equal ? 0x85 : 0x84)});      // jne/je no_skip
+                uint8_t* no_skip = this->code_pointer_;
+                emit32(0);
+                this->emitExit(next + 2);
+                this->patchRel32(no_skip, this->code_pointer_);
+                this->emitExit(next);
+                block_ended = true;
+                break;
+            }
+
+            case OP_6XNN:
+                emit({0xC6, 0x43, x, nn});                                  // mov byte [rbx+x], nn
+                break;
+
+            case OP_7XNN:
+                emit({0x80, 0x43, x, nn});                                  // add byte [rbx+x], nn
+                break;
+
+            case OP_8XY0:
+                emit({0x8A, 0x43, y});                                      // mov al, [rbx+y]
+                emit({0x88, 0x43, x});                                      // mov [rbx+x], al
+                break;
+
+            case OP_8XY1:
+                emit({0x8A, 0x43, y});                                      // mov al, [rbx+y]
+                emit({0x08, 0x43, x});                                      // or [rbx+x], al
+                if (this->logic_resets_vf_) {
+                    emit({0xC6, 0x43, 0x0F, 0x00});                         // mov byte [rbx+0xF], 0
+                }
+                break;
+
+            case OP_8XY2:
+                emit({0x8A, 0x43, y});                                      // mov al, [rbx+y]
+                emit({0x20, 0x43, x});                                      // and [rbx+x], al
+                if (this->logic_resets_vf_) {
+                    emit({0xC6, 0x43, 0x0F, 0x00});                         // mov byte [rbx+0xF], 0
+                }
+                break;
+
+            case OP_8XY3:
+                emit({0x8A, 0x43, y});                                      // mov al, [rbx+y]
+                emit({0x30, 0x43, x});                                      // xor [rbx+x], al
+                if (this->logic_resets_vf_) {
+                    emit({0xC6, 0x43, 0x0F, 0x00});                         // mov byte [rbx+0xF], 0
+                }
+                break;
+
+            case OP_8XY4:
+                emit({0x0F, 0xB6, 0x43, x});                                // movzx eax, byte [rbx+x]
+                emit({0x0F, 0xB6, 0x4B, y});                                // movzx ecx, byte [rbx+y]
+                emit({0x01, 0xC8});                                         // add eax, ecx
+                emit({0x88, 0x43, x});                                      // mov [rbx+x], al
+                emit({0xC1, 0xE8, 0x08});                                   // shr eax, 8
+                emit({0x88, 0x43, 0x0F});                                   // mov [rbx+0xF], al
+                break;
+
+            case OP_8XY5:
+                emit({0x0F, 0xB6, 0x43, x});                                // movzx eax, byte [rbx+x]
+                emit({0x0F, 0xB6, 0x4B, y});                                // movzx ecx, byte [rbx+y]
+                emit({0x89, 0xC2});                                         // mov edx, eax
+                emit({0x29, 0xCA});                                         // sub edx, ecx
+                emit({0x88, 0x53, x});                                      // mov [rbx+x], dl
+                emit({0x39, 0xC8});                                         // cmp eax, ecx
+                emit({0x0F, 0x97, 0xC0});                                   // seta al
+                emit({0x88, 0x43, 0x0F});                                   // mov [rbx+0xF], al
+                break;
+
+            case OP_8XY6:
+                emit({0x0F, 0xB6, 0x43, this->shift_reads_vy_ ? y : x});  // movzx eax, byte [rbx+x or y]
+                emit({0x89, 0xC1});                                         // mov ecx, eax
+                emit({0x83, 0xE1, 0x01});                                   // and ecx, 1
+                emit({0x88, 0x4B, 0x0F});                                   // mov [rbx+0xF], cl
+                emit({0xD1, 0xE8});                                         // shr eax, 1
+                emit({0x88, 0x43, x});                                      // mov [rbx+x], al
+                break;
+
+            case OP_8XY7:
+                emit({0x0F, 0xB6, 0x43, x});                                // movzx eax, byte [rbx+x]
+                emit({0x0F, 0xB6, 0x4B, y});                                // movzx ecx, byte [rbx+y]
+                emit({0x39, 0xC1});                                         // cmp ecx, eax
+                emit({0x0F, 0x97, 0xC2});                                   // seta dl
+                emit({0x88, 0x53, 0x0F});                                   // mov [rbx+0xF], dl
+                emit({0x29, 0xC1});                                         // sub ecx, eax
+                emit({0x88, 0x4B, x});                                      // mov [rbx+x], cl
+                break;
+
+            case OP_8XYE:
+                emit({0x0F, 0xB6, 0x43, this->shift_reads_vy_ ? y : x});  // movzx eax, byte [rbx+x or y]
+                emit({0x89, 0xC1});                                         // mov ecx, eax
+                emit({0xC1, 0xE9, 0x07});                                   // shr ecx, 7
+                emit({0x88, 0x4B, 0x0F});                                   // mov [rbx+0xF], cl
+                emit({0x01, 0xC0});                                         // add eax, eax
+                emit({0x88, 0x43, x});                                      // mov [rbx+x], al
+                break;
+
+            case OP_ANNN:
+                emit({0x41, 0xBF}); emit32(instruction.nnn);               // mov r15d, nnn
+                break;
+
+            case OP_FX07:
+                emit({0x48, 0xB8}); emit64((uint64_t)&this->state_->data_->delay_timer);  // mov rax, &delay_timer
+                emit({0x8A, 0x00});                                         // mov al, [rax]
+                emit({0x88, 0x43, x});                                      // mov [rbx+x], al
+                break;
+
+            case OP_FX15:
+            case OP_FX18: {
+                uint8_t* timer = OP_CODE_TABLE.lookup(op_code).id == OP_FX15
+                    ? &this->state_->data_->delay_timer : &this->state_->data_->sound_timer;
+                emit({0x8A, 0x4B, x});                                      // mov cl, [rbx+x]
+                emit({0x48, 0xB8}); emit64((uint64_t)timer);               // mov rax, &timer
+                emit({0x88, 0x08});                                         // mov [rax], cl
+                break;
+            }
+
+            case OP_FX1E:
+                emit({0x0F, 0xB6, 0x43, x});                                // movzx eax, byte [rbx+x]
+                emit({0x41, 0x01, 0xC7});                                   // add r15d, eax
+                emit({0x41, 0x81, 0xE7}); emit32(0xFFFF);                  // and r15d, 0xFFFF
+                break;
+
+            case OP_CNNN:
+            case OP_FX29:
+            case OP_FX65:
+                // Interpreted, the block carries on afterwards
+                this->emitFallback(program_counter, op_code);
+                break;
+
+            case OP_00EE:
+            case OP_00FD:
+            case OP_FX0A:
+            case OP_F000:
+            case OP_5XY2:
+            case OP_5XY3:
+            case OP_BNNN:
+            case OP_EX9E:
+            case OP_EXA1:
+                // Interpreted, the next address is only known once the instruction ran
+                this->emitFallback(program_counter, op_code);
+                this->emitJump(this->dynamic_exit_stub_);
+                block_ended = true;
+                break;
+
+            default:
+                // Display, memory writing, blocking and unknown instructions are interpreted and end the block
+                this->emitFallback(program_counter, op_code);
+                this->emitExit(next);
+                block_ended = true;
+                break;
+        }
+
+        program_counter = next;
+    }
+
+    memcpy(budget_check_field, &instruction_count, sizeof(instruction_count));
+    memcpy(instruction_count_field, &instruction_count, sizeof(instruction_count));
+
+    this->blocks_[address] = entry;
+
+    // Chain every block that was waiting for this address
+    for (uint8_t* link : this->pending_links_[address]) {
+        this->patchRel32(link, entry);
+    }
+    this->pending_links_[address].clear();
+
+    return entry;
+}
+
+void JitCompiler::emitExit(uint16_t address) {
+    if (address < this->blocks_.size() && this->blocks_[address] != NULL) {
+        this->emitJump(this->blocks_[address]);
+        return;
+    }
+
+    emit8(0xB8); emit32(address);                   // mov eax, address
+    emit8(0xE9);                                    // jmp exit, patched once the address is compiled
+    uint8_t* link = this->code_pointer_;
+    emit32(0);
+    this->patchRel32(link, this->exit_stub_);
+
+    if (address < this->pending_links_.size()) {
+        this->pending_links_[address].push_back(link);
+    }
+}
+
+void JitCompiler::emitFallback(uint16_t address, uint16_t op_code) {
+    // The interpreter expects the program counter to already point at the next instruction
+    emit({0x48, 0xB8}); emit64((uint64_t)this->context_.program_counter);  // mov rax, &program_counter
+    emit({0x66, 0xC7, 0x00}); emit16(address + 2);                         // mov word [rax], address + 2
+    emit({0x48, 0xB8}); emit64((uint64_t)this->context_.index_register);   // mov rax, &index_register
+    emit({0x66, 0x44, 0x89, 0x38});                                         // mov [rax], r15w
+
+    emit({0x4C, 0x89, 0xE7});                                               // mov rdi, r12
+    emit8(0xBE); emit32(op_code);                                           // mov esi, op_code
+    emit({0x48, 0xB8}); emit64((uint64_t)&_jitFallback);                   // mov rax, _jitFallback
+    emit({0xFF, 0xD0});                                                     // call rax
+
+    emit({0x48, 0xB9}); emit64((uint64_t)this->context_.index_register);   // mov rcx, &index_register
+    emit({0x44, 0x0F, 0xB7, 0x39});                                         // movzx r15d, word [rcx]
+    emit({0x85, 0xC0});                                                     // test eax, eax
+    this->emitJumpIfNotZero(this->dynamic_exit_stub_);                      // jnz dynamic_exit
+}
+
+void JitCompiler::emitStubs() {
+    uint8_t budget_offset = (uint8_t)offsetof(JitContext, budget);
+    uint8_t v_registers_offset = (uint8_t)offsetof(JitContext, v_registers);
+    uint8_t index_register_offset = (uint8_t)offsetof(JitContext, index_register);
+    uint8_t program_counter_offset = (uint8_t)offsetof(JitContext, program_counter);
+
+    // void enter(JitContext* context, uint8_t* block)
+    this->enter_ = (void (*)(JitContext*, uint8_t*))this->code_pointer_;
+    emit({0x53, 0x55, 0x41, 0x54, 0x41, 0x55, 0x41, 0x56, 0x41, 0x57});  // push rbx, rbp, r12 - r15
+    emit({0x48, 0x83, 0xEC, 0x08});                                         // sub rsp, 8
+    emit({0x49, 0x89, 0xFC});                                               // mov r12, rdi
+    emit({0x49, 0x8B, 0x5C, 0x24, v_registers_offset});                     // mov rbx, [r12+v_registers]
+    emit({0x45, 0x8B, 0x6C, 0x24, budget_offset});                          // mov r13d, [r12+budget]
+    emit({0x49, 0x8B, 0x44, 0x24, index_register_offset});                  // mov rax, [r12+index_register]
+    emit({0x44, 0x0F, 0xB7, 0x38});                                         // movzx r15d, word [rax]
+    emit({0xFF, 0xE6});                                                     // jmp rsi
+
+    // Exit with the next program counter in EAX
+    this->exit_stub_ = this->code_pointer_;
+    emit({0x49, 0x8B, 0x4C, 0x24, program_counter_offset});                 // mov rcx, [r12+program_counter]
+    emit({0x66, 0x89, 0x01});                                               // mov [rcx], ax
+    emit({0x49, 0x8B, 0x4C, 0x24, index_register_offset});                  // mov rcx, [r12+index_register]
+    emit({0x66, 0x44, 0x89, 0x39});                                         // mov [rcx], r15w
+    emit({0x45, 0x89, 0x6C, 0x24, budget_offset});                          // mov [r12+budget], r13d
+    emit({0x48, 0x83, 0xC4, 0x08});                                         // add rsp, 8
+    emit({0x41, 0x5F, 0x41, 0x5E, 0x41, 0x5D, 0x41, 0x5C, 0x5D, 0x5B});  // pop r15 - r12, rbp, rbx
+    emit8(0xC3);                                                            // ret
+
+    // Exit with the program counter already stored in the state
+    this->dynamic_exit_stub_ = this->code_pointer_;
+    emit({0x49, 0x8B, 0x4C, 0x24, program_counter_offset});                 // mov rcx, [r12+program_counter]
+    emit({0x0F, 0xB7, 0x01});                                               // movzx eax, word [rcx]
+    this->emitJump(this->exit_stub_);                                       // jmp exit
+
+    this->blocks_start_ = this->code_pointer_;
+}
+
+void JitCompiler::setWritable(bool writable) {
+    if (this->code_ == NULL || this->writable_ == writable) {
+        return;
+    }
+    if (!_protectCode(this->code_, this->code_size_, writable)) {
+        throw "Could not change the protection of the JIT code buffer";
+    }
+    this->writable_ = writable;
+}
+
+void JitCompiler::flush() {
+    this->code_pointer_ = this->blocks_start_;
+    fill(this->blocks_.begin(), this->blocks_.end(), (uint8_t*)NULL);
+    fill(this->compiled_memory_.begin(), this->compiled_memory_.end(), false);
+    for (vector<uint8_t*>& links : this->pending_links_) {
+        links.clear();
+    }
+    this->flush_pending_ = false;
+}
+
+void JitCompiler::emit(std::initializer_list<uint8_t> bytes) {
+    for (uint8_t byte : bytes) {
+        *this->code_pointer_++ = byte;
+    }
+}
+
+void JitCompiler::emit8(uint8_t value) {
+    *this->code_pointer_++ = value;
+}
+
+void JitCompiler::emit16(uint16_t value) {
+    memcpy(this->code_pointer_, &value, sizeof(value));
+    this->code_pointer_ += sizeof(value);
+}
+
+void JitCompiler::emit32(uint32_t value) {
+    memcpy(this->code_pointer_, &value, sizeof(value));
+    this->code_pointer_ += sizeof(value);
+}
+
+void JitCompiler::emit64(uint64_t value) {
+    memcpy(this->code_pointer_, &value, sizeof(value));
+    this->code_pointer_ += sizeof(value);
+}
+
+void JitCompiler::emitJump(uint8_t* target) {
+    emit8(0xE9);                                    // jmp rel32
+    uint8_t* field = this->code_pointer_;
+    emit32(0);
+    this->patchRel32(field, target);
+}
+
+void JitCompiler::emitJumpIfNotZero(uint8_t* target) {
+    emit({0x0F, 0x85});                             // jnz rel32
+    uint8_t* field = this->code_pointer_;
+    emit32(0);
+    this->patchRel32(field, target);
+}
+
+void JitCompiler::patchRel32(uint8_t* field, uint8_t* target) {
+    // Displacements are relative to the end of the 4 byte field
+    int32_t displacement = (int32_t)(target - (field + 4));
+    memcpy(field, &displacement, sizeof(displacement));
+}
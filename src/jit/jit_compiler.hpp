@@ -0,0 +1,218 @@
+/**
+ * @file jit_compiler.hpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Definition of the x86-64 basic block compiler used by the JIT execution mode
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef JIT_COMPILER_HPP
+#define JIT_COMPILER_HPP
+
+#include <exception>
+#include <initializer_list>
+#include <iostream>
+#include <vector>
+#include "../chip-8_state.hpp"
+#include "../quirks.hpp"
+#include "../input/input_interface.hpp"
+
+using namespace std;
+
+class JitCompiler;
+
+/**
+ * @brief Values shared between compiled code and the compiler. Accessed from generated code by offset.
+ *
+ */
+struct JitContext {
+    // Base address of the V registers, pinned in RBX while compiled code runs
+    uint8_t* v_registers;
+
+    // Address of the index register, pinned in R15 while compiled code runs
+    uint16_t* index_register;
+
+    // Address of the program counter, written when compiled code exits
+    uint16_t* program_counter;
+
+    // Instructions left to run before returning, pinned in R13 while compiled code runs
+    int32_t budget;
+
+    // Compiler executing the instructions that are not compiled to native code
+    JitCompiler* compiler;
+};
+
+/**
+ * @brief Translates CHIP-8 basic blocks into native x86-64 code and runs them
+ *
+ * A block ends at the first jump, call, return, skip, display or memory writing instruction. Blocks with a
+ * static successor are chained together by patching their exit jump once the successor is compiled, so tight
+ * loops never leave native code until the instruction budget runs out. Instructions that need the input device,
+ * the display or the stack are executed by calling back into the interpreter handlers.
+ *
+ * Writing to memory holding compiled code discards every compiled block before execution resumes.
+ */
+class JitCompiler : public MemoryWriteListener
+{
+
+public:
+
+    /**
+     * @brief Construct a new Jit Compiler and start listening to memory writes on the state
+     *
+     * @param state The state compiled code operates on
+     * @param input Interface used by the instructions that read input
+     * @param profile (optional) The quirks reproduced by the compiled code and the interpreted instructions
+     */
+    JitCompiler(CHIP8_State* state, InputInterface* input, QuirkProfile profile = QuirkProfile::Modern);
+
+    /**
+     * @brief Destroy the Jit Compiler object and release its code buffer
+     *
+     */
+    ~JitCompiler();
+
+    /**
+     * @brief Whether native code can be generated on this platform
+     *
+     * @return true If the host is x86-64 and executable memory can be allocated
+     */
+    static bool isSupported();
+
+    /**
+     * @brief Runs compiled code until the provided number of instructions were executed
+     *
+     * Returns early after any instruction modifying the display, so the display can be refreshed. Blocks longer
+     * than the remaining budget are interpreted one instruction at a time so the budget is never exceeded.
+     *
+     * @param budget The number of instructions to execute
+     * @param refresh_display Set to true if the display must be refreshed
+     * @return int The number of instructions executed
+     */
+    int run(int budget, bool& refresh_display);
+
+    /**
+     * @brief Marks the compiled code as stale if the address was compiled
+     *
+     * @param address The memory address that was written to
+     */
+    virtual void onMemoryWrite(uint16_t address);
+
+    /**
+     * @brief Executes a single instruction with the interpreter on behalf of compiled code
+     *
+     * @param op_code The op code to execute
+     * @return int 0 to continue running compiled code, 1 if compiled code must return to the compiler
+     */
+    int executeFallback(uint16_t op_code);
+
+private:
+
+    /**
+     * @brief Compiles the basic block starting at the provided address
+     *
+     * @param address Address of the first instruction
+     * @return uint8_t* Entry point of the block, NULL if the code buffer is full
+     */
+    uint8_t* compileBlock(uint16_t address);
+
+    /**
+     * @brief Emits an exit to a statically known address, chaining to its block when compiled
+     *
+     * @param address The address execution continues at
+     */
+    void emitExit(uint16_t address);
+
+    /**
+     * @brief Emits a call to executeFallback for the provided op code
+     *
+     * @param address Address of the instruction
+     * @param op_code The op code executed by the interpreter
+     */
+    void emitFallback(uint16_t address, uint16_t op_code);
+
+    /**
+     * @brief Emits the code shared by every block, used to enter and leave compiled code
+     *
+     */
+    void emitStubs();
+
+    /**
+     * @brief Discards all compiled blocks
+     *
+     */
+    void flush();
+
+    /**
+     * @brief Switches the code buffer between writable and executable, it is never both
+     *
+     * @param writable True while code is emitted or patched, false while it runs
+     */
+    void setWritable(bool writable);
+
+    // Helpers writing into the code buffer
+    void emit(std::initializer_list<uint8_t> bytes);
+    void emit8(uint8_t value);
+    void emit16(uint16_t value);
+    void emit32(uint32_t value);
+    void emit64(uint64_t value);
+    void emitJump(uint8_t* target);
+    void emitJumpIfNotZero(uint8_t* target);
+    void patchRel32(uint8_t* field, uint8_t* target);
+
+    CHIP8_State* state_;
+
+    InputInterface* input_;
+
+    QuirkProfile quirk_profile_;
+
+    // Quirks changing the native code emitted for the register instructions
+    bool shift_reads_vy_;
+    bool logic_resets_vf_;
+
+    JitContext context_;
+
+    // Executable memory holding the stubs and compiled blocks
+    uint8_t* code_;
+
+    // Whether the code buffer is currently writable instead of executable
+    bool writable_ = true;
+
+    // Size of the executable memory
+    size_t code_size_;
+
+    // Next free byte in the code buffer
+    uint8_t* code_pointer_;
+
+    // First byte after the shared stubs
+    uint8_t* blocks_start_;
+
+    // Enters compiled code: void enter(JitContext* context, uint8_t* block)
+    void (*enter_)(JitContext* context, uint8_t* block);
+
+    // Leaves compiled code, with the next program counter in EAX
+    uint8_t* exit_stub_;
+
+    // Leaves compiled code, with the next program counter read from the state
+    uint8_t* dynamic_exit_stub_;
+
+    // Entry point of the compiled block for each address, NULL if not compiled
+    vector<uint8_t*> blocks_;
+
+    // Unpatched jumps to each address, chained once a block is compiled for it
+    vector<vector<uint8_t*>> pending_links_;
+
+    // True for every address read while compiling a block
+    vector<bool> compiled_memory_;
+
+    // Set when compiled memory was written to and the blocks must be discarded
+    bool flush_pending_ = false;
+
+    // Set when an instruction executed by the interpreter modified the display
+    bool draw_flag_ = false;
+
+    // Exception thrown by an instruction executed by the interpreter, rethrown outside of compiled code
+    exception_ptr exception_;
+};
+
+#endif
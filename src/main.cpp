@@ -1,15 +1,102 @@
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
 #include <iostream>
 #include <fstream>
 #include <string>
 
 #include "chip-8.hpp"
+#include "event_loop.hpp"
+#include "headless.hpp"
 #include "io.hpp"
+#include "input/scripted_input.hpp"
 #include "input/terminal_input.hpp"
+#include "display/ansi_display.hpp"
+#include "display/null_display.hpp"
+#include "display/render_thread.hpp"
 #include "display/terminal_display.hpp"
 #include "display/mock_display.hpp"
 
 using namespace std;
 
+// Number of frames run headless when no budget is provided, 10 seconds of emulated time
+static const long DEFAULT_HEADLESS_FRAMES = 600;
+
+/**
+ * @brief Runs a ROM without display, then prints a summary of the run
+ *
+ * @return int The exit code of the executable
+ */
+int RunHeadlessRom(CHIP8* chip_8, ScriptedInput* input, const HeadlessOptions& options) {
+    HeadlessReport report;
+    try {
+        report = RunHeadless(chip_8, input, options);
+    } catch (exception& e) {
+        cout << "error: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "instructions: " << report.instructions << endl;
+    cout << "frames: " << report.frames << endl;
+    cout << "idle_instructions: " << report.idle_instructions << endl;
+    cout << "draws: " << report.draws << endl;
+    cout << "seconds: " << fixed << setprecision(6) << report.seconds << endl;
+    cout << "instructions_per_second: " << fixed << setprecision(0) << report.instructionsPerSecond() << endl;
+    cout << "display_hash: " << hex << setw(16) << setfill('0') << report.display_hash << dec << endl;
+    if (!options.turbo) {
+        cout << "mean_jitter_us: " << fixed << setprecision(1) << report.mean_jitter_us << endl;
+        cout << "max_jitter_us: " << fixed << setprecision(1) << report.max_jitter_us << endl;
+        cout << "dropped_frames: " << report.dropped_frames << endl;
+    }
+    return 0;
+}
+
+/**
+ * @brief Prints the command line options
+ *
+ */
+void PrintUsage() {
+    cout << "Usage: chip-8 [--threaded | --jit] [--xo-chip] [--quirks vip|chip48|schip|modern|xo-chip] [--seed <number>] [--ansi] [--glyphs full|half|braille] [--instructions-per-frame <count>] [--no-idle-skip]"
+         << " [--present draw|vblank|clear] [--no-event-loop] [--no-render-thread] [--key-hold <milliseconds>] <rom>" << endl;
+    cout << "       chip-8 --headless [--turbo] [--instructions <count>] [--frames <count>] [--input <script>]"
+         << " [--present draw|vblank|clear] [--threaded | --jit] [--xo-chip] [--quirks <profile>] [--seed <number>] <rom>" << endl;
+}
+
+/**
+ * @brief Reads a count given on the command line
+ *
+ * @param text The argument, a decimal number
+ * @param value Receives the count
+ * @return true The whole argument is a number greater than 0
+ */
+bool ParseCount(const char* text, long& value) {
+    char* end = NULL;
+    errno = 0;
+    long parsed = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || parsed <= 0) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+/**
+ * @brief The quirks of the machine a loaded ROM was written for, used when none were requested
+ *
+ * @return QuirkProfile XO-CHIP for XO-CHIP states, the COSMAC VIP for its two page hires ROMs, modern otherwise
+ */
+QuirkProfile DetectQuirkProfile(CHIP8_State* state) {
+    if (state->xoChip()) {
+        return QuirkProfile::XOChip;
+    }
+    if (state->displayMode() == DisplayMode::VipHires) {
+        return QuirkProfile::Vip;
+    }
+    return QuirkProfile::Modern;
+}
+
 /**
  * @brief Main executable entry point
  *
@@ -17,22 +104,237 @@ using namespace std;
  */
 int main(int argc, char** argv){
 
-    if (argc < 2)
+    string rom_path;
+    string script_path;
+    ExecutionMode mode = ExecutionMode::Interpreter;
+    bool headless = false;
+    HeadlessOptions options;
+    int instructions_per_frame = INSTRUCTIONS_PER_TIMER_TICK;
+    bool idle_loop_skipping = true;
+    bool ansi = false;
+    bool render_thread = true;
+    bool event_loop = true;
+    bool xo_chip = false;
+    bool quirks_requested = false;
+    uint64_t seed = DEFAULT_RANDOM_SEED;
+    QuirkProfile quirks = QuirkProfile::Modern;
+    chrono::milliseconds key_hold_time = TerminalInput::DEFAULT_KEY_HOLD_TIME;
+    PresentationMode presentation = PresentationMode::VBlank;
+    AnsiGlyphs glyphs = AnsiGlyphs::FullBlock;
+    for (int i = 1; i < argc; i++) {
+        string argument = string(argv[i]);
+        if (argument == "--jit") {
+            mode = ExecutionMode::Jit;
+        } else if (argument == "--threaded") {
+            mode = ExecutionMode::Threaded;
+        } else if (argument == "--headless") {
+            headless = true;
+        } else if (argument == "--turbo") {
+            options.turbo = true;
+        } else if (argument == "--instructions" && i + 1 < argc) {
+            if (!ParseCount(argv[++i], options.instructions)) {
+                cout << "Invalid instruction count " << argv[i] << endl;
+                PrintUsage();
+                return -1;
+            }
+        } else if (argument == "--frames" && i + 1 < argc) {
+            if (!ParseCount(argv[++i], options.frames)) {
+                cout << "Invalid frame count " << argv[i] << endl;
+                PrintUsage();
+                return -1;
+            }
+        } else if (argument == "--instructions-per-frame" && i + 1 < argc) {
+            long count;
+            if (!ParseCount(argv[++i], count) || count > INT_MAX) {
+                cout << "Invalid instructions per frame " << argv[i] << endl;
+                PrintUsage();
+                return -1;
+            }
+            instructions_per_frame = (int)count;
+        } else if (argument == "--ansi") {
+            ansi = true;
+        } else if (argument == "--glyphs" && i + 1 < argc) {
+            // Compact glyphs are only drawn by the ANSI display
+            string name = string(argv[++i]);
+            ansi = true;
+            if (name == "half") {
+                glyphs = AnsiGlyphs::HalfBlock;
+            } else if (name == "braille") {
+                glyphs = AnsiGlyphs::Braille;
+            } else if (name == "full") {
+                glyphs = AnsiGlyphs::FullBlock;
+            } else {
+                cout << "Unknown glyphs " << name << endl;
+                PrintUsage();
+                return -1;
+            }
+        } else if (argument == "--present" && i + 1 < argc) {
+            string name = string(argv[++i]);
+            if (name == "draw") {
+                presentation = PresentationMode::EveryDraw;
+            } else if (name == "clear") {
+                presentation = PresentationMode::Clear;
+            } else if (name == "vblank") {
+                presentation = PresentationMode::VBlank;
+            } else {
+                cout << "Unknown presentation mode " << name << endl;
+                PrintUsage();
+                return -1;
+            }
+        } else if (argument == "--xo-chip") {
+            xo_chip = true;
+        } else if (argument == "--quirks" && i + 1 < argc) {
+            string name = string(argv[++i]);
+            if (!ParseQuirkProfile(name, quirks)) {
+                cout << "Unknown quirk profile " << name << endl;
+                PrintUsage();
+                return -1;
+            }
+            quirks_requested = true;
+        } else if (argument == "--seed" && i + 1 < argc) {
+            // Any 64 bit number, in decimal or with a 0x prefix in hexadecimal
+            const char* text = argv[++i];
+            char* end = NULL;
+            errno = 0;
+            seed = strtoull(text, &end, 0);
+            if (end == text || *end != '\0' || errno == ERANGE || text[0] == '-') {
+                cout << "Invalid seed " << text << endl;
+                PrintUsage();
+                return -1;
+            }
+        } else if (argument == "--key-hold" && i + 1 < argc) {
+            // Keys held for no time at all would be released at every frame
+            long milliseconds;
+            if (!ParseCount(argv[++i], milliseconds)) {
+                cout << "Invalid key hold time " << argv[i] << endl;
+                PrintUsage();
+                return -1;
+            }
+            key_hold_time = chrono::milliseconds(milliseconds);
+        } else if (argument == "--no-event-loop") {
+            event_loop = false;
+        } else if (argument == "--no-render-thread") {
+            render_thread = false;
+        } else if (argument == "--no-idle-skip") {
+            idle_loop_skipping = false;
+        } else if (argument == "--input" && i + 1 < argc) {
+            script_path = string(argv[++i]);
+        } else {
+            rom_path = argument;
+        }
+    }
+
+    if (rom_path.empty())
     {
         cout << "A ROM file path must be supplied" << endl;
+        PrintUsage();
         return -1;
     }
 
-    TerminalDisplay* display = new TerminalDisplay();
-    TerminalInput* input = new TerminalInput(display->getWindow());
+    // Load supplied rom
+    vector<char>* rom_data = ReadRom(rom_path);
 
-    CHIP8* chip_8 = new CHIP8(display, input);
+    // Only XO-CHIP programs get the 64KB memory and the second display plane, they always run interpreted
+    if (rom_path.size() > 4 && rom_path.compare(rom_path.size() - 4, 4, ".xo8") == 0) {
+        xo_chip = true;
+    }
+    CHIP8_State* state = new CHIP8_State();
+    state->seedRandom(seed);
+    if (xo_chip) {
+        state->enableXOChip();
+    }
+
+    if (headless) {
+        ScriptedInput* input = new ScriptedInput();
+        if (!script_path.empty()) {
+            ifstream script(script_path);
+            if (!script) {
+                cout << "Could not read input script " << script_path << endl;
+                return -1;
+            }
+            try {
+                input->loadScript(script);
+            } catch (exception& e) {
+                cout << "error: " << e.what() << endl;
+                return -1;
+            }
+        }
+        if (options.instructions <= 0 && options.frames <= 0) {
+            options.frames = DEFAULT_HEADLESS_FRAMES;
+        }
+
+        NullDisplay* display = new NullDisplay();
+        CHIP8* chip_8 = new CHIP8(display, input, state);
+        chip_8->SetExecutionMode(mode);
+        chip_8->SetInstructionsPerFrame(instructions_per_frame);
+        chip_8->SetIdleLoopSkipping(idle_loop_skipping);
+        chip_8->SetPresentationMode(presentation);
+        chip_8->LoadRom(rom_data);
+        chip_8->SetQuirkProfile(quirks_requested ? quirks : DetectQuirkProfile(state));
+
+        int result = RunHeadlessRom(chip_8, input, options);
+
+        delete chip_8;
+        delete state;
+        delete display;
+        delete input;
+        delete rom_data;
+        return result;
+    }
+
+    // The event loop runs emulation, input and presentation from this thread alone
+    event_loop = event_loop && EventLoop::isSupported();
+
+    DisplayInterface* screen;
+    TerminalInput* input;
+    if (ansi) {
+        // Output bypasses ncurses, which is only set up for keyboard input and never refreshed
+        setlocale(LC_ALL, "");
+        initscr();
+        input = new TerminalInput(newwin(1, 1, 0, 0), key_hold_time, !event_loop);
+        screen = new AnsiDisplay(STDOUT_FILENO, glyphs);
+    } else {
+        TerminalDisplay* terminal_display = new TerminalDisplay();
+        input = new TerminalInput(terminal_display->getWindow(), key_hold_time, !event_loop);
+        screen = terminal_display;
+    }
+
+    // Emulation never waits on the terminal, frames are presented from a separate thread
+    DisplayInterface* display = screen;
+    if (render_thread && !event_loop) {
+        display = new RenderThread(screen);
+    }
+
+    CHIP8* chip_8 = new CHIP8(display, input, state);
+    chip_8->SetExecutionMode(mode);
+    chip_8->SetInstructionsPerFrame(instructions_per_frame);
+    chip_8->SetIdleLoopSkipping(idle_loop_skipping);
+    chip_8->SetPresentationMode(presentation);
 
-    // Load supplied rom
-    vector<char>* rom_data = ReadRom(string(argv[1]));
     chip_8->LoadRom(rom_data);
-    chip_8->Start();
+    chip_8->SetQuirkProfile(quirks_requested ? quirks : DetectQuirkProfile(state));
+    if (event_loop) {
+        // Runs until the program exits or is interrupted
+        EventLoop loop(chip_8);
+        loop.addInput(STDIN_FILENO, [input]() {
+            return input->readKeys();
+        });
+        loop.run();
+    } else {
+        chip_8->Start();
+    }
 
+    // The input restores the terminal settings it changed before ncurses restores its own
     delete chip_8;
+    delete input;
+    if (display != screen) {
+        delete display;
+    }
+    delete screen;
+    if (ansi) {
+        endwin();
+    }
+    delete state;
+    delete rom_data;
     return 0;
-}
\ No newline at end of file
+}
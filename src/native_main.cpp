@@ -0,0 +1,48 @@
+#include <iostream>
+#include <unistd.h>
+
+#include "chip-8.hpp"
+#include "event_loop.hpp"
+#include "recompiled_program.hpp"
+#include "input/terminal_input.hpp"
+#include "display/terminal_display.hpp"
+
+using namespace std;
+
+// Defined by the source generated with chip-8-recompile
+extern const RecompiledRom RECOMPILED_ROM;
+
+/**
+ * @brief Entry point of the executables built around a single recompiled ROM
+ *
+ * @return int
+ */
+int main(int argc, char** argv){
+
+    // The event loop runs emulation, input and presentation from this thread alone
+    bool event_loop = EventLoop::isSupported();
+
+    TerminalDisplay* display = new TerminalDisplay();
+    TerminalInput* input = new TerminalInput(
+        display->getWindow(), TerminalInput::DEFAULT_KEY_HOLD_TIME, !event_loop);
+
+    CHIP8* chip_8 = new CHIP8(display, input);
+    chip_8->LoadRecompiledRom(&RECOMPILED_ROM);
+    chip_8->SetExecutionMode(ExecutionMode::Recompiled);
+    if (event_loop) {
+        // Runs until the program exits or is interrupted
+        EventLoop loop(chip_8);
+        loop.addInput(STDIN_FILENO, [input]() {
+            return input->readKeys();
+        });
+        loop.run();
+    } else {
+        chip_8->Start();
+    }
+
+    // The input restores the terminal settings it changed before ncurses restores its own
+    delete chip_8;
+    delete input;
+    delete display;
+    return 0;
+}
@@ -14,24 +14,13 @@
 #include <math.h>
 #include "chip-8_state.hpp"
 #include "exceptions.hpp"
+#include "instruction.hpp"
 #include "op_codes.hpp"
 #include "input/input_interface.hpp"
 #include "display/display_interface.hpp"
 
-uint8_t _getVxIndex(uint16_t op_code) {
-    return (uint8_t)((op_code & 0x0F00) >> 8);
-}
-
-uint8_t _getVyIndex(uint16_t op_code) {
-    return (uint8_t)((op_code & 0x00F0) >> 4);
-}
-
 int Execute00E0(CHIP8_State* state) {
-    for (int j = 0; j < DISPLAY_HEIGHT; j++) {
-        for (int i = 0; i < DISPLAY_WIDTH; i++) {
-            state->setDisplayValue(i, j, false);
-        }
-    }
+    state->clearDisplay();
 
     return DEFAULT_OP_CYCLES;
 }
@@ -43,17 +32,17 @@ int Execute00EE(CHIP8_State* state) {
     return DEFAULT_OP_CYCLES;
 }
 
-int Execute1NNN(CHIP8_State* state, uint16_t op_code) {
+int Execute1NNN(CHIP8_State* state, const Instruction& instruction) {
     // 1NNN - Jump to addres NNN
-    int16_t jump_address = op_code & 0x0FFF;
+    int16_t jump_address = instruction.nnn;
     state->setProgramCounter(jump_address);
 
     return DEFAULT_OP_CYCLES;
 }
 
-int Execute2NNN(CHIP8_State* state, uint16_t op_code) {
+int Execute2NNN(CHIP8_State* state, const Instruction& instruction) {
 
-    int16_t sub_routine = op_code & 0x0FFF;
+    int16_t sub_routine = instruction.nnn;
     int16_t current_pc = state->programCounter();
 
     // Push the current PC onto the call stack
@@ -64,57 +53,57 @@ int Execute2NNN(CHIP8_State* state, uint16_t op_code) {
     return DEFAULT_OP_CYCLES;
 }
 
-int Execute3XNN(CHIP8_State* state, uint16_t op_code) {
+int Execute3XNN(CHIP8_State* state, const Instruction& instruction) {
 
-    uint8_t vx_index = _getVxIndex(op_code);
+    uint8_t vx_index = instruction.x;
     uint8_t vx = state->vRegister(vx_index);
-    uint8_t nn = (uint8_t)(op_code & 0x00FF);
+    uint8_t nn = instruction.nn;
     if (vx == nn) {
-        state->setProgramCounter(state->programCounter() + 2);
+        state->skipInstruction();
     }
 
     return DEFAULT_OP_CYCLES;
 }
 
-int Execute4XNN(CHIP8_State* state, uint16_t op_code) {
+int Execute4XNN(CHIP8_State* state, const Instruction& instruction) {
 
-    uint8_t vx_index = _getVxIndex(op_code);
+    uint8_t vx_index = instruction.x;
     uint8_t vx = state->vRegister(vx_index);
-    uint8_t nn = (uint8_t)(op_code & 0x00FF);
+    uint8_t nn = instruction.nn;
     if (vx != nn) {
-        state->setProgramCounter(state->programCounter() + 2);
+        state->skipInstruction();
     }
 
     return DEFAULT_OP_CYCLES;
 }
 
-int Execute5XY0(CHIP8_State* state, uint16_t op_code) {
+int Execute5XY0(CHIP8_State* state, const Instruction& instruction) {
 
-    uint8_t vx_index = _getVxIndex(op_code);
-    uint8_t vy_index = _getVyIndex(op_code);
+    uint8_t vx_index = instruction.x;
+    uint8_t vy_index = instruction.y;
 
     uint8_t vx = state->vRegister(vx_index);
     uint8_t vy = state->vRegister(vy_index);
     if (vx == vy) {
-        state->setProgramCounter(state->programCounter() + 2);
+        state->skipInstruction();
     }
 
     return DEFAULT_OP_CYCLES;
 }
 
-int Execute6XNN(CHIP8_State* state, uint16_t op_code) {
+int Execute6XNN(CHIP8_State* state, const Instruction& instruction) {
 
-    uint8_t vx_index = _getVxIndex(op_code);
-    uint8_t nn = (uint8_t)(op_code & 0x00FF);
+    uint8_t vx_index = instruction.x;
+    uint8_t nn = instruction.nn;
     state->setVRegister(vx_index, nn);
 
     return DEFAULT_OP_CYCLES;
 }
 
-int Execute7XNN(CHIP8_State* state, uint16_t op_code) {
+int Execute7XNN(CHIP8_State* state, const Instruction& instruction) {
 
-    uint8_t nn = (uint8_t)(op_code & 0x00FF);
-    uint8_t vx_index = _getVxIndex(op_code);
+    uint8_t nn = instruction.nn;
+    uint8_t vx_index = instruction.x;
     uint8_t vx = state->vRegister(vx_index) + nn;
 
     state->setVRegister(vx_index, vx);
@@ -122,10 +111,10 @@ int Execute7XNN(CHIP8_State* state, uint16_t op_code) {
     return DEFAULT_OP_CYCLES;
 }
 
-int Execute8XY0(CHIP8_State* state, uint16_t op_code) {
+int Execute8XY0(CHIP8_State* state, const Instruction& instruction) {
 
-    uint8_t vx_index = _getVxIndex(op_code);
-    uint8_t vy_index = _getVyIndex(op_code);
+    uint8_t vx_index = instruction.x;
+    uint8_t vy_index = instruction.y;
     uint8_t vy = state->vRegister(vy_index);
 
     state->setVRegister(vx_index, vy);
@@ -133,50 +122,62 @@ int Execute8XY0(CHIP8_State* state, uint16_t op_code) {
     return DEFAULT_OP_CYCLES;
 }
 
-int Execute8XY1(CHIP8_State* state, uint16_t op_code) {
+template <typename Quirks>
+int Execute8XY1(CHIP8_State* state, const Instruction& instruction) {
 
-    uint8_t vx_index = _getVxIndex(op_code);
+    uint8_t vx_index = instruction.x;
     uint8_t vx = state->vRegister(vx_index);
 
-    uint8_t vy_index = _getVyIndex(op_code);
+    uint8_t vy_index = instruction.y;
     uint8_t vy = state->vRegister(vy_index);
 
     state->setVRegister(vx_index, (vx | vy));
+    if (Quirks::LOGIC_RESETS_VF) {
+        state->setVRegister(REGISTER_VF, 0);
+    }
 
     return DEFAULT_OP_CYCLES;
 }
 
-int Execute8XY2(CHIP8_State* state, uint16_t op_code) {
+template <typename Quirks>
+int Execute8XY2(CHIP8_State* state, const Instruction& instruction) {
 
-    uint8_t vx_index = _getVxIndex(op_code);
+    uint8_t vx_index = instruction.x;
     uint8_t vx = state->vRegister(vx_index);
 
-    uint8_t vy_index = _getVyIndex(op_code);
+    uint8_t vy_index = instruction.y;
     uint8_t vy = state->vRegister(vy_index);
 
     state->setVRegister(vx_index, (vx & vy));
+    if (Quirks::LOGIC_RESETS_VF) {
+        state->setVRegister(REGISTER_VF, 0);
+    }
 
     return DEFAULT_OP_CYCLES;
 }
 
-int Execute8XY3(CHIP8_State* state, uint16_t op_code) {
+template <typename Quirks>
+int Execute8XY3(CHIP8_State* state, const Instruction& instruction) {
 
-    uint8_t vx_index = _getVxIndex(op_code);
+    uint8_t vx_index = instruction.x;
     uint8_t vx = state->vRegister(vx_index);
 
-    uint8_t vy_index = _getVyIndex(op_code);
+    uint8_t vy_index = instruction.y;
     uint8_t vy = state->vRegister(vy_index);
 
     state->setVRegister(vx_index, (vx ^ vy));
+    if (Quirks::LOGIC_RESETS_VF) {
+        state->setVRegister(REGISTER_VF, 0);
+    }
 
     return DEFAULT_OP_CYCLES;
 }
 
-int Execute8XY4(CHIP8_State* state, uint16_t op_code) {
-    uint8_t vx_index = _getVxIndex(op_code);
+int Execute8XY4(CHIP8_State* state, const Instruction& instruction) {
+    uint8_t vx_index = instruction.x;
     uint8_t vx = state->vRegister(vx_index);
 
-    uint8_t vy_index = _getVyIndex(op_code);
+    uint8_t vy_index = instruction.y;
     uint8_t vy = state->vRegister(vy_index);
 
     // Add and save into 16bit to catch carry
@@ -195,11 +196,11 @@ int Execute8XY4(CHIP8_State* state, uint16_t op_code) {
     return DEFAULT_OP_CYCLES;
 }
 
-int Execute8XY5(CHIP8_State* state, uint16_t op_code) {
-    uint8_t vx_index = _getVxIndex(op_code);
+int Execute8XY5(CHIP8_State* state, const Instruction& instruction) {
+    uint8_t vx_index = instruction.x;
     uint8_t vx = state->vRegister(vx_index);
 
-    uint8_t vy_index = _getVyIndex(op_code);
+    uint8_t vy_index = instruction.y;
     uint8_t vy = state->vRegister(vy_index);
 
     uint8_t difference = vx - vy;
@@ -218,9 +219,10 @@ int Execute8XY5(CHIP8_State* state, uint16_t op_code) {
     return DEFAULT_OP_CYCLES;
 }
 
-int Execute8XY6(CHIP8_State* state, uint16_t op_code) {
-    uint8_t vx_index = _getVxIndex(op_code);
-    uint8_t vx = state->vRegister(vx_index);
+template <typename Quirks>
+int Execute8XY6(CHIP8_State* state, const Instruction& instruction) {
+    uint8_t vx_index = instruction.x;
+    uint8_t vx = state->vRegister(Quirks::SHIFT_READS_VY ? instruction.y : vx_index);
 
     state->setVRegister(REGISTER_VF, vx & 0b0000'0001);
     state->setVRegister(vx_index, uint8_t(vx >> 1));
@@ -228,11 +230,11 @@ int Execute8XY6(CHIP8_State* state, uint16_t op_code) {
     return DEFAULT_OP_CYCLES;
 }
 
-int Execute8XY7(CHIP8_State* state, uint16_t op_code) {
-    uint8_t vx_index = _getVxIndex(op_code);
+int Execute8XY7(CHIP8_State* state, const Instruction& instruction) {
+    uint8_t vx_index = instruction.x;
     uint8_t vx = state->vRegister(vx_index);
 
-    uint8_t vy_index = _getVyIndex(op_code);
+    uint8_t vy_index = instruction.y;
     uint8_t vy = state->vRegister(vy_index);
 
     // Set VF register to 1 if vy is greater than vxt
@@ -251,9 +253,10 @@ int Execute8XY7(CHIP8_State* state, uint16_t op_code) {
     return DEFAULT_OP_CYCLES;
 }
 
-int Execute8XYE(CHIP8_State* state, uint16_t op_code) {
-    uint8_t vx_index = _getVxIndex(op_code);
-    uint8_t vx = state->vRegister(vx_index);
+template <typename Quirks>
+int Execute8XYE(CHIP8_State* state, const Instruction& instruction) {
+    uint8_t vx_index = instruction.x;
+    uint8_t vx = state->vRegister(Quirks::SHIFT_READS_VY ? instruction.y : vx_index);
 
     // Save the most sig bit in VF
     state->setVRegister(REGISTER_VF, (uint8_t)((vx & 0b1000'0000) >> 7));
@@ -262,88 +265,51 @@ int Execute8XYE(CHIP8_State* state, uint16_t op_code) {
     return DEFAULT_OP_CYCLES;
 }
 
-int Execute9XY0(CHIP8_State* state, uint16_t op_code) {
-    uint8_t vx_index = _getVxIndex(op_code);
+int Execute9XY0(CHIP8_State* state, const Instruction& instruction) {
+    uint8_t vx_index = instruction.x;
     uint8_t vx = state->vRegister(vx_index);
 
-    uint8_t vy_index = _getVyIndex(op_code);
+    uint8_t vy_index = instruction.y;
     uint8_t vy = state->vRegister(vy_index);
 
     if (vx != vy) {
-        uint16_t pc = state->programCounter();
-        state->setProgramCounter(pc + 2);
+        state->skipInstruction();
     }
 
     return DEFAULT_OP_CYCLES;
 }
 
-int ExecuteANNN(CHIP8_State* state, uint16_t op_code) {
-    state->setIndexRegister(op_code & 0x0FFF);
+int ExecuteANNN(CHIP8_State* state, const Instruction& instruction) {
+    state->setIndexRegister(instruction.nnn);
     return DEFAULT_OP_CYCLES;
 }
 
-int ExecuteBNNN(CHIP8_State* state, uint16_t op_code) {
-    uint8_t v0 = state->vRegister(0);
-    state->setProgramCounter((op_code & 0x0FFF) + v0);
+template <typename Quirks>
+int ExecuteBNNN(CHIP8_State* state, const Instruction& instruction) {
+    uint8_t v0 = state->vRegister(Quirks::JUMP_USES_VX ? instruction.x : 0);
+    state->setProgramCounter((instruction.nnn) + v0);
     return DEFAULT_OP_CYCLES;
 }
 
-int ExecuteCNNN(CHIP8_State* state, uint16_t op_code) {
-    uint8_t random = rand() % 255;
-    uint8_t vx_index = _getVxIndex(op_code);
-    state->setVRegister(vx_index, (op_code & 0x00FF) & random);
+int ExecuteCNNN(CHIP8_State* state, const Instruction& instruction) {
+    uint8_t random = state->randomByte();
+    uint8_t vx_index = instruction.x;
+    state->setVRegister(vx_index, instruction.nn & random);
 
     return DEFAULT_OP_CYCLES;
 }
 
-int ExecuteDXYN(CHIP8_State* state, uint16_t op_code) {
-
-    uint8_t vx_index = _getVxIndex(op_code);
-    uint8_t vx = state->vRegister(vx_index) % DISPLAY_WIDTH;
-
-    uint8_t vy_index = _getVyIndex(op_code);
-    uint8_t vy = state->vRegister(vy_index) % DISPLAY_HEIGHT;
-
-    uint8_t sprite_height = (uint8_t)(op_code & 0x000F);
-    uint8_t sprite_width = 8;
-
-    bool changed_bit = false;
-    uint16_t index_register = state->indexRegister();
-
-    // For each row defining the sprite in data
-    for (int row_index = 0; row_index < sprite_height; row_index++) {
-        // Get the row of pixels
-        uint8_t row_data = state->memoryValue(index_register + row_index);
-        // Sprites are 8 pixels long, unless cut off by screen
-        for (uint8_t pixel_index = 0; pixel_index < sprite_width; pixel_index++) {
-
-            //Get the bit we want to check if it's set:
-            bool sprite_bit = (row_data & (0b10000000 >> pixel_index)) > 0;
-
-            int display_pixel_y = vy + row_index;
-            if (display_pixel_y >= DISPLAY_HEIGHT) {
-                continue;
-            }
+template <typename Quirks>
+int ExecuteDXYN(CHIP8_State* state, const Instruction& instruction) {
 
-            int display_pixel_x =  vx + pixel_index;
-            if (display_pixel_x >= DISPLAY_WIDTH) {
-                continue;
-            }
+    uint8_t vx = state->vRegister(instruction.x);
+    uint8_t vy = state->vRegister(instruction.y);
 
-            bool display_bit = state->displayValue(display_pixel_x, display_pixel_y);
-
-            // The new bit to display is the xor of the sprite bit and the current display bit
-            bool new_display_bit = display_bit ^ sprite_bit;
-
-            // If the display bit will change and the display bit is being cleared
-            if (new_display_bit == false && display_bit == true) {
-                // Set the flag that VF needs to be updated
-                changed_bit = true;
-            }
-
-            // Set the bit based on the pixel offset
-            state->setDisplayValue(display_pixel_x, display_pixel_y, new_display_bit);
-        }
+    bool changed_bit;
+    if (instruction.n == 0 && state->hires()) {
+        changed_bit = state->drawSprite<Quirks::WRAP_SPRITES>(vx, vy, 16, 2);
+    } else {
+        changed_bit = state->drawSprite<Quirks::WRAP_SPRITES>(vx, vy, instruction.n, 1);
     }
 
     if (changed_bit) {
@@ -356,32 +322,32 @@ int ExecuteDXYN(CHIP8_State* state, uint16_t op_code) {
     return DEFAULT_OP_CYCLES;
 }
 
-int ExecuteEX9E(CHIP8_State* state, uint16_t op_code, InputInterface* input) {
-    uint8_t vx_index = _getVxIndex(op_code);
+int ExecuteEX9E(CHIP8_State* state, const Instruction& instruction, InputInterface* input) {
+    uint8_t vx_index = instruction.x;
     uint8_t vx = state->vRegister(vx_index);
 
     if (input->isPressed(vx) == true) {
         // Skip next instruction by jumping PC ahead by 16 bits
-        state->incrementProgramCounter(2);
+        state->skipInstruction();
     }
 
     return DEFAULT_OP_CYCLES;
 }
 
-int ExecuteEXA1(CHIP8_State* state, uint16_t op_code, InputInterface* input) {
-    uint8_t vx_index = _getVxIndex(op_code);
+int ExecuteEXA1(CHIP8_State* state, const Instruction& instruction, InputInterface* input) {
+    uint8_t vx_index = instruction.x;
     uint8_t vx = state->vRegister(vx_index);
 
     if (input->isPressed(vx) == false) {
         // Skip next instruction by jumping PC ahead by 16 bits
-        state->incrementProgramCounter(2);
+        state->skipInstruction();
     }
 
     return DEFAULT_OP_CYCLES;
 }
 
-int ExecuteFX07(CHIP8_State* state, uint16_t op_code) {
-    uint8_t vx_index = _getVxIndex(op_code);
+int ExecuteFX07(CHIP8_State* state, const Instruction& instruction) {
+    uint8_t vx_index = instruction.x;
     uint8_t delay_timer = state->delayTimer();
 
     state->setVRegister(vx_index, delay_timer);
@@ -389,17 +355,22 @@ int ExecuteFX07(CHIP8_State* state, uint16_t op_code) {
     return DEFAULT_OP_CYCLES;
 }
 
-int ExecuteFX0A(CHIP8_State* state, uint16_t op_code, InputInterface* input) {
-    uint8_t vx_index = _getVxIndex(op_code);
-    uint8_t key = input->getInput();
+int ExecuteFX0A(CHIP8_State* state, const Instruction& instruction, InputInterface* input) {
+    uint8_t vx_index = instruction.x;
+    uint8_t key;
+    if (!input->pollInput(key)) {
+        // Run again until a key is pressed, the timers and the display keep going meanwhile
+        state->setProgramCounter(state->programCounter() - 2);
+        return BLOCKING_CALL;
+    }
 
     state->setVRegister(vx_index, key);
 
     return BLOCKING_CALL;
 }
 
-int ExecuteFX15(CHIP8_State* state, uint16_t op_code) {
-    uint8_t vx_index = _getVxIndex(op_code);
+int ExecuteFX15(CHIP8_State* state, const Instruction& instruction) {
+    uint8_t vx_index = instruction.x;
     uint8_t vx = state->vRegister(vx_index);
 
     state->setDelayTimer(vx);
@@ -407,8 +378,8 @@ int ExecuteFX15(CHIP8_State* state, uint16_t op_code) {
     return DEFAULT_OP_CYCLES;
 }
 
-int ExecuteFX18(CHIP8_State* state, uint16_t op_code) {
-    uint8_t vx_index = _getVxIndex(op_code);
+int ExecuteFX18(CHIP8_State* state, const Instruction& instruction) {
+    uint8_t vx_index = instruction.x;
     uint8_t vx = state->vRegister(vx_index);
 
     state->setSoundTimer(vx);
@@ -416,8 +387,8 @@ int ExecuteFX18(CHIP8_State* state, uint16_t op_code) {
     return DEFAULT_OP_CYCLES;
 }
 
-int ExecuteFX1E(CHIP8_State* state, uint16_t op_code) {
-    uint8_t vx_index = _getVxIndex(op_code);
+int ExecuteFX1E(CHIP8_State* state, const Instruction& instruction) {
+    uint8_t vx_index = instruction.x;
     uint8_t vx = state->vRegister(vx_index);
 
     uint16_t index_register = state->indexRegister();
@@ -428,8 +399,8 @@ int ExecuteFX1E(CHIP8_State* state, uint16_t op_code) {
     return DEFAULT_OP_CYCLES;
 }
 
-int ExecuteFX29(CHIP8_State* state, uint16_t op_code) {
-    uint8_t vx_index = _getVxIndex(op_code);
+int ExecuteFX29(CHIP8_State* state, const Instruction& instruction) {
+    uint8_t vx_index = instruction.x;
     uint8_t vx = state->vRegister(vx_index);
     uint16_t font_location = FONT_MEMORY_LOCATION + (uint16_t)(vx * 5);
 
@@ -438,8 +409,8 @@ int ExecuteFX29(CHIP8_State* state, uint16_t op_code) {
     return DEFAULT_OP_CYCLES;
 }
 
-int ExecuteFX33(CHIP8_State* state, uint16_t op_code) {
-    uint8_t vx_index = _getVxIndex(op_code);
+int ExecuteFX33(CHIP8_State* state, const Instruction& instruction) {
+    uint8_t vx_index = instruction.x;
     uint8_t vx = state->vRegister(vx_index);
 
     std::string vx_string = std::to_string(vx);
@@ -457,8 +428,25 @@ int ExecuteFX33(CHIP8_State* state, uint16_t op_code) {
     return DEFAULT_OP_CYCLES;
 }
 
-int ExecuteFX55(CHIP8_State* state, uint16_t op_code) {
-    uint8_t vx_index = _getVxIndex(op_code);
+/**
+ * @brief The index register once FX55 or FX65 accessed V0 to VX from it
+ *
+ */
+template <typename Quirks>
+static inline uint16_t _loadStoreIndex(uint16_t index_register, uint8_t vx_index) {
+    switch (Quirks::LOAD_STORE_INCREMENT) {
+        case IndexIncrement::XPlusOne:
+            return index_register + vx_index + 1;
+        case IndexIncrement::X:
+            return index_register + vx_index;
+        default:
+            return index_register;
+    }
+}
+
+template <typename Quirks>
+int ExecuteFX55(CHIP8_State* state, const Instruction& instruction) {
+    uint8_t vx_index = instruction.x;
     uint16_t index_register_address = state->indexRegister();
 
     for (uint8_t i = 0; i <= vx_index; i++) {
@@ -466,12 +454,13 @@ int ExecuteFX55(CHIP8_State* state, uint16_t op_code) {
         state->setMemoryValue((uint16_t)(index_register_address + i), v_value);
     }
 
-    state->setIndexRegister(index_register_address + vx_index + 1);
+    state->setIndexRegister(_loadStoreIndex<Quirks>(index_register_address, vx_index));
     return DEFAULT_OP_CYCLES;
 }
 
-int ExecuteFX65(CHIP8_State* state, uint16_t op_code) {
-    uint16_t vx_index = (uint16_t)_getVxIndex(op_code);
+template <typename Quirks>
+int ExecuteFX65(CHIP8_State* state, const Instruction& instruction) {
+    uint16_t vx_index = (uint16_t)instruction.x;
     uint16_t index_register_address = state->indexRegister();
 
     for (uint16_t i = 0; i <= vx_index; i++) {
@@ -479,6 +468,128 @@ int ExecuteFX65(CHIP8_State* state, uint16_t op_code) {
         state->setVRegister(i, v_value);
     }
 
-    state->setIndexRegister(index_register_address + vx_index + 1);
+    state->setIndexRegister(_loadStoreIndex<Quirks>(index_register_address, vx_index));
+    return DEFAULT_OP_CYCLES;
+}
+int Execute00CN(CHIP8_State* state, const Instruction& instruction) {
+    state->scrollDisplayDown(instruction.n);
+    return DEFAULT_OP_CYCLES;
+}
+
+int Execute00DN(CHIP8_State* state, const Instruction& instruction) {
+    state->scrollDisplayUp(instruction.n);
     return DEFAULT_OP_CYCLES;
-}
\ No newline at end of file
+}
+
+int Execute00FB(CHIP8_State* state) {
+    state->scrollDisplayRight(4);
+    return DEFAULT_OP_CYCLES;
+}
+
+int Execute00FC(CHIP8_State* state) {
+    state->scrollDisplayLeft(4);
+    return DEFAULT_OP_CYCLES;
+}
+
+int Execute00FD(CHIP8_State* state) {
+    // Stay on the exit instruction, the emulator stops once it sees the exit flag
+    state->setExited(true);
+    state->setProgramCounter(state->programCounter() - 2);
+    return DEFAULT_OP_CYCLES;
+}
+
+int Execute00FE(CHIP8_State* state) {
+    state->setHires(false);
+    state->clearDisplay();
+    return DEFAULT_OP_CYCLES;
+}
+
+int Execute00FF(CHIP8_State* state) {
+    state->setHires(true);
+    state->clearDisplay();
+    return DEFAULT_OP_CYCLES;
+}
+
+int ExecuteFX30(CHIP8_State* state, const Instruction& instruction) {
+    uint8_t digit = state->vRegister(instruction.x) & 0xF;
+    state->setIndexRegister(BIG_FONT_MEMORY_LOCATION + digit * 10);
+    return DEFAULT_OP_CYCLES;
+}
+
+int ExecuteFX75(CHIP8_State* state, const Instruction& instruction) {
+    for (uint8_t i = 0; i <= instruction.x; i++) {
+        state->setRplFlag(i, state->vRegister(i));
+    }
+    return DEFAULT_OP_CYCLES;
+}
+
+int ExecuteFX85(CHIP8_State* state, const Instruction& instruction) {
+    for (uint8_t i = 0; i <= instruction.x; i++) {
+        state->setVRegister(i, state->rplFlag(i));
+    }
+    return DEFAULT_OP_CYCLES;
+}
+
+int Execute5XY2(CHIP8_State* state, const Instruction& instruction) {
+    // The registers are stored in the order they are listed, from VX to VY
+    int step = instruction.x <= instruction.y ? 1 : -1;
+    uint16_t address = state->indexRegister();
+    for (int i = instruction.x; ; i += step) {
+        state->setMemoryValue(address++, state->vRegister(i));
+        if (i == instruction.y) {
+            break;
+        }
+    }
+    return DEFAULT_OP_CYCLES;
+}
+
+int Execute5XY3(CHIP8_State* state, const Instruction& instruction) {
+    int step = instruction.x <= instruction.y ? 1 : -1;
+    uint16_t address = state->indexRegister();
+    for (int i = instruction.x; ; i += step) {
+        state->setVRegister(i, state->memoryValue(address++));
+        if (i == instruction.y) {
+            break;
+        }
+    }
+    return DEFAULT_OP_CYCLES;
+}
+
+int ExecuteF000(CHIP8_State* state) {
+    // The address is the word following the instruction, which is skipped
+    uint16_t program_counter = state->programCounter();
+    uint16_t address = ((uint16_t)state->memoryValue(program_counter) << 8) | state->memoryValue(program_counter + 1);
+    state->setIndexRegister(address);
+    state->setProgramCounter(program_counter + 2);
+    return DEFAULT_OP_CYCLES;
+}
+
+int ExecuteFN01(CHIP8_State* state, const Instruction& instruction) {
+    state->setPlanes(instruction.x);
+    return DEFAULT_OP_CYCLES;
+}
+
+int Execute0230(CHIP8_State* state) {
+    if (state->displayMode() == DisplayMode::VipHires) {
+        state->clearDisplay();
+    }
+    return DEFAULT_OP_CYCLES;
+}
+
+// Every quirk policy gets its own copy of the handlers depending on quirks
+#define INSTANTIATE_QUIRK_HANDLERS(Quirks) \
+    template int Execute8XY1<Quirks>(CHIP8_State* state, const Instruction& instruction); \
+    template int Execute8XY2<Quirks>(CHIP8_State* state, const Instruction& instruction); \
+    template int Execute8XY3<Quirks>(CHIP8_State* state, const Instruction& instruction); \
+    template int Execute8XY6<Quirks>(CHIP8_State* state, const Instruction& instruction); \
+    template int Execute8XYE<Quirks>(CHIP8_State* state, const Instruction& instruction); \
+    template int ExecuteBNNN<Quirks>(CHIP8_State* state, const Instruction& instruction); \
+    template int ExecuteDXYN<Quirks>(CHIP8_State* state, const Instruction& instruction); \
+    template int ExecuteFX55<Quirks>(CHIP8_State* state, const Instruction& instruction); \
+    template int ExecuteFX65<Quirks>(CHIP8_State* state, const Instruction& instruction)
+
+INSTANTIATE_QUIRK_HANDLERS(VipQuirks);
+INSTANTIATE_QUIRK_HANDLERS(Chip48Quirks);
+INSTANTIATE_QUIRK_HANDLERS(SuperChipQuirks);
+INSTANTIATE_QUIRK_HANDLERS(ModernQuirks);
+INSTANTIATE_QUIRK_HANDLERS(XOChipQuirks);
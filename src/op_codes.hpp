@@ -4,6 +4,8 @@
 #include <iostream>
 #include <sstream>
 #include "chip-8_state.hpp"
+#include "instruction.hpp"
+#include "quirks.hpp"
 #include "input/input_interface.hpp"
 
 static int DEFAULT_OP_CYCLES = 1;
@@ -41,7 +43,7 @@ int Execute00EE(CHIP8_State* state);
  *
  * @return The number of cycles needed to perform the operation
  */
-int Execute1NNN(CHIP8_State* state, uint16_t op_code);
+int Execute1NNN(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0x2NNN op code on the chip state
@@ -52,7 +54,7 @@ int Execute1NNN(CHIP8_State* state, uint16_t op_code);
  *
  * @return The number of cycles needed to perform the operation
  */
-int Execute2NNN(CHIP8_State* state, uint16_t op_code);
+int Execute2NNN(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0x3XNN op code on the chip state
@@ -60,11 +62,11 @@ int Execute2NNN(CHIP8_State* state, uint16_t op_code);
  * 0x3XNN - Skips the next instruction if VX equals NN
  *
  * @param state Current chip state
- * @param op_code The op code
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int Execute3XNN(CHIP8_State* state, uint16_t op_code);
+int Execute3XNN(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0x4XNN op code on the chip state
@@ -75,7 +77,7 @@ int Execute3XNN(CHIP8_State* state, uint16_t op_code);
  *
  * @return The number of cycles needed to perform the operation
  */
-int Execute4XNN(CHIP8_State* state, uint16_t op_code);
+int Execute4XNN(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0x5XY0 op code on the chip state
@@ -86,7 +88,7 @@ int Execute4XNN(CHIP8_State* state, uint16_t op_code);
  *
  * @return The number of cycles needed to perform the operation
  */
-int Execute5XY0(CHIP8_State* state, uint16_t op_code);
+int Execute5XY0(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0x6XNN op code on the chip state
@@ -94,11 +96,11 @@ int Execute5XY0(CHIP8_State* state, uint16_t op_code);
  * 0x6XNN - Sets VX to NN
  *
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int Execute6XNN(CHIP8_State* state, uint16_t op_code);
+int Execute6XNN(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0x7XNN op code on the chip state
@@ -106,11 +108,11 @@ int Execute6XNN(CHIP8_State* state, uint16_t op_code);
  * 0x7XNN - Adds NN to VX. (Carry flag is not changed)
  *
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int Execute7XNN(CHIP8_State* state, uint16_t op_code);
+int Execute7XNN(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0x8XY0 op code on the chip state
@@ -118,47 +120,53 @@ int Execute7XNN(CHIP8_State* state, uint16_t op_code);
  * 0x8XY0 - Sets VX to the value of VY.
  *
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int Execute8XY0(CHIP8_State* state, uint16_t op_code);
+int Execute8XY0(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0x8XY1 op code on the chip state
  *
- * 0x8XY1 - Sets VX to VX or VY.
+ * 0x8XY1 - Sets VX to VX or VY. VF is reset when the quirks require it.
  *
+ * @tparam Quirks The quirk policy, such as VipQuirks
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int Execute8XY1(CHIP8_State* state, uint16_t op_code);
+template <typename Quirks = ModernQuirks>
+int Execute8XY1(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0x8XY2 op code on the chip state
  *
- * 0x8XY2 - Sets VX to VX and VY.
+ * 0x8XY2 - Sets VX to VX and VY. VF is reset when the quirks require it.
  *
+ * @tparam Quirks The quirk policy, such as VipQuirks
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int Execute8XY2(CHIP8_State* state, uint16_t op_code);
+template <typename Quirks = ModernQuirks>
+int Execute8XY2(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0x8XY3 op code on the chip state
  *
- * 0x8XY3 - Sets VX to VX xor VY.
+ * 0x8XY3 - Sets VX to VX xor VY. VF is reset when the quirks require it.
  *
+ * @tparam Quirks The quirk policy, such as VipQuirks
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int Execute8XY3(CHIP8_State* state, uint16_t op_code);
+template <typename Quirks = ModernQuirks>
+int Execute8XY3(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0x8XY4 op code on the chip state
@@ -167,11 +175,11 @@ int Execute8XY3(CHIP8_State* state, uint16_t op_code);
  * VF is set to 1 when there's a carry, and to 0 when there isn't.
  *
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int Execute8XY4(CHIP8_State* state, uint16_t op_code);
+int Execute8XY4(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0x8XY5 op code on the chip state
@@ -180,23 +188,26 @@ int Execute8XY4(CHIP8_State* state, uint16_t op_code);
  * VF is set to 0 when there's a borrow, and 1 when there isn't.
  *
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int Execute8XY5(CHIP8_State* state, uint16_t op_code);
+int Execute8XY5(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0x8XY6 op code on the chip state
  *
  * 0x8XY6 - Stores the least significant bit of VX in VF and then shifts VX to the right by 1.
+ * VY is shifted into VX instead when the quirks require it.
  *
+ * @tparam Quirks The quirk policy, such as VipQuirks
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int Execute8XY6(CHIP8_State* state, uint16_t op_code);
+template <typename Quirks = ModernQuirks>
+int Execute8XY6(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0x8XY7 op code on the chip state
@@ -206,23 +217,26 @@ int Execute8XY6(CHIP8_State* state, uint16_t op_code);
  * Then Vx is subtracted from Vy, and the results stored in Vx.
  *
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int Execute8XY7(CHIP8_State* state, uint16_t op_code);
+int Execute8XY7(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0x8XYE op code on the chip state
  *
  * 0x8XYE - Stores the most significant bit of VX in VF and then shifts VX to the left by 1.
+ * VY is shifted into VX instead when the quirks require it.
  *
+ * @tparam Quirks The quirk policy, such as VipQuirks
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int Execute8XYE(CHIP8_State* state, uint16_t op_code);
+template <typename Quirks = ModernQuirks>
+int Execute8XYE(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0x9XY0 op code on the chip state
@@ -231,11 +245,11 @@ int Execute8XYE(CHIP8_State* state, uint16_t op_code);
  * (Usually the next instruction is a jump to skip a code block)
  *
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int Execute9XY0(CHIP8_State* state, uint16_t op_code);
+int Execute9XY0(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0xANNN op code on the chip state
@@ -243,35 +257,37 @@ int Execute9XY0(CHIP8_State* state, uint16_t op_code);
  * 0xANNN - Sets I (index register) to the address NNN.
  *
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int ExecuteANNN(CHIP8_State* state, uint16_t op_code);
+int ExecuteANNN(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0xBNNN op code on the chip state
  *
- * 0xBNNN - Jumps to the address NNN plus V0.
+ * 0xBNNN - Jumps to the address NNN plus V0, or plus VX when the quirks require it.
  *
+ * @tparam Quirks The quirk policy, such as VipQuirks
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int ExecuteBNNN(CHIP8_State* state, uint16_t op_code);
+template <typename Quirks = ModernQuirks>
+int ExecuteBNNN(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0xCNNN op code on the chip state
  *
  * 0xCNNN - Sets VX to the result of a bitwise and operation on a random number and NN
- * (Typically: 0 to 255)
+ * (0 to 255, drawn from the seeded generator of the state)
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int ExecuteCNNN(CHIP8_State* state, uint16_t op_code);
+int ExecuteCNNN(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0xDXYN op code on the chip state
@@ -279,14 +295,18 @@ int ExecuteCNNN(CHIP8_State* state, uint16_t op_code);
  * 0xDXYN - Draws a sprite at coordinate (VX, VY) that has a width of 8 pixels and a height of N pixels.
  * Each row of 8 pixels is read as bit-coded starting from memory location I;
  * I value doesn’t change after the execution of this instruction. As described above, VF is set to 1 if any screen
- *  pixels are flipped from set to unset when the sprite is drawn, and to 0 if that doesn’t happen
+ *  pixels are flipped from set to unset when the sprite is drawn, and to 0 if that doesn’t happen.
+ * On the SUPER-CHIP 128x64 display, DXY0 draws a 16x16 sprite made of 32 bytes.
+ * The sprite is cut off by the edges of the display, or wraps around them when the quirks require it.
  *
+ * @tparam Quirks The quirk policy, such as VipQuirks
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int ExecuteDXYN(CHIP8_State* state, uint16_t op_code);
+template <typename Quirks = ModernQuirks>
+int ExecuteDXYN(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0xEX9E op code on the chip state
@@ -295,12 +315,12 @@ int ExecuteDXYN(CHIP8_State* state, uint16_t op_code);
  * (Usually the next instruction is a jump to skip a code block).
  *
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  * @param input The input interface used to retrieve info on what keys are pressed
  *
  * @return The number of cycles needed to perform the operation
  */
-int ExecuteEX9E(CHIP8_State* state, uint16_t op_code, InputInterface* input);
+int ExecuteEX9E(CHIP8_State* state, const Instruction& instruction, InputInterface* input);
 
 /**
  * @brief Executes the 0xEXA1 op code on the chip state
@@ -309,12 +329,12 @@ int ExecuteEX9E(CHIP8_State* state, uint16_t op_code, InputInterface* input);
  * (Usually the next instruction is a jump to skip a code block).
  *
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  * @param input The input interface used to retrieve info on what keys are pressed
  *
  * @return The number of cycles needed to perform the operation
  */
-int ExecuteEXA1(CHIP8_State* state, uint16_t op_code, InputInterface* input);
+int ExecuteEXA1(CHIP8_State* state, const Instruction& instruction, InputInterface* input);
 
 /**
  * @brief Executes the 0xFX07 op code on the chip state
@@ -322,24 +342,24 @@ int ExecuteEXA1(CHIP8_State* state, uint16_t op_code, InputInterface* input);
  * 0xFX07 -Sets VX to the value of the delay timer.
  *
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int ExecuteFX07(CHIP8_State* state, uint16_t op_code);
+int ExecuteFX07(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0xFX0A op code on the chip state
  *
  * 0xFX0A - A key press is awaited, and then stored in VX.
- * (Blocking Operation. All instruction halted until next key event)
+ * (Blocking Operation. The instruction runs again until the input reports a key, timers keep running)
  *
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int ExecuteFX0A(CHIP8_State* state, uint16_t op_code, InputInterface* input);
+int ExecuteFX0A(CHIP8_State* state, const Instruction& instruction, InputInterface* input);
 
 /**
  * @brief Executes the 0xFX15 op code on the chip state
@@ -347,11 +367,11 @@ int ExecuteFX0A(CHIP8_State* state, uint16_t op_code, InputInterface* input);
  * 0xFX15 - Sets the delay timer to VX.
  *
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int ExecuteFX15(CHIP8_State* state, uint16_t op_code);
+int ExecuteFX15(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0xFX18 op code on the chip state
@@ -359,11 +379,11 @@ int ExecuteFX15(CHIP8_State* state, uint16_t op_code);
  * 0xFX18 - Sets the sound timer to VX.
  *
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int ExecuteFX18(CHIP8_State* state, uint16_t op_code);
+int ExecuteFX18(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0xFX1E op code on the chip state
@@ -371,11 +391,11 @@ int ExecuteFX18(CHIP8_State* state, uint16_t op_code);
  * 0xFX1E - Adds VX to I.
  *
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int ExecuteFX1E(CHIP8_State* state, uint16_t op_code);
+int ExecuteFX1E(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0xFX29 op code on the chip state
@@ -384,11 +404,11 @@ int ExecuteFX1E(CHIP8_State* state, uint16_t op_code);
  * Characters 0-F (in hexadecimal) are represented by a 4x5 font.
  *
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int ExecuteFX29(CHIP8_State* state, uint16_t op_code);
+int ExecuteFX29(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0xFX33 op code on the chip state
@@ -401,36 +421,216 @@ int ExecuteFX29(CHIP8_State* state, uint16_t op_code);
  * the tens digit at location I+1, and the ones digit at location I+2.)
  *
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int ExecuteFX33(CHIP8_State* state, uint16_t op_code);
+int ExecuteFX33(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0xFX55 op code on the chip state
  *
  * 0xFX55 - Stores V0 to VX (including VX) in memory starting at address I.
- * The offset from I is increased by 1 for each value written.
+ * I is then moved forward as the quirks require, by X + 1 on the COSMAC VIP.
  *
+ * @tparam Quirks The quirk policy, such as VipQuirks
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int ExecuteFX55(CHIP8_State* state, uint16_t op_code);
+template <typename Quirks = ModernQuirks>
+int ExecuteFX55(CHIP8_State* state, const Instruction& instruction);
 
 /**
  * @brief Executes the 0xFX65 op code on the chip state
  *
  * 0xFX65 - Fills V0 to VX (including VX) with values from memory starting at address I.
- * The offset from I is increased by 1 for each value written.
+ * I is then moved forward as the quirks require, by X + 1 on the COSMAC VIP.
  *
+ * @tparam Quirks The quirk policy, such as VipQuirks
  * @param state Current chip state
- * @param op_code The op code to execute
+ * @param instruction The decoded op code to execute
  *
  * @return The number of cycles needed to perform the operation
  */
-int ExecuteFX65(CHIP8_State* state, uint16_t op_code);
+template <typename Quirks = ModernQuirks>
+int ExecuteFX65(CHIP8_State* state, const Instruction& instruction);
+
+/**
+ * @brief Executes the 0x00CN op code on the chip state
+ *
+ * 0x00CN - SUPER-CHIP, scrolls the display down by N rows
+ *
+ * @param state Current chip state
+ * @param instruction The decoded op code to execute
+ *
+ * @return The number of cycles needed to perform the operation
+ */
+int Execute00CN(CHIP8_State* state, const Instruction& instruction);
+
+/**
+ * @brief Executes the 0x00DN op code on the chip state
+ *
+ * 0x00DN - XO-CHIP, scrolls the display up by N rows
+ *
+ * @param state Current chip state
+ * @param instruction The decoded op code to execute
+ *
+ * @return The number of cycles needed to perform the operation
+ */
+int Execute00DN(CHIP8_State* state, const Instruction& instruction);
+
+/**
+ * @brief Executes the 0x00FB op code on the chip state
+ *
+ * 0x00FB - SUPER-CHIP, scrolls the display right by 4 pixels
+ *
+ * @param state Current chip state
+ *
+ * @return The number of cycles needed to perform the operation
+ */
+int Execute00FB(CHIP8_State* state);
+
+/**
+ * @brief Executes the 0x00FC op code on the chip state
+ *
+ * 0x00FC - SUPER-CHIP, scrolls the display left by 4 pixels
+ *
+ * @param state Current chip state
+ *
+ * @return The number of cycles needed to perform the operation
+ */
+int Execute00FC(CHIP8_State* state);
+
+/**
+ * @brief Executes the 0x00FD op code on the chip state
+ *
+ * 0x00FD - SUPER-CHIP, exits the program. The program counter stays on the instruction.
+ *
+ * @param state Current chip state
+ *
+ * @return The number of cycles needed to perform the operation
+ */
+int Execute00FD(CHIP8_State* state);
+
+/**
+ * @brief Executes the 0x00FE op code on the chip state
+ *
+ * 0x00FE - SUPER-CHIP, switches to the 64x32 display and clears it
+ *
+ * @param state Current chip state
+ *
+ * @return The number of cycles needed to perform the operation
+ */
+int Execute00FE(CHIP8_State* state);
+
+/**
+ * @brief Executes the 0x00FF op code on the chip state
+ *
+ * 0x00FF - SUPER-CHIP, switches to the 128x64 display and clears it
+ *
+ * @param state Current chip state
+ *
+ * @return The number of cycles needed to perform the operation
+ */
+int Execute00FF(CHIP8_State* state);
+
+/**
+ * @brief Executes the 0xFX30 op code on the chip state
+ *
+ * 0xFX30 - SUPER-CHIP, sets I to the location of the 8x10 sprite for the digit in VX
+ *
+ * @param state Current chip state
+ * @param instruction The decoded op code to execute
+ *
+ * @return The number of cycles needed to perform the operation
+ */
+int ExecuteFX30(CHIP8_State* state, const Instruction& instruction);
+
+/**
+ * @brief Executes the 0xFX75 op code on the chip state
+ *
+ * 0xFX75 - SUPER-CHIP, saves V0 to VX (including VX) in the flag registers
+ *
+ * @param state Current chip state
+ * @param instruction The decoded op code to execute
+ *
+ * @return The number of cycles needed to perform the operation
+ */
+int ExecuteFX75(CHIP8_State* state, const Instruction& instruction);
+
+/**
+ * @brief Executes the 0xFX85 op code on the chip state
+ *
+ * 0xFX85 - SUPER-CHIP, loads V0 to VX (including VX) from the flag registers
+ *
+ * @param state Current chip state
+ * @param instruction The decoded op code to execute
+ *
+ * @return The number of cycles needed to perform the operation
+ */
+int ExecuteFX85(CHIP8_State* state, const Instruction& instruction);
+
+/**
+ * @brief Executes the 0x5XY2 op code on the chip state
+ *
+ * 0x5XY2 - XO-CHIP, saves VX to VY (including VY) in memory starting at I, in descending order when X > Y.
+ * I is not modified.
+ *
+ * @param state Current chip state
+ * @param instruction The decoded op code to execute
+ *
+ * @return The number of cycles needed to perform the operation
+ */
+int Execute5XY2(CHIP8_State* state, const Instruction& instruction);
+
+/**
+ * @brief Executes the 0x5XY3 op code on the chip state
+ *
+ * 0x5XY3 - XO-CHIP, loads VX to VY (including VY) from memory starting at I, in descending order when X > Y.
+ * I is not modified.
+ *
+ * @param state Current chip state
+ * @param instruction The decoded op code to execute
+ *
+ * @return The number of cycles needed to perform the operation
+ */
+int Execute5XY3(CHIP8_State* state, const Instruction& instruction);
+
+/**
+ * @brief Executes the 0xF000 op code on the chip state
+ *
+ * 0xF000 NNNN - XO-CHIP, sets I to the 16 bit address following the instruction, which is 4 bytes long
+ *
+ * @param state Current chip state
+ *
+ * @return The number of cycles needed to perform the operation
+ */
+int ExecuteF000(CHIP8_State* state);
+
+/**
+ * @brief Executes the 0xFN01 op code on the chip state
+ *
+ * 0xFN01 - XO-CHIP, selects the display planes N used by drawing, clearing and scrolling
+ *
+ * @param state Current chip state
+ * @param instruction The decoded op code to execute
+ *
+ * @return The number of cycles needed to perform the operation
+ */
+int ExecuteFN01(CHIP8_State* state, const Instruction& instruction);
+
+/**
+ * @brief Executes the 0x0230 op code on the chip state
+ *
+ * 0x0230 - COSMAC VIP two page hires, calls the routine clearing the 64x64 display. Ignored like any other
+ * machine code routine on the other displays.
+ *
+ * @param state Current chip state
+ *
+ * @return The number of cycles needed to perform the operation
+ */
+int Execute0230(CHIP8_State* state);
 
 #endif
\ No newline at end of file
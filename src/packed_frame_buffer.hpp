@@ -0,0 +1,290 @@
+/**
+ * @file packed_frame_buffer.hpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Definition of the framebuffers storing one bit per pixel in 64 bit words
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef PACKED_FRAME_BUFFER_HPP
+#define PACKED_FRAME_BUFFER_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+// Size of the SUPER-CHIP high resolution display, the largest display supported
+static const int HIRES_DISPLAY_WIDTH = 128;
+static const int HIRES_DISPLAY_HEIGHT = 64;
+
+// Number of words needed to store the largest display
+static const int MAX_FRAME_BUFFER_WORDS = HIRES_DISPLAY_WIDTH / 64 * HIRES_DISPLAY_HEIGHT;
+
+/**
+ * @brief Region of the display modified since the last refresh
+ *
+ */
+struct DisplayDamage {
+    // Bit y is set when row y was modified
+    uint64_t rows = 0;
+
+    // First modified column over every modified row
+    uint8_t x_begin = UINT8_MAX;
+
+    // Column following the last modified column over every modified row
+    uint8_t x_end = 0;
+
+    /**
+     * @brief Whether nothing was modified
+     *
+     */
+    inline bool empty() const {
+        return this->rows == 0;
+    }
+
+    /**
+     * @brief Adds the modified pixels of a word of a row to the damage
+     *
+     * @param y The row
+     * @param changed The pixels of the word that were modified, the most significant bit being the leftmost pixel
+     * @param word The index of the word in the row, covering columns 64 * word to 64 * word + 63
+     */
+    inline void add(int y, uint64_t changed, int word = 0) {
+        if (changed == 0) {
+            return;
+        }
+
+        this->rows |= (uint64_t)1 << y;
+
+        // The leftmost pixel is the most significant bit
+#if defined(__GNUC__)
+        int first = __builtin_clzll(changed);
+        int last = 63 - __builtin_ctzll(changed);
+#else
+        int first = 0;
+        while (((changed << first) & 0x8000000000000000) == 0) {
+            first++;
+        }
+        int last = 63;
+        while (((changed >> (63 - last)) & 1) == 0) {
+            last--;
+        }
+#endif
+        first += 64 * word;
+        last += 64 * word;
+
+        if (first < this->x_begin) {
+            this->x_begin = first;
+        }
+        if (last + 1 > this->x_end) {
+            this->x_end = last + 1;
+        }
+    }
+};
+
+/**
+ * @brief Read only view over the words of a packed framebuffer
+ *
+ */
+struct FrameBufferView {
+    // The rows one after the other, each made of width / 64 words, the most significant bit being the leftmost pixel
+    const uint64_t* rows;
+
+    // Size of the display in pixels
+    int width;
+    int height;
+
+    /**
+     * @brief The number of 64 bit words in a row
+     *
+     */
+    inline int wordsPerRow() const {
+        return this->width / 64;
+    }
+
+    /**
+     * @brief The first word of a row
+     *
+     */
+    inline const uint64_t* row(int y) const {
+        return &this->rows[y * this->wordsPerRow()];
+    }
+
+    /**
+     * @brief Whether a single pixel is set
+     *
+     */
+    inline bool pixel(int x, int y) const {
+        return (this->row(y)[x / 64] >> (63 - x % 64)) & 1;
+    }
+};
+
+/**
+ * @brief A monochrome framebuffer storing each row as consecutive 64 bit words
+ *
+ * The geometry is known at compile time, so drawing and scrolling are straight sequences of word operations for
+ * each display size. Every modification reports the pixels it changed to the damage.
+ *
+ * @tparam W The width in pixels, a multiple of 64
+ * @tparam H The height in pixels, at most 64
+ */
+template <int W, int H>
+struct PackedFrameBuffer {
+    static const int WIDTH = W;
+    static const int HEIGHT = H;
+    static const int WORDS_PER_ROW = W / 64;
+
+    uint64_t words[H * WORDS_PER_ROW];
+
+    /**
+     * @brief The first word of a row
+     *
+     */
+    inline uint64_t* row(int y) {
+        return &this->words[y * WORDS_PER_ROW];
+    }
+
+    /**
+     * @brief A read only view over the framebuffer
+     *
+     */
+    inline FrameBufferView view() const {
+        FrameBufferView view = {this->words, W, H};
+        return view;
+    }
+
+    /**
+     * @brief Draws a sprite with xor, the sprite is cut off by the right and bottom edges unless WRAP is set
+     *
+     * @tparam WRAP Whether the pixels past the right and bottom edges wrap around to the left and top edges
+     * @param x The column of the leftmost pixel, wrapped around the display
+     * @param y The row of the top pixel, wrapped around the display
+     * @param sprite The rows of the sprite, most significant byte first
+     * @param height The number of rows of the sprite
+     * @param bytes_per_row 1 for 8 pixels wide sprites, 2 for 16 pixels wide sprites
+     * @param damage Receives the modified pixels
+     * @return true A pixel that was set has been cleared
+     */
+    template <bool WRAP = false>
+    inline bool draw(int x, int y, const uint8_t* sprite, int height, int bytes_per_row, DisplayDamage& damage) {
+        x %= W;
+        y %= H;
+        int word = x / 64;
+        int shift = x % 64;
+        int next_word = WRAP ? (word + 1) % WORDS_PER_ROW : word + 1;
+
+        bool collision = false;
+        for (int row_index = 0; row_index < height && (WRAP || y + row_index < H); row_index++) {
+            // Align the pixels of the sprite row on the left of a word
+            uint64_t pixels = 0;
+            for (int byte = 0; byte < bytes_per_row; byte++) {
+                pixels |= (uint64_t)sprite[row_index * bytes_per_row + byte] << (56 - 8 * byte);
+            }
+
+            int target_y = WRAP ? (y + row_index) % H : y + row_index;
+            uint64_t* target = this->row(target_y);
+
+            uint64_t left = pixels >> shift;
+            collision |= (target[word] & left) != 0;
+            target[word] ^= left;
+            damage.add(target_y, left, word);
+
+            // Pixels spilling into the next word, the ones past the right edge are dropped or wrapped
+            if (shift != 0 && next_word < WORDS_PER_ROW) {
+                uint64_t right = pixels << (64 - shift);
+                collision |= (target[next_word] & right) != 0;
+                target[next_word] ^= right;
+                damage.add(target_y, right, next_word);
+            }
+        }
+        return collision;
+    }
+
+    /**
+     * @brief Clears every pixel
+     *
+     */
+    inline void clear(DisplayDamage& damage) {
+        for (int y = 0; y < H; y++) {
+            for (int word = 0; word < WORDS_PER_ROW; word++) {
+                damage.add(y, this->row(y)[word], word);
+            }
+        }
+        memset(this->words, 0, sizeof(this->words));
+    }
+
+    /**
+     * @brief Moves every row down, blank rows enter at the top
+     *
+     * @param count The number of rows to move by
+     */
+    inline void scrollDown(int count, DisplayDamage& damage) {
+        for (int y = H - 1; y >= 0; y--) {
+            uint64_t* target = this->row(y);
+            for (int word = 0; word < WORDS_PER_ROW; word++) {
+                uint64_t pixels = y >= count ? this->row(y - count)[word] : 0;
+                damage.add(y, target[word] ^ pixels, word);
+                target[word] = pixels;
+            }
+        }
+    }
+
+    /**
+     * @brief Moves every row up, blank rows enter at the bottom
+     *
+     * @param count The number of rows to move by
+     */
+    inline void scrollUp(int count, DisplayDamage& damage) {
+        for (int y = 0; y < H; y++) {
+            uint64_t* target = this->row(y);
+            for (int word = 0; word < WORDS_PER_ROW; word++) {
+                uint64_t pixels = y + count < H ? this->row(y + count)[word] : 0;
+                damage.add(y, target[word] ^ pixels, word);
+                target[word] = pixels;
+            }
+        }
+    }
+
+    /**
+     * @brief Moves every row right, blank pixels enter on the left
+     *
+     * @param count The number of pixels to move by, 1 - 63
+     */
+    inline void scrollRight(int count, DisplayDamage& damage) {
+        for (int y = 0; y < H; y++) {
+            uint64_t* target = this->row(y);
+            for (int word = WORDS_PER_ROW - 1; word >= 0; word--) {
+                uint64_t carry = word > 0 ? target[word - 1] << (64 - count) : 0;
+                uint64_t pixels = (target[word] >> count) | carry;
+                damage.add(y, target[word] ^ pixels, word);
+                target[word] = pixels;
+            }
+        }
+    }
+
+    /**
+     * @brief Moves every row left, blank pixels enter on the right
+     *
+     * @param count The number of pixels to move by, 1 - 63
+     */
+    inline void scrollLeft(int count, DisplayDamage& damage) {
+        for (int y = 0; y < H; y++) {
+            uint64_t* target = this->row(y);
+            for (int word = 0; word < WORDS_PER_ROW; word++) {
+                uint64_t carry = word + 1 < WORDS_PER_ROW ? target[word + 1] >> (64 - count) : 0;
+                uint64_t pixels = (target[word] << count) | carry;
+                damage.add(y, target[word] ^ pixels, word);
+                target[word] = pixels;
+            }
+        }
+    }
+};
+
+// The original CHIP-8 display, the SUPER-CHIP high resolution display and the COSMAC VIP two page display
+typedef PackedFrameBuffer<64, 32> LoresFrameBuffer;
+typedef PackedFrameBuffer<HIRES_DISPLAY_WIDTH, HIRES_DISPLAY_HEIGHT> HiresFrameBuffer;
+typedef PackedFrameBuffer<64, 64> VipHiresFrameBuffer;
+
+#endif
@@ -0,0 +1,178 @@
+/**
+ * @file quirks.hpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Definition of the behaviours that differ between CHIP-8 implementations, as compile time policies
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef QUIRKS_HPP
+#define QUIRKS_HPP
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+/**
+ * @brief The CHIP-8 implementations whose behaviour can be reproduced, selected when a ROM is loaded
+ *
+ */
+enum class QuirkProfile : uint8_t {
+    // The original interpreter of the COSMAC VIP
+    Vip,
+    // CHIP-48 on the HP-48 calculators
+    Chip48,
+    // SUPER-CHIP 1.1
+    SuperChip,
+    // What most ROMs in roms/ run correctly with, the default
+    Modern,
+    // XO-CHIP as implemented by Octo
+    XOChip
+};
+
+static const int QUIRK_PROFILE_COUNT = 5;
+
+/**
+ * @brief How FX55 and FX65 move the index register once the registers were stored or loaded
+ *
+ */
+enum class IndexIncrement {
+    // I is left unchanged
+    None,
+    // I is moved forward by X
+    X,
+    // I points past the last register, moved forward by X + 1
+    XPlusOne
+};
+
+/**
+ * @brief The COSMAC VIP interpreter
+ *
+ * Each policy lists every quirk as a compile time constant, so the handlers instantiated for a profile carry no
+ * test on the quirks.
+ */
+struct VipQuirks {
+    // 8XY6 and 8XYE shift VY into VX instead of shifting VX in place
+    static const bool SHIFT_READS_VY = true;
+
+    // How FX55 and FX65 move I
+    static const IndexIncrement LOAD_STORE_INCREMENT = IndexIncrement::XPlusOne;
+
+    // BNNN jumps to XNN plus VX instead of NNN plus V0
+    static const bool JUMP_USES_VX = false;
+
+    // DXYN wraps the pixels past the right and bottom edges around the display instead of dropping them
+    static const bool WRAP_SPRITES = false;
+
+    // 8XY1, 8XY2 and 8XY3 reset VF
+    static const bool LOGIC_RESETS_VF = true;
+
+    // 00CN, 00FB - 00FF, FX30, FX75 and FX85 run the SUPER-CHIP instructions instead of being ignored machine
+    // code calls and unknown op codes
+    static const bool SUPER_CHIP_INSTRUCTIONS = false;
+};
+
+/**
+ * @brief CHIP-48, which shifts in place, jumps with VX and only moves I by X
+ *
+ */
+struct Chip48Quirks {
+    static const bool SHIFT_READS_VY = false;
+    static const IndexIncrement LOAD_STORE_INCREMENT = IndexIncrement::X;
+    static const bool JUMP_USES_VX = true;
+    static const bool WRAP_SPRITES = false;
+    static const bool LOGIC_RESETS_VF = false;
+    static const bool SUPER_CHIP_INSTRUCTIONS = false;
+};
+
+/**
+ * @brief SUPER-CHIP 1.1, which no longer moves I
+ *
+ */
+struct SuperChipQuirks {
+    static const bool SHIFT_READS_VY = false;
+    static const IndexIncrement LOAD_STORE_INCREMENT = IndexIncrement::None;
+    static const bool JUMP_USES_VX = true;
+    static const bool WRAP_SPRITES = false;
+    static const bool LOGIC_RESETS_VF = false;
+    static const bool SUPER_CHIP_INSTRUCTIONS = true;
+};
+
+/**
+ * @brief The behaviour of the emulator before quirks were configurable: CHIP-48 shifts with the memory and
+ * jumps of the COSMAC VIP
+ *
+ */
+struct ModernQuirks {
+    static const bool SHIFT_READS_VY = false;
+    static const IndexIncrement LOAD_STORE_INCREMENT = IndexIncrement::XPlusOne;
+    static const bool JUMP_USES_VX = false;
+    static const bool WRAP_SPRITES = false;
+    static const bool LOGIC_RESETS_VF = false;
+    static const bool SUPER_CHIP_INSTRUCTIONS = true;
+};
+
+/**
+ * @brief XO-CHIP, the COSMAC VIP behaviour without the VF reset, with sprites wrapping around the display
+ *
+ */
+struct XOChipQuirks {
+    static const bool SHIFT_READS_VY = true;
+    static const IndexIncrement LOAD_STORE_INCREMENT = IndexIncrement::XPlusOne;
+    static const bool JUMP_USES_VX = false;
+    static const bool WRAP_SPRITES = true;
+    static const bool LOGIC_RESETS_VF = false;
+    static const bool SUPER_CHIP_INSTRUCTIONS = true;
+};
+
+/**
+ * @brief Calls an operation with the policy of a profile, the only place a profile is turned into a type
+ *
+ * @param profile The profile to instantiate the operation for
+ * @param operation Called with a default constructed VipQuirks, Chip48Quirks, SuperChipQuirks, ModernQuirks or
+ * XOChipQuirks
+ * @return The value returned by the operation
+ */
+template <typename Operation>
+inline auto WithQuirks(QuirkProfile profile, Operation operation) -> decltype(operation(ModernQuirks())) {
+    switch (profile) {
+        case QuirkProfile::Vip:
+            return operation(VipQuirks());
+        case QuirkProfile::Chip48:
+            return operation(Chip48Quirks());
+        case QuirkProfile::SuperChip:
+            return operation(SuperChipQuirks());
+        case QuirkProfile::XOChip:
+            return operation(XOChipQuirks());
+        default:
+            return operation(ModernQuirks());
+    }
+}
+
+/**
+ * @brief Finds the profile matching a name given on the command line
+ *
+ * @param name vip, chip48, schip, modern or xo-chip
+ * @param profile Receives the profile
+ * @return true The name is known
+ */
+inline bool ParseQuirkProfile(const string& name, QuirkProfile& profile) {
+    if (name == "vip") {
+        profile = QuirkProfile::Vip;
+    } else if (name == "chip48") {
+        profile = QuirkProfile::Chip48;
+    } else if (name == "schip") {
+        profile = QuirkProfile::SuperChip;
+    } else if (name == "modern") {
+        profile = QuirkProfile::Modern;
+    } else if (name == "xo-chip") {
+        profile = QuirkProfile::XOChip;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+#endif
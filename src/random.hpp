@@ -0,0 +1,63 @@
+/**
+ * @file random.hpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Definition of the seeded random number generator of the emulator
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#include <cstdint>
+#include <iostream>
+
+using namespace std;
+
+/**
+ * @brief Number of 32 bit words making up the state of a random number generator
+ *
+ */
+static const int RANDOM_STATE_WORDS = 4;
+
+/**
+ * @brief Seeds a xoshiro128** generator, the seed being spread over the state with splitmix64
+ *
+ * Equal seeds give equal sequences, whatever the instance or thread the generator belongs to.
+ *
+ * @param state The words of the generator
+ * @param seed Any value, 0 included
+ */
+inline void SeedRandom(uint32_t state[RANDOM_STATE_WORDS], uint64_t seed) {
+    for (int word = 0; word < RANDOM_STATE_WORDS; word += 2) {
+        seed += 0x9E3779B97F4A7C15;
+        uint64_t mixed = seed;
+        mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9;
+        mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EB;
+        mixed ^= mixed >> 31;
+        state[word] = (uint32_t)mixed;
+        state[word + 1] = (uint32_t)(mixed >> 32);
+    }
+}
+
+/**
+ * @brief Advances a xoshiro128** generator
+ *
+ * @param state The words of the generator, seeded with SeedRandom
+ * @return uint32_t The next random number, every bit being equally random
+ */
+inline uint32_t NextRandom(uint32_t state[RANDOM_STATE_WORDS]) {
+    uint32_t scrambled = state[1] * 5;
+    uint32_t result = ((scrambled << 7) | (scrambled >> 25)) * 9;
+    uint32_t shifted = state[1] << 9;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= shifted;
+    state[3] = (state[3] << 11) | (state[3] >> 21);
+    return result;
+}
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * @file recompiled_program.cpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Implementation of the runtime support for ROMs recompiled ahead of time into C++
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <iostream>
+#include <vector>
+#include "chip-8_state.hpp"
+#include "dispatch.hpp"
+#include "instruction.hpp"
+#include "recompiled_program.hpp"
+#include "input/input_interface.hpp"
+
+using namespace std;
+
+RecompiledProgram::RecompiledProgram(const RecompiledRom* rom, CHIP8_State* state, InputInterface* input) {
+    this->rom_ = rom;
+    this->state_ = state;
+    this->input_ = input;
+
+    this->dirty_.resize(rom->block_count, false);
+    this->address_blocks_.resize(RAM_SIZE);
+    for (int block = 0; block < rom->block_count; block++) {
+        for (int address = rom->blocks[block].start; address < rom->blocks[block].end && address < RAM_SIZE; address++) {
+            this->address_blocks_[address].push_back(block);
+        }
+    }
+
+    // Anything that differs from the recompiled ROM cannot run natively
+    for (int i = 0; i < rom->image_size && INITAL_PROGRAM_COUNTER + i < RAM_SIZE; i++) {
+        this->onMemoryWrite(INITAL_PROGRAM_COUNTER + i);
+    }
+
+    this->state_->addMemoryListener(this);
+}
+
+RecompiledProgram::~RecompiledProgram() {
+    this->state_->removeMemoryListener(this);
+}
+
+int RecompiledProgram::run(int budget, bool& refresh_display) {
+    int executed = 0;
+    refresh_display = false;
+
+    while (executed < budget && refresh_display == false) {
+        int native = this->rom_->entry(this, this->state_, this->input_, budget - executed, refresh_display);
+        executed += native;
+
+        if (native == 0 && refresh_display == false) {
+            // No block can be entered at this address, interpret a single instruction
+            uint16_t program_counter = this->state_->programCounter();
+            uint8_t ms_op_code = this->state_->memoryValue(program_counter);
+            uint8_t ls_op_code = this->state_->memoryValue(program_counter + 1);
+            uint16_t op_code = ((uint16_t)ms_op_code << 8) | ls_op_code;
+
+            const OpCodeEntry& entry = OP_CODE_TABLE.lookup(op_code, this->rom_->quirks);
+            this->state_->setProgramCounter(program_counter + 2);
+            executed++;
+            entry.execute(this->state_, this->input_, Instruction(op_code));
+            refresh_display = entry.refreshes_display;
+        }
+    }
+
+    return executed;
+}
+
+void RecompiledProgram::onMemoryWrite(uint16_t address) {
+    if (address >= this->address_blocks_.size()) {
+        return;
+    }
+
+    // Writing back the recompiled data, such as reloading the ROM, leaves the blocks valid
+    int offset = address - INITAL_PROGRAM_COUNTER;
+    if (offset >= 0 && offset < this->rom_->image_size && this->state_->memoryValue(address) == this->rom_->image[offset]) {
+        return;
+    }
+
+    for (int block : this->address_blocks_[address]) {
+        this->dirty_[block] = true;
+    }
+}
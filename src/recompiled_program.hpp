@@ -0,0 +1,157 @@
+/**
+ * @file recompiled_program.hpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Definition of the runtime support for ROMs recompiled ahead of time into C++
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef RECOMPILED_PROGRAM_HPP
+#define RECOMPILED_PROGRAM_HPP
+
+#include <iostream>
+#include <vector>
+#include "chip-8_state.hpp"
+#include "quirks.hpp"
+#include "input/input_interface.hpp"
+
+using namespace std;
+
+class RecompiledProgram;
+
+/**
+ * @brief Function generated for a ROM by chip-8-recompile
+ *
+ * Runs the recompiled blocks starting at the current program counter, chaining them until the budget is spent,
+ * the display was modified, or an address without a clean recompiled block is reached.
+ *
+ * @param program The runtime tracking which blocks are still valid
+ * @param state The state the ROM operates on
+ * @param input Interface used by the instructions that read input
+ * @param budget The maximum number of instructions to execute
+ * @param refresh_display Set to true if the display must be refreshed
+ * @return int The number of instructions executed, 0 if no block could be entered
+ */
+typedef int (*RecompiledEntry)(
+    RecompiledProgram* program,
+    CHIP8_State* state,
+    InputInterface* input,
+    int budget,
+    bool& refresh_display);
+
+/**
+ * @brief Range of memory covered by a recompiled block
+ *
+ */
+struct RecompiledBlock {
+    // Address of the first instruction
+    uint16_t start;
+
+    // Address following the last instruction
+    uint16_t end;
+};
+
+/**
+ * @brief Description of a ROM recompiled into C++, emitted by chip-8-recompile
+ *
+ */
+struct RecompiledRom {
+    // The original ROM data, loaded at INITAL_PROGRAM_COUNTER
+    const uint8_t* image;
+
+    // Size of the ROM data in bytes
+    uint16_t image_size;
+
+    // Memory covered by each block, indexed by block number
+    const RecompiledBlock* blocks;
+
+    // Number of blocks
+    int block_count;
+
+    // Entry point of the generated code
+    RecompiledEntry entry;
+
+    // Quirks reproduced by the generated code, and by the instructions interpreted around it
+    QuirkProfile quirks;
+};
+
+/**
+ * @brief Runs a recompiled ROM, falling back to the interpreter for anything that was not recompiled
+ *
+ * Blocks whose memory is written to at runtime are marked dirty and are interpreted from then on, so self
+ * modifying code keeps working.
+ */
+class RecompiledProgram : public MemoryWriteListener
+{
+
+public:
+
+    /**
+     * @brief Construct a new Recompiled Program and start listening to memory writes on the state
+     *
+     * Blocks are only considered clean if the state memory holds the ROM they were recompiled from.
+     *
+     * @param rom The recompiled ROM
+     * @param state The state the ROM operates on
+     * @param input Interface used by the instructions that read input
+     */
+    RecompiledProgram(const RecompiledRom* rom, CHIP8_State* state, InputInterface* input);
+
+    /**
+     * @brief Destroy the Recompiled Program object and stop listening to memory writes
+     *
+     */
+    ~RecompiledProgram();
+
+    /**
+     * @brief Executes the provided number of instructions
+     *
+     * Returns early after any instruction modifying the display, so the display can be refreshed.
+     *
+     * @param budget The number of instructions to execute
+     * @param refresh_display Set to true if the display must be refreshed
+     * @return int The number of instructions executed
+     */
+    int run(int budget, bool& refresh_display);
+
+    /**
+     * @brief Whether a block was modified since it was recompiled. Called by the generated code.
+     *
+     * @param block The block number
+     * @return true If the block must be interpreted
+     */
+    inline bool isDirty(int block) {
+        return this->dirty_[block];
+    }
+
+    /**
+     * @brief The quirks the ROM was recompiled with
+     *
+     */
+    inline QuirkProfile quirkProfile() {
+        return this->rom_->quirks;
+    }
+
+    /**
+     * @brief Marks every block covering the address as dirty, unless it still holds the recompiled data
+     *
+     * @param address The memory address that was written to
+     */
+    virtual void onMemoryWrite(uint16_t address);
+
+private:
+
+    const RecompiledRom* rom_;
+
+    CHIP8_State* state_;
+
+    InputInterface* input_;
+
+    // One flag per block, set once the block memory was modified
+    vector<bool> dirty_;
+
+    // Blocks covering each memory address
+    vector<vector<int>> address_blocks_;
+};
+
+#endif
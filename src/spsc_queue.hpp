@@ -0,0 +1,94 @@
+/**
+ * @file spsc_queue.hpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Definition of a lock-free queue handing values from one thread to another
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+
+using namespace std;
+
+/**
+ * @brief A bounded first in first out queue with a single writing thread and a single reading thread
+ *
+ * Values are stored in a ring. The writer only moves the tail and the reader only moves the head, each publishing
+ * its index with a release store, so neither ever waits. Values pushed while the queue is full are refused.
+ *
+ * @tparam T The value queued, copied in place
+ * @tparam CAPACITY The number of values the queue holds, a power of two
+ */
+template <typename T, size_t CAPACITY>
+class SpscQueue
+{
+    static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "The capacity must be a power of two");
+
+public:
+    /**
+     * @brief Construct a new empty Spsc Queue object
+     *
+     */
+    SpscQueue() : head_(0), tail_(0) {}
+
+    /**
+     * @brief Appends a value, called by the writer only
+     *
+     * @param value The value to copy at the end of the queue
+     * @return true The value was queued
+     * @return false The queue is full, the value was dropped
+     */
+    bool push(const T& value) {
+        size_t tail = this->tail_.load(memory_order_relaxed);
+        if (tail - this->head_.load(memory_order_acquire) == CAPACITY) {
+            return false;
+        }
+        this->values_[tail & MASK] = value;
+        this->tail_.store(tail + 1, memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest value, called by the reader only
+     *
+     * @param value Receives the oldest value
+     * @return true A value was removed
+     * @return false The queue is empty, value is unchanged
+     */
+    bool pop(T& value) {
+        size_t head = this->head_.load(memory_order_relaxed);
+        if (head == this->tail_.load(memory_order_acquire)) {
+            return false;
+        }
+        value = this->values_[head & MASK];
+        this->head_.store(head + 1, memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Whether nothing is queued, exact for the reader only
+     *
+     */
+    bool empty() const {
+        return this->head_.load(memory_order_acquire) == this->tail_.load(memory_order_acquire);
+    }
+
+private:
+
+    static const size_t MASK = CAPACITY - 1;
+
+    T values_[CAPACITY];
+
+    // Each index is written by a different thread, they are kept on separate cache lines
+    char padding_head_[64];
+    atomic<size_t> head_;
+    char padding_tail_[64];
+    atomic<size_t> tail_;
+};
+
+#endif
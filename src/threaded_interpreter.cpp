@@ -0,0 +1,324 @@
+/**
+ * @file threaded_interpreter.cpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Implementation of the threaded code interpreter
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <iostream>
+#include "chip-8_state.hpp"
+#include "dispatch.hpp"
+#include "instruction.hpp"
+#include "instruction_cache.hpp"
+#include "threaded_interpreter.hpp"
+#include "input/input_interface.hpp"
+
+// Labels as values are a GNU extension supported by both GCC and Clang
+#if defined(__GNUC__)
+#define THREADED_DISPATCH 1
+#else
+#define THREADED_DISPATCH 0
+#endif
+
+using namespace std;
+
+ThreadedInterpreter::ThreadedInterpreter(CHIP8_State* state, InputInterface* input, InstructionCache* instruction_cache) {
+    this->state_ = state;
+    this->input_ = input;
+    this->instruction_cache_ = instruction_cache;
+}
+
+int ThreadedInterpreter::run(int budget, bool& refresh_display) {
+    // The quirks are picked once per batch, each policy has its own copy of the dispatch loop
+    return WithQuirks(this->instruction_cache_->quirkProfile(), [&](auto quirks) {
+        return this->runWith<decltype(quirks)>(budget, refresh_display);
+    });
+}
+
+template <typename Quirks>
+int ThreadedInterpreter::runWith(int budget, bool& refresh_display) {
+    CHIP8_State* state = this->state_;
+    InputInterface* input = this->input_;
+    InstructionCache* instruction_cache = this->instruction_cache_;
+    uint8_t* v_registers = state->data_->v_registers;
+
+    const MicroOp* micro_op;
+    int executed = 0;
+    refresh_display = false;
+
+// Fetches the next instruction and moves the program counter forward, the same way the interpreter does
+#define FETCH() \
+    if (executed == budget) { \
+        goto done; \
+    } \
+    executed++; \
+    micro_op = &instruction_cache->fetch(state->data_->program_counter); \
+    state->data_->program_counter += 2
+
+// Handler of a micro op, the handlers of fused sequences follow the op code handlers
+#define HANDLER_INDEX(micro_op) \
+    ((micro_op)->fused == FUSED_NONE ? (int)(micro_op)->id : OP_CODE_ID_COUNT + (micro_op)->fused)
+
+#if THREADED_DISPATCH
+
+    // Must be listed in the same order as OpCodeId, followed by FusedOpId
+    static void* const handlers[OP_CODE_ID_COUNT + FUSED_OP_ID_COUNT] = {
+        &&HANDLER_OP_UNUSED, &&HANDLER_OP_NOT_IMPLEMENTED,
+        &&HANDLER_OP_00E0, &&HANDLER_OP_00EE, &&HANDLER_OP_1NNN, &&HANDLER_OP_2NNN, &&HANDLER_OP_3XNN,
+        &&HANDLER_OP_4XNN, &&HANDLER_OP_5XY0, &&HANDLER_OP_6XNN, &&HANDLER_OP_7XNN,
+        &&HANDLER_OP_8XY0, &&HANDLER_OP_8XY1, &&HANDLER_OP_8XY2, &&HANDLER_OP_8XY3, &&HANDLER_OP_8XY4,
+        &&HANDLER_OP_8XY5, &&HANDLER_OP_8XY6, &&HANDLER_OP_8XY7, &&HANDLER_OP_8XYE,
+        &&HANDLER_OP_9XY0, &&HANDLER_OP_ANNN, &&HANDLER_OP_BNNN, &&HANDLER_OP_CNNN, &&HANDLER_OP_DXYN,
+        &&HANDLER_OP_EX9E, &&HANDLER_OP_EXA1,
+        &&HANDLER_OP_FX07, &&HANDLER_OP_FX0A, &&HANDLER_OP_FX15, &&HANDLER_OP_FX18, &&HANDLER_OP_FX1E,
+        &&HANDLER_OP_FX29, &&HANDLER_OP_FX33, &&HANDLER_OP_FX55, &&HANDLER_OP_FX65,
+        &&HANDLER_OP_00CN, &&HANDLER_OP_00FB, &&HANDLER_OP_00FC, &&HANDLER_OP_00FD, &&HANDLER_OP_00FE,
+        &&HANDLER_OP_00FF, &&HANDLER_OP_FX30, &&HANDLER_OP_FX75, &&HANDLER_OP_FX85,
+        &&HANDLER_OP_00DN, &&HANDLER_OP_5XY2, &&HANDLER_OP_5XY3, &&HANDLER_OP_F000, &&HANDLER_OP_FN01,
+        &&HANDLER_OP_0230,
+        &&unfused, &&HANDLER_FUSED_SKIP_JUMP, &&HANDLER_FUSED_LOAD_CHAIN, &&HANDLER_FUSED_LOAD_DRAW,
+        &&HANDLER_FUSED_TIMER_WAIT, &&HANDLER_FUSED_JUMP_SELF
+    };
+
+#define HANDLER(id) HANDLER_##id
+#define FUSED_HANDLER(id) HANDLER_##id
+#define DISPATCH() \
+    FETCH(); \
+    goto *handlers[HANDLER_INDEX(micro_op)]
+
+    DISPATCH();
+    {
+
+#else
+
+#define HANDLER(id) case id
+#define FUSED_HANDLER(id) case OP_CODE_ID_COUNT + id
+#define DISPATCH() goto dispatch
+
+dispatch:
+    FETCH();
+    switch (HANDLER_INDEX(micro_op)) {
+
+#endif
+
+    HANDLER(OP_1NNN):
+        state->data_->program_counter = micro_op->instruction.nnn;
+        DISPATCH();
+
+    HANDLER(OP_3XNN):
+        if (v_registers[micro_op->instruction.x] == micro_op->instruction.nn) {
+            state->data_->program_counter += 2;
+        }
+        DISPATCH();
+
+    HANDLER(OP_4XNN):
+        if (v_registers[micro_op->instruction.x] != micro_op->instruction.nn) {
+            state->data_->program_counter += 2;
+        }
+        DISPATCH();
+
+    HANDLER(OP_5XY0):
+        if (v_registers[micro_op->instruction.x] == v_registers[micro_op->instruction.y]) {
+            state->data_->program_counter += 2;
+        }
+        DISPATCH();
+
+    HANDLER(OP_6XNN):
+        v_registers[micro_op->instruction.x] = micro_op->instruction.nn;
+        DISPATCH();
+
+    HANDLER(OP_7XNN):
+        v_registers[micro_op->instruction.x] += micro_op->instruction.nn;
+        DISPATCH();
+
+    HANDLER(OP_8XY0):
+        v_registers[micro_op->instruction.x] = v_registers[micro_op->instruction.y];
+        DISPATCH();
+
+    HANDLER(OP_8XY1):
+        v_registers[micro_op->instruction.x] |= v_registers[micro_op->instruction.y];
+        if (Quirks::LOGIC_RESETS_VF) {
+            v_registers[0xF] = 0;
+        }
+        DISPATCH();
+
+    HANDLER(OP_8XY2):
+        v_registers[micro_op->instruction.x] &= v_registers[micro_op->instruction.y];
+        if (Quirks::LOGIC_RESETS_VF) {
+            v_registers[0xF] = 0;
+        }
+        DISPATCH();
+
+    HANDLER(OP_8XY3):
+        v_registers[micro_op->instruction.x] ^= v_registers[micro_op->instruction.y];
+        if (Quirks::LOGIC_RESETS_VF) {
+            v_registers[0xF] = 0;
+        }
+        DISPATCH();
+
+    HANDLER(OP_9XY0):
+        if (v_registers[micro_op->instruction.x] != v_registers[micro_op->instruction.y]) {
+            state->data_->program_counter += 2;
+        }
+        DISPATCH();
+
+    HANDLER(OP_ANNN):
+        state->data_->index_register = micro_op->instruction.nnn;
+        DISPATCH();
+
+    HANDLER(OP_FX07):
+        v_registers[micro_op->instruction.x] = state->data_->delay_timer;
+        DISPATCH();
+
+    HANDLER(OP_FX1E):
+        state->data_->index_register += v_registers[micro_op->instruction.x];
+        DISPATCH();
+
+    HANDLER(OP_00E0):
+    HANDLER(OP_DXYN):
+    HANDLER(OP_00CN):
+    HANDLER(OP_00FB):
+    HANDLER(OP_00FC):
+    HANDLER(OP_00FE):
+    HANDLER(OP_00FF):
+    HANDLER(OP_00DN):
+    HANDLER(OP_0230):
+        // Return so the display can be refreshed
+        micro_op->execute(state, input, micro_op->instruction);
+        refresh_display = true;
+        goto done;
+
+    FUSED_HANDLER(FUSED_SKIP_JUMP): {
+        // The jump is only executed when the condition does not skip it
+        if (executed == budget) {
+            goto unfused;
+        }
+
+        uint8_t vx = v_registers[micro_op->instruction.x];
+        bool skip;
+        if (micro_op->id == OP_3XNN) {
+            skip = vx == micro_op->instruction.nn;
+        } else if (micro_op->id == OP_4XNN) {
+            skip = vx != micro_op->instruction.nn;
+        } else if (micro_op->id == OP_5XY0) {
+            skip = vx == v_registers[micro_op->instruction.y];
+        } else {
+            skip = vx != v_registers[micro_op->instruction.y];
+        }
+
+        if (skip) {
+            state->data_->program_counter += 2;
+        } else {
+            executed++;
+            state->data_->program_counter = (micro_op + 1)->instruction.nnn;
+        }
+        DISPATCH();
+    }
+
+    FUSED_HANDLER(FUSED_LOAD_CHAIN): {
+        int length = micro_op->fused_length;
+        if (budget - executed < length - 1) {
+            goto unfused;
+        }
+
+        for (int i = 0; i < length; i++) {
+            v_registers[(micro_op + i)->instruction.x] = (micro_op + i)->instruction.nn;
+        }
+        executed += length - 1;
+        state->data_->program_counter += 2 * (length - 1);
+        DISPATCH();
+    }
+
+    FUSED_HANDLER(FUSED_LOAD_DRAW): {
+        if (executed == budget) {
+            goto unfused;
+        }
+
+        state->data_->index_register = micro_op->instruction.nnn;
+        executed++;
+        state->data_->program_counter += 2;
+        (micro_op + 1)->execute(state, input, (micro_op + 1)->instruction);
+        refresh_display = true;
+        goto done;
+    }
+
+    FUSED_HANDLER(FUSED_TIMER_WAIT): {
+        int remaining = budget - executed;
+        uint8_t delay_timer = state->data_->delay_timer;
+
+        if (delay_timer == 0) {
+            // The delay has run out, 3X00 skips over the jump
+            if (remaining < 1) {
+                goto unfused;
+            }
+            v_registers[micro_op->instruction.x] = 0;
+            executed++;
+            state->data_->program_counter += 4;
+        } else {
+            // Timers only change once control returns to CHIP8, so the loop spins until the budget is spent
+            if (remaining < 2) {
+                goto unfused;
+            }
+            int iterations = (remaining - 2) / 3;
+            v_registers[micro_op->instruction.x] = delay_timer;
+            executed += 2 + 3 * iterations;
+            state->data_->program_counter = (micro_op + 2)->instruction.nnn;
+        }
+        DISPATCH();
+    }
+
+    FUSED_HANDLER(FUSED_JUMP_SELF):
+        // Nothing can change until control returns to CHIP8, spend the whole budget on the jump
+        executed = budget;
+        state->data_->program_counter = micro_op->instruction.nnn;
+        goto done;
+
+    HANDLER(OP_UNUSED):
+    HANDLER(OP_NOT_IMPLEMENTED):
+    HANDLER(OP_00EE):
+    HANDLER(OP_2NNN):
+    HANDLER(OP_8XY4):
+    HANDLER(OP_8XY5):
+    HANDLER(OP_8XY6):
+    HANDLER(OP_8XY7):
+    HANDLER(OP_8XYE):
+    HANDLER(OP_BNNN):
+    HANDLER(OP_CNNN):
+    HANDLER(OP_EX9E):
+    HANDLER(OP_EXA1):
+    HANDLER(OP_FX0A):
+    HANDLER(OP_FX15):
+    HANDLER(OP_FX18):
+    HANDLER(OP_FX29):
+    HANDLER(OP_FX33):
+    HANDLER(OP_FX55):
+    HANDLER(OP_FX65):
+    HANDLER(OP_00FD):
+    HANDLER(OP_FX30):
+    HANDLER(OP_FX75):
+    HANDLER(OP_FX85):
+    HANDLER(OP_5XY2):
+    HANDLER(OP_5XY3):
+    HANDLER(OP_F000):
+    HANDLER(OP_FN01):
+    unfused:
+        // Sequences that do not fit in the remaining budget execute their first instruction on its own
+        micro_op->execute(state, input, micro_op->instruction);
+        DISPATCH();
+
+#if !THREADED_DISPATCH
+    default:
+        break;
+#endif
+    }
+
+#undef FETCH
+#undef HANDLER_INDEX
+#undef HANDLER
+#undef FUSED_HANDLER
+#undef DISPATCH
+
+done:
+    return executed;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file threaded_interpreter.hpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Definition of the threaded code interpreter used by the threaded execution mode
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef THREADED_INTERPRETER_HPP
+#define THREADED_INTERPRETER_HPP
+
+#include <iostream>
+#include "chip-8_state.hpp"
+#include "instruction_cache.hpp"
+#include "input/input_interface.hpp"
+
+using namespace std;
+
+/**
+ * @brief Interpreter in which every handler jumps straight to the handler of the next instruction
+ *
+ * Instructions are fetched from the instruction cache and dispatched with computed goto when the compiler
+ * supports it, falling back to a single switch statement otherwise. The most frequent register and control flow
+ * instructions are handled inline, every other instruction runs through its regular op code handler. Sequences
+ * fused by the instruction cache are executed by a single handler. The loop is instantiated for every quirk
+ * policy, following the quirk profile of the instruction cache.
+ */
+class ThreadedInterpreter
+{
+
+public:
+
+    /**
+     * @brief Construct a new Threaded Interpreter
+     *
+     * @param state The state instructions operate on
+     * @param input Interface used by the instructions that read input
+     * @param instruction_cache Cache the instructions are fetched from
+     */
+    ThreadedInterpreter(CHIP8_State* state, InputInterface* input, InstructionCache* instruction_cache);
+
+    /**
+     * @brief Executes the provided number of instructions
+     *
+     * Returns early after any instruction modifying the display, so the display can be refreshed.
+     *
+     * @param budget The number of instructions to execute
+     * @param refresh_display Set to true if the display must be refreshed
+     * @return int The number of instructions executed
+     */
+    int run(int budget, bool& refresh_display);
+
+private:
+
+    /**
+     * @brief Executes the provided number of instructions with the quirks of a policy
+     *
+     * @tparam Quirks The quirk policy, such as VipQuirks
+     */
+    template <typename Quirks>
+    int runWith(int budget, bool& refresh_display);
+
+    CHIP8_State* state_;
+
+    InputInterface* input_;
+
+    InstructionCache* instruction_cache_;
+};
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ * @file triple_buffer.hpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Definition of a lock-free triple buffer handing values from one thread to another
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef TRIPLE_BUFFER_HPP
+#define TRIPLE_BUFFER_HPP
+
+#include <atomic>
+#include <iostream>
+
+using namespace std;
+
+/**
+ * @brief Hands the newest value written by one thread to one reading thread, without either ever waiting
+ *
+ * The writer fills the back buffer and publishes it by swapping it with the middle buffer. The reader swaps the
+ * middle buffer with its front buffer when a new value was published. Values published while the reader is busy
+ * replace each other, so the reader always gets the newest one.
+ *
+ * @tparam T The value handed over, copied in place by the writer
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+    /**
+     * @brief Construct a new Triple Buffer object
+     *
+     */
+    TripleBuffer() : middle_(1) {
+        this->back_ = 0;
+        this->front_ = 2;
+    }
+
+    /**
+     * @brief The buffer owned by the writer, filled before calling publish
+     *
+     * @return T& The back buffer
+     */
+    T& writeBuffer() {
+        return this->buffers_[this->back_];
+    }
+
+    /**
+     * @brief Makes the back buffer available to the reader, the writer gets a new back buffer
+     *
+     */
+    void publish() {
+        uint8_t previous = this->middle_.exchange(this->back_ | FRESH, memory_order_acq_rel);
+        this->back_ = previous & INDEX;
+    }
+
+    /**
+     * @brief Whether a value was published since the reader last updated
+     *
+     */
+    bool fresh() const {
+        return (this->middle_.load(memory_order_acquire) & FRESH) != 0;
+    }
+
+    /**
+     * @brief Moves the newest published value to the front buffer
+     *
+     * @return true A new value is in the front buffer
+     * @return false Nothing was published, the front buffer is unchanged
+     */
+    bool update() {
+        if (!this->fresh()) {
+            return false;
+        }
+        uint8_t previous = this->middle_.exchange(this->front_, memory_order_acq_rel);
+        this->front_ = previous & INDEX;
+        return true;
+    }
+
+    /**
+     * @brief The buffer owned by the reader, holding the last value taken with update
+     *
+     * @return const T& The front buffer
+     */
+    const T& readBuffer() const {
+        return this->buffers_[this->front_];
+    }
+
+private:
+
+    // The middle index is stored with a flag set when it holds a value the reader has not seen
+    static const uint8_t INDEX = 0x3;
+    static const uint8_t FRESH = 0x4;
+
+    T buffers_[3];
+
+    // Each index is used by a different thread, they are kept on separate cache lines
+    char padding_back_[64];
+    uint8_t back_;
+    char padding_middle_[64];
+    atomic<uint8_t> middle_;
+    char padding_front_[64];
+    uint8_t front_;
+};
+
+#endif
@@ -0,0 +1,166 @@
+/**
+ * @brief Helpers comparing an execution mode against the interpreter by running the same program on both
+ *
+ */
+#ifndef DIFFERENTIAL_HPP
+#define DIFFERENTIAL_HPP
+
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "../src/chip-8.hpp"
+#include "../src/chip-8_state.hpp"
+#include "../src/recompiled_program.hpp"
+#include "../src/display/null_display.hpp"
+#include "../src/input/mock_input.hpp"
+
+using namespace std;
+
+/**
+ * @brief An emulator paired with the state and devices it runs on
+ *
+ */
+struct Machine {
+    CHIP8_State* state;
+    NullDisplay* display;
+    MockInput* input;
+    CHIP8* chip_8;
+};
+
+inline Machine createMachine(
+    const vector<char>& program,
+    ExecutionMode mode,
+    const RecompiledRom* recompiled = NULL,
+    QuirkProfile profile = QuirkProfile::Modern) {
+
+    // Registers, memory and display start cleared so both machines begin from the same state
+    uint8_t* memory = new uint8_t[RAM_SIZE]();
+    uint8_t* v_registers = new uint8_t[V_REGISTER_COUNT]();
+
+    Machine machine;
+    machine.state = new CHIP8_State(INITAL_PROGRAM_COUNTER, 0, 0, 0, v_registers, memory);
+    for (int x = 0; x < DISPLAY_WIDTH; x++) {
+        for (int y = 0; y < DISPLAY_HEIGHT; y++) {
+            machine.state->setDisplayValue(x, y, false);
+        }
+    }
+
+    machine.display = new NullDisplay();
+    machine.input = new MockInput();
+    machine.chip_8 = new CHIP8(machine.display, machine.input, machine.state);
+    machine.chip_8->SetQuirkProfile(profile);
+    if (recompiled != NULL) {
+        machine.chip_8->LoadRecompiledRom(recompiled);
+    }
+    machine.chip_8->SetExecutionMode(mode);
+
+    vector<char> rom = program;
+    machine.chip_8->LoadRom(&rom);
+    return machine;
+}
+
+inline void deleteMachine(Machine& machine) {
+    delete machine.chip_8;
+    delete machine.input;
+    delete machine.display;
+    delete machine.state;
+}
+
+/**
+ * @brief Converts a list of op codes into rom data
+ *
+ */
+inline vector<char> assemble(const vector<uint16_t>& op_codes) {
+    vector<char> rom;
+    for (uint16_t op_code : op_codes) {
+        rom.push_back((char)(op_code >> 8));
+        rom.push_back((char)(op_code & 0xFF));
+    }
+    return rom;
+}
+
+/**
+ * @brief Asserts both machines reached the exact same state
+ *
+ */
+inline void assertSameState(Machine& expected, Machine& actual) {
+    for (uint8_t i = 0; i < V_REGISTER_COUNT; i++) {
+        assert(expected.state->vRegister(i) == actual.state->vRegister(i));
+    }
+    assert(expected.state->indexRegister() == actual.state->indexRegister());
+    assert(expected.state->programCounter() == actual.state->programCounter());
+    assert(expected.state->stackPointer() == actual.state->stackPointer());
+    assert(expected.state->delayTimer() == actual.state->delayTimer());
+    assert(expected.state->soundTimer() == actual.state->soundTimer());
+
+    for (int i = 0; i < RAM_SIZE; i++) {
+        assert(expected.state->memoryValue(i) == actual.state->memoryValue(i));
+    }
+
+    assert(expected.state->displayMode() == actual.state->displayMode());
+    assert(expected.state->exited() == actual.state->exited());
+    FrameBufferView expected_frame = expected.state->displayView();
+    FrameBufferView actual_frame = actual.state->displayView();
+    for (int x = 0; x < expected_frame.width; x++) {
+        for (int y = 0; y < expected_frame.height; y++) {
+            assert(expected_frame.pixel(x, y) == actual_frame.pixel(x, y));
+        }
+    }
+
+    assert(expected.display->updateCount() == actual.display->updateCount());
+}
+
+/**
+ * @brief Runs a program with the interpreter and another execution mode, comparing both states every few frames
+ *
+ * @param mode The execution mode compared against the interpreter
+ * @param program The rom data to run
+ * @param frames The total number of frames to run
+ * @param step The number of frames to run between comparisons
+ * @param recompiled (optional) The program recompiled ahead of time, required by the recompiled mode
+ * @param profile (optional) The quirks reproduced by both machines, the ones of the recompiled program if provided
+ */
+inline void runDifferential(
+    ExecutionMode mode,
+    const vector<char>& program,
+    int frames,
+    int step,
+    const RecompiledRom* recompiled = NULL,
+    QuirkProfile profile = QuirkProfile::Modern) {
+
+    if (recompiled != NULL) {
+        profile = recompiled->quirks;
+    }
+    Machine interpreter = createMachine(program, ExecutionMode::Interpreter, NULL, profile);
+    Machine tested = createMachine(program, mode, recompiled, profile);
+    assert(tested.chip_8->executionMode() == mode);
+
+    bool interpreter_failed = false;
+    bool tested_failed = false;
+
+    for (int frame = 0; frame < frames && !interpreter_failed; frame += step) {
+        // Both machines draw the same random numbers from their own generators, seeded alike
+        try {
+            assert(interpreter.chip_8->ProcessFrames(step) == step);
+        } catch (exception& e) {
+            interpreter_failed = true;
+        }
+
+        try {
+            assert(tested.chip_8->ProcessFrames(step) == step);
+        } catch (exception& e) {
+            tested_failed = true;
+        }
+
+        assert(interpreter_failed == tested_failed);
+        if (!interpreter_failed) {
+            assertSameState(interpreter, tested);
+        }
+    }
+
+    deleteMachine(interpreter);
+    deleteMachine(tested);
+}
+
+#endif
@@ -0,0 +1,217 @@
+#include <cassert>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include "../src/chip-8.hpp"
+#include "../src/io.hpp"
+#include "../src/display/ansi_display.hpp"
+#include "../src/input/mock_input.hpp"
+
+using namespace std;
+
+/**
+ * @brief Reads everything currently available in a pipe
+ *
+ */
+string drain(int fd) {
+    string output;
+    char buffer[4096];
+    ssize_t count;
+    while ((count = read(fd, buffer, sizeof(buffer))) > 0) {
+        output.append(buffer, count);
+    }
+    return output;
+}
+
+/**
+ * @brief Ensures only the cells that changed are written, with one write per update
+ *
+ */
+void testDiff() {
+    int pipe_fds[2];
+    assert(pipe(pipe_fds) == 0);
+    fcntl(pipe_fds[0], F_SETFL, O_NONBLOCK);
+
+    AnsiDisplay* display = new AnsiDisplay(pipe_fds[1]);
+    uint64_t rows[DISPLAY_HEIGHT];
+    memset(rows, 0, sizeof(rows));
+    FrameBufferView frame = {rows, DISPLAY_WIDTH, DISPLAY_HEIGHT};
+    DisplayDamage damage;
+
+    // The first frame clears the screen
+    rows[0] = 0x8000000000000000;
+    display->updateDisplay(frame, damage);
+    assert(drain(pipe_fds[0]) == "\x1b[?25l\x1b[2J\x1b[1;1H██");
+    assert(display->writeCount() == 1);
+
+    // An unchanged frame writes nothing
+    display->updateDisplay(frame, damage);
+    assert(drain(pipe_fds[0]) == "");
+    assert(display->writeCount() == 1);
+
+    // Adjacent cells share a single cursor move
+    rows[0] = 0;
+    rows[31] = 0x0000000000000003;
+    display->updateDisplay(frame, damage);
+    assert(drain(pipe_fds[0]) == "\x1b[1;1H  \x1b[32;125H████");
+    assert(display->writeCount() == 2);
+    assert(display->bytesWritten() == 22 + 29);
+
+    // The cursor is restored below the display
+    delete display;
+    assert(drain(pipe_fds[0]) == "\x1b[33;1H\x1b[?25h");
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
+
+/**
+ * @brief Ensures half blocks pack two vertically stacked pixels in a cell
+ *
+ */
+void testHalfBlock() {
+    int pipe_fds[2];
+    assert(pipe(pipe_fds) == 0);
+    fcntl(pipe_fds[0], F_SETFL, O_NONBLOCK);
+
+    AnsiDisplay* display = new AnsiDisplay(pipe_fds[1], AnsiGlyphs::HalfBlock);
+    uint64_t rows[DISPLAY_HEIGHT];
+    memset(rows, 0, sizeof(rows));
+    FrameBufferView frame = {rows, DISPLAY_WIDTH, DISPLAY_HEIGHT};
+    DisplayDamage damage;
+
+    rows[0] = 0x8000000000000000;
+    display->updateDisplay(frame, damage);
+    assert(drain(pipe_fds[0]) == "\x1b[?25l\x1b[2J\x1b[1;1H▀");
+
+    // The cell is redrawn when its other pixel changes, columns are a single character wide
+    rows[1] = 0xC000000000000000;
+    rows[31] = 0x0000000000000001;
+    display->updateDisplay(frame, damage);
+    assert(drain(pipe_fds[0]) == "\x1b[1;1H█▄\x1b[16;64H▄");
+
+    // The cursor is restored below the 16 cell rows
+    delete display;
+    assert(drain(pipe_fds[0]) == "\x1b[17;1H\x1b[?25h");
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
+
+/**
+ * @brief Ensures braille patterns pack two by four pixels in a cell
+ *
+ */
+void testBraille() {
+    int pipe_fds[2];
+    assert(pipe(pipe_fds) == 0);
+    fcntl(pipe_fds[0], F_SETFL, O_NONBLOCK);
+
+    AnsiDisplay* display = new AnsiDisplay(pipe_fds[1], AnsiGlyphs::Braille);
+    uint64_t rows[DISPLAY_HEIGHT];
+    memset(rows, 0, sizeof(rows));
+    FrameBufferView frame = {rows, DISPLAY_WIDTH, DISPLAY_HEIGHT};
+    DisplayDamage damage;
+
+    // Bottom right pixel of the first cell is dot 8, U+2880
+    rows[3] = 0x4000000000000000;
+    display->updateDisplay(frame, damage);
+    assert(drain(pipe_fds[0]) == "\x1b[?25l\x1b[2J\x1b[1;1H\u2880");
+
+    // Top left pixel adds dot 1, the last cell of the display is at row 8, column 32
+    rows[0] = 0x8000000000000000;
+    rows[28] = 0x0000000000000001;
+    display->updateDisplay(frame, damage);
+    assert(drain(pipe_fds[0]) == "\x1b[1;1H\u2881\x1b[8;32H\u2808");
+
+    // Every pattern is available, the full cell is U+28FF
+    rows[0] = rows[1] = rows[2] = rows[3] = 0xC000000000000000;
+    display->updateDisplay(frame, damage);
+    assert(drain(pipe_fds[0]) == "\x1b[1;1H\u28FF");
+
+    delete display;
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
+
+/**
+ * @brief Ensures a game costs far less than redrawing every cell on every update
+ *
+ */
+void testGameOutput(AnsiGlyphs glyphs) {
+    int null_fd = open("/dev/null", O_WRONLY);
+    assert(null_fd >= 0);
+
+    AnsiDisplay* display = new AnsiDisplay(null_fd, glyphs);
+    MockInput* input = new MockInput();
+    CHIP8* chip_8 = new CHIP8(display, input);
+    vector<char>* rom = ReadRom("../../roms/games/Brix [Andreas Gustafsson, 1990].ch8");
+    chip_8->LoadRom(rom);
+
+    RunSummary summary = chip_8->RunFrames(600);
+    assert(summary.draws > 0);
+
+    // At most one write per refresh
+    assert(display->writeCount() <= summary.draws);
+
+    // A full redraw would write two glyphs for each of the 2048 pixels
+    long full_redraw_bytes = (long)summary.draws * DISPLAY_WIDTH * DISPLAY_HEIGHT * 6;
+    assert(display->bytesWritten() * 20 < full_redraw_bytes);
+
+    delete chip_8;
+    delete display;
+    delete input;
+    delete rom;
+    close(null_fd);
+}
+
+/**
+ * @brief Ensures a frame of a different size clears the screen, high resolution pixels being one column wide
+ *
+ */
+void testResize() {
+    int pipe_fds[2];
+    assert(pipe(pipe_fds) == 0);
+    fcntl(pipe_fds[0], F_SETFL, O_NONBLOCK);
+
+    AnsiDisplay* display = new AnsiDisplay(pipe_fds[1]);
+    uint64_t rows[MAX_FRAME_BUFFER_WORDS];
+    memset(rows, 0, sizeof(rows));
+    FrameBufferView lores = {rows, DISPLAY_WIDTH, DISPLAY_HEIGHT};
+    FrameBufferView hires = {rows, HIRES_DISPLAY_WIDTH, HIRES_DISPLAY_HEIGHT};
+    DisplayDamage damage;
+
+    rows[0] = 0x8000000000000000;
+    display->updateDisplay(lores, damage);
+    drain(pipe_fds[0]);
+
+    // The second word of the last row holds the bottom right pixel
+    rows[127] = 0x0000000000000001;
+    display->updateDisplay(hires, damage);
+    assert(drain(pipe_fds[0]) == "\x1b[?25l\x1b[2J\x1b[1;1H█\x1b[64;128H█");
+
+    // Back to low resolution everything is drawn again
+    memset(rows, 0, sizeof(rows));
+    rows[1] = 0x8000000000000000;
+    display->updateDisplay(lores, damage);
+    assert(drain(pipe_fds[0]) == "\x1b[?25l\x1b[2J\x1b[2;1H██");
+
+    delete display;
+    assert(drain(pipe_fds[0]) == "\x1b[33;1H\x1b[?25h");
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
+
+int main(int argc, char** argv){
+    testDiff();
+    testHalfBlock();
+    testBraille();
+    testResize();
+    testGameOutput(AnsiGlyphs::FullBlock);
+    testGameOutput(AnsiGlyphs::HalfBlock);
+    testGameOutput(AnsiGlyphs::Braille);
+    return 0;
+}
@@ -0,0 +1,171 @@
+#include <cassert>
+#include <iostream>
+#include <vector>
+#include "../src/chip-8.hpp"
+#include "differential.hpp"
+
+using namespace std;
+
+/**
+ * @brief Ensures the timers are updated every frame, whatever the size of the batches
+ *
+ */
+void testTimers() {
+    vector<char> program = assemble({
+        0x60FF, // 0x200 V0 = 0xFF
+        0xF015, // 0x202 Delay timer = V0
+        0x1204  // 0x204 Jump to 0x204
+    });
+
+    Machine machine = createMachine(program, ExecutionMode::Interpreter);
+
+    RunSummary summary = machine.chip_8->RunCycles(INSTRUCTIONS_PER_TIMER_TICK - 1);
+    assert(summary.cycles == INSTRUCTIONS_PER_TIMER_TICK - 1);
+    assert(summary.frames == 0);
+    assert(summary.stop_reason == StopReason::Cycles);
+    assert(machine.state->delayTimer() == 0xFF);
+
+    // The frame boundary is carried across batches
+    summary = machine.chip_8->RunCycles(1);
+    assert(summary.frames == 1);
+    assert(machine.state->delayTimer() == 0xFE);
+
+    summary = machine.chip_8->RunFrames(10);
+    assert(summary.cycles == 10 * INSTRUCTIONS_PER_TIMER_TICK);
+    assert(summary.frames == 10);
+    assert(summary.stop_reason == StopReason::Frames);
+    assert(machine.state->delayTimer() == 0xF4);
+
+    // A new speed starts a new frame
+    machine.chip_8->SetInstructionsPerFrame(100);
+    summary = machine.chip_8->RunFrames(2);
+    assert(summary.cycles == 200);
+    assert(machine.state->delayTimer() == 0xF2);
+
+    deleteMachine(machine);
+}
+
+/**
+ * @brief Ensures display refreshes are counted
+ *
+ */
+void testDraws() {
+    vector<char> program = assemble({
+        0xA000, // 0x200 I = font character 0
+        0xD005, // 0x202 Draw at V0, V0
+        0x00E0, // 0x204 Clear the display
+        0x1200  // 0x206 Jump to 0x200
+    });
+
+    vector<ExecutionMode> modes = {ExecutionMode::Interpreter, ExecutionMode::Threaded, ExecutionMode::Jit};
+    for (ExecutionMode mode : modes) {
+        Machine machine = createMachine(program, mode);
+        RunSummary summary = machine.chip_8->RunCycles(400);
+        assert(summary.cycles == 400);
+        assert(summary.frames == 400 / INSTRUCTIONS_PER_TIMER_TICK);
+        assert(summary.draws == 200);
+        assert(machine.display->updateCount() == 200);
+
+        // The damage is handed to the display then forgotten
+        assert(machine.state->displayDamage().empty());
+        deleteMachine(machine);
+    }
+}
+
+/**
+ * @brief Ensures RunUntil stops on the instruction satisfying the predicate, or at its limit
+ *
+ */
+void testRunUntil() {
+    vector<char> program = assemble({
+        0x7001, // 0x200 V0 += 1
+        0x1200  // 0x202 Jump to 0x200
+    });
+
+    vector<ExecutionMode> modes = {ExecutionMode::Interpreter, ExecutionMode::Threaded, ExecutionMode::Jit};
+    for (ExecutionMode mode : modes) {
+        Machine machine = createMachine(program, mode);
+
+        RunSummary summary = machine.chip_8->RunUntil([](CHIP8_State* state) {
+            return state->vRegister(0) == 10;
+        });
+        assert(summary.stop_reason == StopReason::Predicate);
+        assert(summary.cycles == 19);
+        assert(summary.frames == 19 / INSTRUCTIONS_PER_TIMER_TICK);
+        assert(machine.state->vRegister(0) == 10);
+
+        summary = machine.chip_8->RunUntil([](CHIP8_State* state) {
+            return state->vRegister(0) == 5;
+        }, 100);
+        assert(summary.stop_reason == StopReason::CycleLimit);
+        assert(summary.cycles == 100);
+        assert(machine.state->vRegister(0) == 60);
+
+        deleteMachine(machine);
+    }
+}
+
+/**
+ * @brief Ensures coalesced presentation modes update the display once per complete frame
+ *
+ */
+void testPresentation() {
+    vector<char> program = assemble({
+        0x00E0, // 0x200 Clear the display
+        0xA000, // 0x202 I = font character 0
+        0xD005, // 0x204 Draw at V0, V0
+        0x6108, // 0x206 V1 = 8
+        0xD105, // 0x208 Draw at V1, V0
+        0x6210, // 0x20A V2 = 16
+        0xD205, // 0x20C Draw at V2, V0
+        0x1200  // 0x20E Jump to 0x200
+    });
+
+    vector<ExecutionMode> modes = {ExecutionMode::Interpreter, ExecutionMode::Threaded, ExecutionMode::Jit};
+    for (ExecutionMode mode : modes) {
+        // Frames end in the middle of the drawing loop
+        Machine machine = createMachine(program, mode);
+        machine.chip_8->SetInstructionsPerFrame(5);
+        RunSummary summary = machine.chip_8->RunFrames(80);
+        assert(summary.draws == 4 * 50);
+
+        // At most one update per frame, when the display changed
+        machine.chip_8->SetPresentationMode(PresentationMode::VBlank);
+        summary = machine.chip_8->RunFrames(80);
+        assert(summary.draws > 0);
+        assert(summary.draws <= 80);
+
+        // The frame drawn before each clear never changes
+        machine.chip_8->SetPresentationMode(PresentationMode::Clear);
+        summary = machine.chip_8->RunFrames(80);
+        assert(summary.draws <= 1);
+        assert(machine.state->clearCount() > 0);
+
+        deleteMachine(machine);
+    }
+
+    // A game that stops clearing is still presented
+    vector<char> no_clear = assemble({
+        0xA000, // 0x200 I = font character 0
+        0xD005, // 0x202 Draw at V0, V0
+        0x1204  // 0x204 Jump to 0x204
+    });
+    Machine machine = createMachine(no_clear, ExecutionMode::Interpreter);
+    machine.chip_8->SetPresentationMode(PresentationMode::Clear);
+    RunSummary summary = machine.chip_8->RunFrames(CLEAR_PRESENT_TIMEOUT_FRAMES - 1);
+    assert(summary.draws == 0);
+    summary = machine.chip_8->RunFrames(1);
+    assert(summary.draws == 1);
+    assert(machine.display->updateCount() == 1);
+    deleteMachine(machine);
+}
+
+int main(int argc, char** argv){
+
+    testTimers();
+    testDraws();
+    testRunUntil();
+    testPresentation();
+
+    return 0;
+}
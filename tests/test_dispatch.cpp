@@ -0,0 +1,164 @@
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include<vector>
+#include "../src/chip-8_state.hpp"
+#include "../src/dispatch.hpp"
+#include "../src/exceptions.hpp"
+#include "../src/op_codes.hpp"
+#include "../src/input/mock_input.hpp"
+
+using namespace std;
+
+/**
+ * @brief Returns true if the op code table throws for the provided op code
+ *
+ */
+bool throwsNotImplemented(CHIP8_State* state, InputInterface* input, uint16_t op_code) {
+    try {
+        OP_CODE_TABLE.lookup(op_code).execute(state, input, op_code);
+    } catch (OperationNotImplementedException& e) {
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Ensures only the display op codes request a refresh of the display
+ *
+ */
+void testRefreshesDisplay() {
+    assert(OP_CODE_TABLE.lookup(0x00E0).refreshes_display == true);
+    assert(OP_CODE_TABLE.lookup(0xD015).refreshes_display == true);
+    assert(OP_CODE_TABLE.lookup(0xDFFF).refreshes_display == true);
+
+    assert(OP_CODE_TABLE.lookup(0x00EE).refreshes_display == false);
+    assert(OP_CODE_TABLE.lookup(0x1200).refreshes_display == false);
+    assert(OP_CODE_TABLE.lookup(0xF055).refreshes_display == false);
+}
+
+/**
+ * @brief Ensures op codes are routed to the same handlers as their op code family
+ *
+ */
+void testDispatch() {
+    uint8_t* memory = new uint8_t[RAM_SIZE];
+    uint8_t* v_registers = new uint8_t[V_REGISTER_COUNT];
+    MockInput* input = new MockInput();
+
+    CHIP8_State* chip_8_state = new CHIP8_State(INITAL_PROGRAM_COUNTER, 0, 0, 0, v_registers, memory);
+
+    // 1NNN - Jump to address NNN
+    OP_CODE_TABLE.lookup(0x1ABC).execute(chip_8_state, input, 0x1ABC);
+    assert(chip_8_state->programCounter() == 0xABC);
+
+    // 6XNN - Sets VX to NN
+    OP_CODE_TABLE.lookup(0x6A42).execute(chip_8_state, input, 0x6A42);
+    assert(chip_8_state->vRegister(0xA) == 0x42);
+
+    // 8XY4 - Adds VY to VX
+    chip_8_state->setVRegister(0xB, 0xFF);
+    OP_CODE_TABLE.lookup(0x8AB4).execute(chip_8_state, input, 0x8AB4);
+    assert(chip_8_state->vRegister(0xA) == 0x41);
+    assert(chip_8_state->vRegister(0xF) == 1);
+
+    // FX65 - Fills V0 to VX with values from memory
+    chip_8_state->setIndexRegister(0x300);
+    chip_8_state->setMemoryValue(0x300, 0x12);
+    chip_8_state->setMemoryValue(0x301, 0x34);
+    OP_CODE_TABLE.lookup(0xF165).execute(chip_8_state, input, 0xF165);
+    assert(chip_8_state->vRegister(0) == 0x12);
+    assert(chip_8_state->vRegister(1) == 0x34);
+    assert(chip_8_state->indexRegister() == 0x302);
+
+    delete chip_8_state;
+}
+
+/**
+ * @brief Ensures op codes without a handler behave as they did with the original switch statement
+ *
+ */
+void testUnhandledOpCodes() {
+    uint8_t* memory = new uint8_t[RAM_SIZE];
+    uint8_t* v_registers = new uint8_t[V_REGISTER_COUNT];
+    MockInput* input = new MockInput();
+
+    CHIP8_State* chip_8_state = new CHIP8_State(INITAL_PROGRAM_COUNTER, 0, 0, 0, v_registers, memory);
+
+    // 0NNN is ignored
+    assert(OP_CODE_TABLE.lookup(0x0123).execute(chip_8_state, input, 0x0123) == DEFAULT_OP_CYCLES);
+    assert(chip_8_state->programCounter() == INITAL_PROGRAM_COUNTER);
+
+    // 8XY8 - 8XYD and 8XYF are treated as 9XY0
+    chip_8_state->setVRegister(0, 1);
+    chip_8_state->setVRegister(1, 2);
+    OP_CODE_TABLE.lookup(0x8018).execute(chip_8_state, input, 0x8018);
+    assert(chip_8_state->programCounter() == INITAL_PROGRAM_COUNTER + 2);
+
+    // Unknown EX and FX op codes throw
+    assert(throwsNotImplemented(chip_8_state, input, 0xE000));
+    assert(throwsNotImplemented(chip_8_state, input, 0xE09F));
+    assert(throwsNotImplemented(chip_8_state, input, 0xF000));
+    assert(throwsNotImplemented(chip_8_state, input, 0xF066));
+
+    // XO-CHIP op codes keep their CHIP-8 meaning without XO-CHIP
+    assert(throwsNotImplemented(chip_8_state, input, 0xF101));
+    chip_8_state->setVRegister(1, 2);
+    chip_8_state->setProgramCounter(INITAL_PROGRAM_COUNTER);
+    OP_CODE_TABLE.lookup(0x5012).execute(chip_8_state, input, 0x5012);
+    assert(chip_8_state->programCounter() == INITAL_PROGRAM_COUNTER);
+    chip_8_state->setVRegister(1, 1);
+    OP_CODE_TABLE.lookup(0x5013).execute(chip_8_state, input, 0x5013);
+    assert(chip_8_state->programCounter() == INITAL_PROGRAM_COUNTER + 2);
+    chip_8_state->setDisplayValue(3, 4, true);
+    OP_CODE_TABLE.lookup(0x00D2).execute(chip_8_state, input, 0x00D2);
+    assert(chip_8_state->displayValue(3, 4) == true);
+
+    delete chip_8_state;
+}
+
+/**
+ * @brief Ensures the SUPER-CHIP op codes only run on the profiles with SUPER-CHIP instructions
+ *
+ */
+void testSuperChipProfiles() {
+    MockInput* input = new MockInput();
+    CHIP8_State* state = new CHIP8_State();
+
+    // Machine code calls and unknown op codes on the COSMAC VIP and CHIP-48
+    vector<QuirkProfile> profiles = {QuirkProfile::Vip, QuirkProfile::Chip48};
+    for (QuirkProfile profile : profiles) {
+        OP_CODE_TABLE.lookup(0x00FF, profile).execute(state, input, 0x00FF);
+        assert(state->hires() == false);
+        OP_CODE_TABLE.lookup(0x00FD, profile).execute(state, input, 0x00FD);
+        assert(state->exited() == false);
+        state->setDisplayValue(3, 4, true);
+        OP_CODE_TABLE.lookup(0x00C2, profile).execute(state, input, 0x00C2);
+        assert(state->displayValue(3, 4) == true);
+        assert(state->programCounter() == INITAL_PROGRAM_COUNTER);
+
+        try {
+            OP_CODE_TABLE.lookup(0xF175, profile).execute(state, input, 0xF175);
+            assert(false);
+        } catch (OperationNotImplementedException& e) {
+        }
+    }
+
+    OP_CODE_TABLE.lookup(0x00FF, QuirkProfile::SuperChip).execute(state, input, 0x00FF);
+    assert(state->hires() == true);
+    OP_CODE_TABLE.lookup(0x00FD, QuirkProfile::SuperChip).execute(state, input, 0x00FD);
+    assert(state->exited() == true);
+
+    delete state;
+    delete input;
+}
+
+int main(int argc, char** argv){
+
+    testRefreshesDisplay();
+    testDispatch();
+    testUnhandledOpCodes();
+    testSuperChipProfiles();
+
+    return 0;
+}
@@ -0,0 +1,238 @@
+#include <cassert>
+#include <csignal>
+#include <iostream>
+#include <pthread.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "../src/chip-8.hpp"
+#include "../src/event_loop.hpp"
+#include "../src/display/display_interface.hpp"
+#include "../src/input/mock_input.hpp"
+#include "../src/jit/jit_compiler.hpp"
+#include "differential.hpp"
+
+using namespace std;
+
+/**
+ * @brief A display counting its updates and invalidations
+ *
+ */
+class CountingDisplay : public DisplayInterface
+{
+public:
+    using DisplayInterface::updateDisplay;
+
+    virtual void updateDisplay(const FrameBufferView& frame, const DisplayDamage& damage) {
+        this->updates++;
+    }
+
+    virtual void invalidate() {
+        this->invalidations++;
+    }
+
+    int updates = 0;
+    int invalidations = 0;
+};
+
+/**
+ * @brief An input reporting a key to FX0A once it was polled a number of times
+ *
+ */
+class WaitingInput : public MockInput
+{
+public:
+    virtual bool pollInput(uint8_t& key) {
+        this->polls++;
+        if (this->polls < this->polls_before_key) {
+            return false;
+        }
+        key = 0x7;
+        return true;
+    }
+
+    int polls = 0;
+    int polls_before_key = 0;
+};
+
+/**
+ * @brief Ensures the loop returns once the program exits, after running its frames at the timer rate
+ *
+ */
+void testExit() {
+    // Waits for 5 frames on the delay timer, then exits
+    Machine machine = createMachine(assemble({
+        0x6005, // 0x200 V0 = 5
+        0xF015, // 0x202 Delay timer = V0
+        0xF107, // 0x204 V1 = delay timer
+        0x3100, // 0x206 Skip if V1 == 0
+        0x1204, // 0x208 Jump to 0x204
+        0x00FD  // 0x20A Exit
+    }), ExecutionMode::Interpreter);
+
+    EventLoop* loop = new EventLoop(machine.chip_8);
+    assert(loop->run() == 0);
+    assert(machine.state->exited());
+
+    const FrameStatistics& statistics = loop->statistics();
+    assert(statistics.frames >= 5);
+    assert(statistics.frames <= 7);
+    assert(statistics.seconds >= 4.0 / FRAMES_PER_SECOND);
+    assert(statistics.instructions > 0);
+
+    delete loop;
+    deleteMachine(machine);
+}
+
+/**
+ * @brief Ensures inputs are drained when readable, closed inputs are dropped and signals stop the loop
+ *
+ */
+void testInputsAndSignals() {
+    Machine machine = createMachine(assemble({0x1200}), ExecutionMode::Interpreter);
+    EventLoop* loop = new EventLoop(machine.chip_8);
+
+    int fds[2];
+    assert(pipe(fds) == 0);
+    int reads = 0;
+    loop->addInput(fds[0], [&reads, fds]() {
+        char buffer[16];
+        reads++;
+        if (read(fds[0], buffer, sizeof(buffer)) <= 0) {
+            // Closed, the loop stops watching it and the signal then stops the loop
+            raise(SIGTERM);
+            return false;
+        }
+        return true;
+    });
+
+    assert(write(fds[1], "ab", 2) == 2);
+    close(fds[1]);
+    assert(loop->run() == SIGTERM);
+    assert(reads == 2);
+    assert(machine.state->exited() == false);
+
+    delete loop;
+    close(fds[0]);
+    deleteMachine(machine);
+}
+
+/**
+ * @brief Ensures SIGWINCH redraws the display in full without stopping the loop
+ *
+ */
+void testResize() {
+    CountingDisplay* display = new CountingDisplay();
+    MockInput* input = new MockInput();
+    CHIP8* chip_8 = new CHIP8(display, input);
+    vector<char> rom = assemble({0x1200});
+    chip_8->LoadRom(&rom);
+
+    EventLoop* loop = new EventLoop(chip_8);
+    int fds[2];
+    assert(pipe(fds) == 0);
+    loop->addInput(fds[0], [fds]() {
+        char buffer[16];
+        assert(read(fds[0], buffer, sizeof(buffer)) == 1);
+        if (buffer[0] == 'w') {
+            raise(SIGWINCH);
+        } else {
+            raise(SIGINT);
+        }
+        return true;
+    });
+
+    assert(write(fds[1], "w", 1) == 1);
+    thread interrupter([fds]() {
+        this_thread::sleep_for(chrono::milliseconds(50));
+        assert(write(fds[1], "i", 1) == 1);
+    });
+    assert(loop->run() == SIGINT);
+    interrupter.join();
+    assert(display->invalidations == 1);
+    assert(display->updates >= 1);
+
+    delete loop;
+    close(fds[0]);
+    close(fds[1]);
+    delete chip_8;
+    delete input;
+    delete display;
+}
+
+/**
+ * @brief Ensures the signals are only blocked while a loop exists
+ *
+ */
+void testSignalMask() {
+    Machine machine = createMachine(assemble({0x1200}), ExecutionMode::Interpreter);
+    sigset_t mask;
+
+    EventLoop* loop = new EventLoop(machine.chip_8);
+    pthread_sigmask(SIG_BLOCK, NULL, &mask);
+    assert(sigismember(&mask, SIGINT));
+    assert(sigismember(&mask, SIGWINCH));
+
+    delete loop;
+    pthread_sigmask(SIG_BLOCK, NULL, &mask);
+    assert(sigismember(&mask, SIGINT) == 0);
+    assert(sigismember(&mask, SIGWINCH) == 0);
+
+    deleteMachine(machine);
+}
+
+/**
+ * @brief Ensures FX0A runs again without blocking until a key is reported, whatever the execution mode
+ *
+ */
+void testWaitForKey() {
+    vector<ExecutionMode> modes = {ExecutionMode::Interpreter, ExecutionMode::Threaded};
+    if (JitCompiler::isSupported()) {
+        modes.push_back(ExecutionMode::Jit);
+    }
+
+    for (ExecutionMode mode : modes) {
+        NullDisplay* display = new NullDisplay();
+        WaitingInput* input = new WaitingInput();
+        input->polls_before_key = 1000000;
+        CHIP8_State* state = new CHIP8_State();
+        CHIP8* chip_8 = new CHIP8(display, input, state);
+        chip_8->SetExecutionMode(mode);
+        chip_8->SetIdleLoopSkipping(false);
+        vector<char> rom = assemble({
+            0x6005, // 0x200 V0 = 5
+            0xF015, // 0x202 Delay timer = V0
+            0xF20A, // 0x204 V2 = key
+            0x6101, // 0x206 V1 = 1
+            0x1208  // 0x208 Jump to itself
+        });
+        chip_8->LoadRom(&rom);
+
+        // The timers keep running while waiting
+        chip_8->RunFrames(3);
+        assert(state->programCounter() == 0x204);
+        assert(state->vRegister(1) == 0);
+        assert(state->delayTimer() == 2);
+        assert(input->polls > 3);
+
+        input->polls_before_key = input->polls + 1;
+        chip_8->RunFrames(1);
+        assert(state->vRegister(2) == 0x7);
+        assert(state->vRegister(1) == 1);
+        assert(state->programCounter() == 0x208);
+
+        delete chip_8;
+        delete state;
+        delete input;
+        delete display;
+    }
+}
+
+int main(int argc, char** argv){
+    testExit();
+    testInputsAndSignals();
+    testResize();
+    testSignalMask();
+    testWaitForKey();
+    return 0;
+}
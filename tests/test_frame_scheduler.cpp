@@ -0,0 +1,64 @@
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include "../src/frame_scheduler.hpp"
+
+using namespace std;
+
+/**
+ * @brief Ensures frames are paced on the schedule without drifting
+ *
+ */
+void testPacing() {
+    // The default 5 late frames last 20ms at this rate, longer than the host may take to wake the thread up
+    FrameScheduler scheduler(250);
+    scheduler.start();
+    for (int frame = 0; frame < 50; frame++) {
+        scheduler.endFrame(8);
+    }
+
+    const FrameStatistics& statistics = scheduler.statistics();
+    assert(statistics.frames == 50);
+    assert(statistics.instructions == 400);
+    assert(statistics.dropped_frames == 0);
+
+    // Deadlines are absolute, the run can never end before the last one
+    assert(statistics.seconds >= 0.2);
+    assert(statistics.max_jitter_us >= statistics.mean_jitter_us);
+    assert(statistics.instructionsPerSecond() > 0.0);
+    assert(statistics.instructionsPerSecond() <= 2000.0);
+}
+
+/**
+ * @brief Ensures late frames are caught up, and dropped once too far behind
+ *
+ */
+void testCatchUp() {
+    // Frames of 4ms, so oversleeping by a few milliseconds still leaves the schedule within 5 frames
+    FrameScheduler scheduler(250, 5);
+    scheduler.start();
+
+    // Slightly late frames are run back to back without dropping anything
+    this_thread::sleep_for(chrono::milliseconds(10));
+    scheduler.endFrame(1);
+    assert(scheduler.statistics().dropped_frames == 0);
+
+    // Far behind, the missed frames are dropped
+    this_thread::sleep_for(chrono::milliseconds(200));
+    scheduler.endFrame(1);
+    assert(scheduler.statistics().dropped_frames >= 40);
+
+    // Starting again clears the statistics
+    scheduler.start();
+    assert(scheduler.statistics().frames == 0);
+    assert(scheduler.statistics().dropped_frames == 0);
+}
+
+int main(int argc, char** argv){
+
+    testPacing();
+    testCatchUp();
+
+    return 0;
+}
@@ -0,0 +1,149 @@
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../src/chip-8.hpp"
+#include "../src/headless.hpp"
+#include "../src/io.hpp"
+#include "../src/display/null_display.hpp"
+#include "../src/input/scripted_input.hpp"
+
+using namespace std;
+
+/**
+ * @brief Ensures key presses are read from a script and replayed on their frames
+ *
+ */
+void testScriptedInput() {
+    ScriptedInput input;
+    istringstream script(
+        "# frame key duration\n"
+        "10 4 2\n"
+        "\n"
+        "3 A 1\n");
+    input.loadScript(script);
+
+    input.setFrame(0);
+    assert(input.isPressed(0xA) == false);
+    assert(input.getInput() == 0xA);
+
+    input.setFrame(3);
+    assert(input.isPressed(0xA) == true);
+    assert(input.isPressed(0x4) == false);
+
+    input.setFrame(11);
+    assert(input.isPressed(0x4) == true);
+    assert(input.getInput() == 0x4);
+
+    input.setFrame(12);
+    assert(input.isPressed(0x4) == false);
+    assert(input.getInput() == 0x0);
+
+    bool thrown = false;
+    istringstream invalid("10 G 2\n");
+    try {
+        input.loadScript(invalid);
+    } catch (invalid_argument& e) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+/**
+ * @brief Runs a ROM headless with the provided options
+ *
+ */
+HeadlessReport runRom(vector<char>* rom, ExecutionMode mode, const HeadlessOptions& options) {
+    ScriptedInput* input = new ScriptedInput();
+    input->addKeyPress(30, 0x4, 20);
+    input->addKeyPress(90, 0x6, 40);
+
+    NullDisplay* display = new NullDisplay();
+    CHIP8* chip_8 = new CHIP8(display, input);
+    chip_8->SetExecutionMode(mode);
+    chip_8->LoadRom(rom);
+
+    HeadlessReport report = RunHeadless(chip_8, input, options);
+
+    delete chip_8;
+    delete display;
+    delete input;
+    return report;
+}
+
+/**
+ * @brief Ensures runs stop exactly once their budget is spent
+ *
+ */
+void testBudgets() {
+    // This test assumes it is called from the test executable directory
+    vector<char>* rom = ReadRom("../../roms/games/Brix [Andreas Gustafsson, 1990].ch8");
+
+    HeadlessOptions options;
+    options.turbo = true;
+    options.instructions = 1001;
+    HeadlessReport report = runRom(rom, ExecutionMode::Interpreter, options);
+    assert(report.instructions == 1001);
+    assert(report.frames == 1001 / INSTRUCTIONS_PER_TIMER_TICK + 1);
+
+    options.instructions = 0;
+    options.frames = 25;
+    report = runRom(rom, ExecutionMode::Interpreter, options);
+    assert(report.frames == 25);
+    assert(report.instructions == 25 * INSTRUCTIONS_PER_TIMER_TICK);
+
+    // Both budgets, the first one spent ends the run
+    options.instructions = 40;
+    report = runRom(rom, ExecutionMode::Interpreter, options);
+    assert(report.instructions == 40);
+
+    bool thrown = false;
+    try {
+        runRom(rom, ExecutionMode::Interpreter, HeadlessOptions());
+    } catch (invalid_argument& e) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    delete rom;
+}
+
+/**
+ * @brief Ensures every execution mode produces the same frames for the same script
+ *
+ */
+void testModesMatch() {
+    vector<char>* rom = ReadRom("../../roms/games/Brix [Andreas Gustafsson, 1990].ch8");
+
+    HeadlessOptions options;
+    options.turbo = true;
+    options.frames = 600;
+
+    HeadlessReport expected = runRom(rom, ExecutionMode::Interpreter, options);
+    assert(expected.instructions == 600 * INSTRUCTIONS_PER_TIMER_TICK);
+
+    vector<ExecutionMode> modes = {ExecutionMode::Threaded, ExecutionMode::Jit};
+    for (ExecutionMode mode : modes) {
+        HeadlessReport report = runRom(rom, mode, options);
+        assert(report.instructions == expected.instructions);
+        assert(report.frames == expected.frames);
+        assert(report.display_hash == expected.display_hash);
+    }
+
+    // Something was drawn
+    assert(expected.display_hash != CHIP8_State().displayHash());
+
+    delete rom;
+}
+
+int main(int argc, char** argv){
+
+    testScriptedInput();
+    testBudgets();
+    testModesMatch();
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../src/chip-8.hpp"
+#include "../src/io.hpp"
+#include "differential.hpp"
+
+using namespace std;
+
+/**
+ * @brief Runs a program for a number of frames with and without idle loop skipping, comparing the results
+ *
+ * @return long The number of idle cycles skipped
+ */
+long compareSkipping(const vector<char>& program, ExecutionMode mode, int frames, int instructions_per_frame) {
+    Machine expected = createMachine(program, mode);
+    expected.chip_8->SetIdleLoopSkipping(false);
+    expected.chip_8->SetInstructionsPerFrame(instructions_per_frame);
+    Machine actual = createMachine(program, mode);
+    actual.chip_8->SetInstructionsPerFrame(instructions_per_frame);
+
+    RunSummary expected_summary = expected.chip_8->RunFrames(frames);
+    RunSummary actual_summary = actual.chip_8->RunFrames(frames);
+
+    assert(expected_summary.idle_cycles == 0);
+    assert(actual_summary.cycles == expected_summary.cycles);
+    assert(actual_summary.frames == expected_summary.frames);
+    assert(actual_summary.draws == expected_summary.draws);
+    assertSameState(expected, actual);
+
+    deleteMachine(expected);
+    deleteMachine(actual);
+    return actual_summary.idle_cycles;
+}
+
+/**
+ * @brief Ensures a jump to itself is skipped up to the timer update
+ *
+ */
+void testJumpSelf() {
+    vector<char> program = assemble({
+        0x6005, // 0x200 V0 = 5
+        0x1202  // 0x202 Jump to 0x202
+    });
+
+    assert(compareSkipping(program, ExecutionMode::Interpreter, 100, INSTRUCTIONS_PER_TIMER_TICK)
+        > 90 * (INSTRUCTIONS_PER_TIMER_TICK - 1));
+    assert(compareSkipping(program, ExecutionMode::Jit, 100, INSTRUCTIONS_PER_TIMER_TICK) > 0);
+}
+
+/**
+ * @brief Ensures a loop waiting for the delay timer is skipped until the timer runs out
+ *
+ */
+void testDelayLoop() {
+    vector<char> program = assemble({
+        0x6A20, // 0x200 VA = 0x20
+        0xFA15, // 0x202 Delay timer = VA
+        0xF007, // 0x204 V0 = Delay timer
+        0x3000, // 0x206 Skip if V0 == 0
+        0x1204, // 0x208 Jump to 0x204
+        0x7101, // 0x20A V1 += 1
+        0x1202  // 0x20C Jump to 0x202
+    });
+
+    vector<ExecutionMode> modes = {ExecutionMode::Interpreter, ExecutionMode::Threaded, ExecutionMode::Jit};
+    for (ExecutionMode mode : modes) {
+        // Two iterations are run every frame before skipping, too many for the default speed
+        compareSkipping(program, mode, 200, INSTRUCTIONS_PER_TIMER_TICK);
+        assert(compareSkipping(program, mode, 200, 50) > 0);
+    }
+
+    Machine machine = createMachine(program, ExecutionMode::Interpreter);
+    machine.chip_8->SetInstructionsPerFrame(300);
+    RunSummary summary = machine.chip_8->RunFrames(0x21);
+    assert(summary.cycles == 0x21 * 300);
+    assert(summary.idle_cycles > 0x1F * 290);
+    assert(machine.state->vRegister(1) == 1);
+    deleteMachine(machine);
+}
+
+/**
+ * @brief Ensures loops modifying registers on every iteration are not skipped
+ *
+ */
+void testBusyLoop() {
+    vector<char> program = assemble({
+        0x7001, // 0x200 V0 += 1
+        0x1200  // 0x202 Jump to 0x200
+    });
+
+    assert(compareSkipping(program, ExecutionMode::Interpreter, 100, 50) == 0);
+}
+
+/**
+ * @brief Ensures complete games reach the same state with idle loops skipped
+ *
+ */
+void testRoms() {
+    // This test assumes it is called from the test executable directory
+    vector<string> roms = {
+        "../../roms/games/Brix [Andreas Gustafsson, 1990].ch8",
+        "../../roms/games/Space Invaders [David Winter].ch8",
+        "../../roms/games/Tetris [Fran Dachille, 1991].ch8",
+        "../../roms/programs/Life [GV Samways, 1980].ch8"
+    };
+
+    for (string& path : roms) {
+        vector<char>* rom = ReadRom(path);
+        compareSkipping(*rom, ExecutionMode::Interpreter, 1000, INSTRUCTIONS_PER_TIMER_TICK);
+        compareSkipping(*rom, ExecutionMode::Threaded, 1000, 50);
+        delete rom;
+    }
+}
+
+int main(int argc, char** argv){
+
+    testJumpSelf();
+    testDelayLoop();
+    testBusyLoop();
+    testRoms();
+
+    return 0;
+}
@@ -0,0 +1,205 @@
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include<vector>
+#include "../src/chip-8_state.hpp"
+#include "../src/instruction_cache.hpp"
+#include "../src/op_codes.hpp"
+
+using namespace std;
+
+/**
+ * @brief Writes a 2 byte op code into memory at the provided address
+ *
+ */
+void writeOpCode(CHIP8_State* state, uint16_t address, uint16_t op_code) {
+    state->setMemoryValue(address, (uint8_t)(op_code >> 8));
+    state->setMemoryValue(address + 1, (uint8_t)(op_code & 0xFF));
+}
+
+/**
+ * @brief Ensures instructions are decoded into their operands
+ *
+ */
+void testFetch() {
+    CHIP8_State* chip_8_state = new CHIP8_State();
+    InstructionCache* cache = new InstructionCache(chip_8_state);
+
+    writeOpCode(chip_8_state, 0x200, 0x8AB4);
+    writeOpCode(chip_8_state, 0x202, 0xD125);
+
+    const MicroOp& add = cache->fetch(0x200);
+    assert(add.instruction.op_code == 0x8AB4);
+    assert(add.instruction.x == 0xA);
+    assert(add.instruction.y == 0xB);
+    assert(add.instruction.n == 0x4);
+    assert(add.refreshes_display == false);
+
+    const MicroOp& draw = cache->fetch(0x202);
+    assert(draw.instruction.nn == 0x25);
+    assert(draw.instruction.nnn == 0x125);
+    assert(draw.refreshes_display == true);
+
+    // Odd addresses are decoded without being cached
+    const MicroOp& odd = cache->fetch(0x201);
+    assert(odd.instruction.op_code == 0xB4D1);
+
+    delete cache;
+    delete chip_8_state;
+}
+
+/**
+ * @brief Ensures a memory write drops the cached instruction it overlaps
+ *
+ */
+void testSetMemoryValueInvalidates() {
+    CHIP8_State* chip_8_state = new CHIP8_State();
+    InstructionCache* cache = new InstructionCache(chip_8_state);
+
+    writeOpCode(chip_8_state, 0x200, 0x6001);
+    writeOpCode(chip_8_state, 0x202, 0x6102);
+    assert(cache->fetch(0x200).instruction.op_code == 0x6001);
+    assert(cache->fetch(0x202).instruction.op_code == 0x6102);
+
+    // Rewrite the least significant byte of the first instruction only
+    chip_8_state->setMemoryValue(0x201, 0x7F);
+    assert(cache->fetch(0x200).instruction.op_code == 0x607F);
+    assert(cache->fetch(0x202).instruction.op_code == 0x6102);
+
+    delete cache;
+    delete chip_8_state;
+}
+
+/**
+ * @brief Ensures FX33 and FX55 invalidate the instructions they overwrite
+ *
+ */
+void testOpCodesInvalidate() {
+    CHIP8_State* chip_8_state = new CHIP8_State(INITAL_PROGRAM_COUNTER, 0x300);
+    InstructionCache* cache = new InstructionCache(chip_8_state);
+
+    writeOpCode(chip_8_state, 0x300, 0x0000);
+    writeOpCode(chip_8_state, 0x302, 0x0000);
+    assert(cache->fetch(0x300).instruction.op_code == 0x0000);
+    assert(cache->fetch(0x302).instruction.op_code == 0x0000);
+
+    // Store 6XNN op codes over the cached instructions
+    chip_8_state->setVRegister(0, 0x61);
+    chip_8_state->setVRegister(1, 0x23);
+    chip_8_state->setVRegister(2, 0x62);
+    chip_8_state->setVRegister(3, 0x45);
+    ExecuteFX55(chip_8_state, 0xF355);
+    assert(cache->fetch(0x300).instruction.op_code == 0x6123);
+    assert(cache->fetch(0x302).instruction.op_code == 0x6245);
+
+    // BCD of 255 is written over 0x300 - 0x302
+    chip_8_state->setIndexRegister(0x300);
+    chip_8_state->setVRegister(0, 255);
+    ExecuteFX33(chip_8_state, 0xF033);
+    assert(cache->fetch(0x300).instruction.op_code == 0x0205);
+    assert(cache->fetch(0x302).instruction.op_code == 0x0545);
+
+    delete cache;
+    delete chip_8_state;
+}
+
+/**
+ * @brief Ensures common instruction sequences are fused into their first entry
+ *
+ */
+void testFusion() {
+    CHIP8_State* chip_8_state = new CHIP8_State();
+    InstructionCache* cache = new InstructionCache(chip_8_state);
+
+    // Conditional jump
+    writeOpCode(chip_8_state, 0x200, 0x3A05);
+    writeOpCode(chip_8_state, 0x202, 0x1300);
+    // Chain of loads, interrupted by a different instruction
+    writeOpCode(chip_8_state, 0x204, 0x6001);
+    writeOpCode(chip_8_state, 0x206, 0x6102);
+    writeOpCode(chip_8_state, 0x208, 0x6203);
+    writeOpCode(chip_8_state, 0x20A, 0x7001);
+    // Sprite drawing
+    writeOpCode(chip_8_state, 0x20C, 0xA300);
+    writeOpCode(chip_8_state, 0x20E, 0xD015);
+    // Waiting for the delay timer
+    writeOpCode(chip_8_state, 0x210, 0xF307);
+    writeOpCode(chip_8_state, 0x212, 0x3300);
+    writeOpCode(chip_8_state, 0x214, 0x1210);
+    // Same loop, testing a different register than the one loaded
+    writeOpCode(chip_8_state, 0x216, 0xF307);
+    writeOpCode(chip_8_state, 0x218, 0x3400);
+    writeOpCode(chip_8_state, 0x21A, 0x1216);
+
+    assert(cache->fetch(0x200).fused == FUSED_SKIP_JUMP);
+    assert(cache->fetch(0x200).fused_length == 2);
+    assert(cache->fetch(0x202).instruction.nnn == 0x300);
+
+    const MicroOp& loads = cache->fetch(0x204);
+    assert(loads.fused == FUSED_LOAD_CHAIN);
+    assert(loads.fused_length == 3);
+    assert((&loads + 2)->instruction.op_code == 0x6203);
+
+    assert(cache->fetch(0x20C).fused == FUSED_LOAD_DRAW);
+    assert(cache->fetch(0x210).fused == FUSED_TIMER_WAIT);
+    assert(cache->fetch(0x210).fused_length == 3);
+    assert(cache->fetch(0x216).fused == FUSED_NONE);
+
+    // Halting
+    writeOpCode(chip_8_state, 0x21C, 0x121C);
+    writeOpCode(chip_8_state, 0x21E, 0x121C);
+    assert(cache->fetch(0x21C).fused == FUSED_JUMP_SELF);
+    assert(cache->fetch(0x21E).fused == FUSED_NONE);
+
+    // Odd addresses are never fused
+    writeOpCode(chip_8_state, 0x301, 0x6001);
+    writeOpCode(chip_8_state, 0x303, 0x6102);
+    assert(cache->fetch(0x301).fused == FUSED_NONE);
+
+    delete cache;
+    delete chip_8_state;
+}
+
+/**
+ * @brief Ensures writing to any instruction of a fused sequence drops the sequence
+ *
+ */
+void testFusionInvalidates() {
+    CHIP8_State* chip_8_state = new CHIP8_State();
+    InstructionCache* cache = new InstructionCache(chip_8_state);
+
+    writeOpCode(chip_8_state, 0x200, 0x6001);
+    writeOpCode(chip_8_state, 0x202, 0x6102);
+    writeOpCode(chip_8_state, 0x204, 0x6203);
+    writeOpCode(chip_8_state, 0x206, 0x6304);
+    writeOpCode(chip_8_state, 0x208, 0x0000);
+    assert(cache->fetch(0x200).fused_length == 4);
+
+    // Replace the last load of the chain
+    writeOpCode(chip_8_state, 0x206, 0x7304);
+    assert(cache->fetch(0x200).fused == FUSED_LOAD_CHAIN);
+    assert(cache->fetch(0x200).fused_length == 3);
+
+    // Replace the jump of a timer wait loop
+    writeOpCode(chip_8_state, 0x300, 0xF007);
+    writeOpCode(chip_8_state, 0x302, 0x3000);
+    writeOpCode(chip_8_state, 0x304, 0x1300);
+    assert(cache->fetch(0x300).fused == FUSED_TIMER_WAIT);
+    writeOpCode(chip_8_state, 0x304, 0x1200);
+    assert(cache->fetch(0x300).fused == FUSED_NONE);
+    assert(cache->fetch(0x304).instruction.nnn == 0x200);
+
+    delete cache;
+    delete chip_8_state;
+}
+
+int main(int argc, char** argv){
+
+    testFetch();
+    testSetMemoryValueInvalidates();
+    testOpCodesInvalidate();
+    testFusion();
+    testFusionInvalidates();
+
+    return 0;
+}
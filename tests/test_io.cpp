@@ -1,4 +1,5 @@
 #include <filesystem>
+#include <cassert>
 #include <iostream>
 #include <sstream>
 #include<vector>
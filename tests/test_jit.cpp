@@ -0,0 +1,215 @@
+#include <cassert>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../src/chip-8.hpp"
+#include "../src/io.hpp"
+#include "../src/jit/jit_compiler.hpp"
+#include "differential.hpp"
+
+using namespace std;
+
+/**
+ * @brief Ensures the arithmetic op codes compiled to native code match the interpreter, including VF edge cases
+ *
+ */
+void testArithmetic() {
+    vector<char> program = assemble({
+        0x60FF, // 0x200 V0 = 0xFF
+        0x6101, // 0x202 V1 = 0x01
+        0x8014, // 0x204 V0 += V1, carry
+        0x6FFE, // 0x206 VF = 0xFE
+        0x8F14, // 0x208 VF += V1, VF holds the carry afterwards
+        0x6205, // 0x20A V2 = 5
+        0x6307, // 0x20C V3 = 7
+        0x8235, // 0x20E V2 -= V3, borrow
+        0x8327, // 0x210 V3 = V2 - V3
+        0x8F27, // 0x212 VF = V2 - VF
+        0x6481, // 0x214 V4 = 0x81
+        0x8446, // 0x216 V4 >>= 1
+        0x848E, // 0x218 V4 <<= 1
+        0x6F81, // 0x21A VF = 0x81
+        0x8FFE, // 0x21C VF <<= 1
+        0x8561, // 0x21E V5 |= V6
+        0x8572, // 0x220 V5 &= V7
+        0x8483, // 0x222 V4 ^= V8
+        0x8940, // 0x224 V9 = V4
+        0x79F0, // 0x226 V9 += 0xF0
+        0xAFFF, // 0x228 I = 0xFFF
+        0xF91E, // 0x22A I += V9
+        0xF915, // 0x22C Delay timer = V9
+        0xF818, // 0x22E Sound timer = V8
+        0xFA07, // 0x230 VA = Delay timer
+        0x7A01, // 0x232 VA += 1
+        0x7101, // 0x234 V1 += 1
+        0x1226  // 0x236 Jump to 0x226
+    });
+
+    runDifferential(ExecutionMode::Jit, program, 2000, 1);
+    runDifferential(ExecutionMode::Jit, program, 2000, 7);
+    runDifferential(ExecutionMode::Jit, program, 2000, 100);
+}
+
+/**
+ * @brief Ensures skips, calls, returns and computed jumps match the interpreter
+ *
+ */
+void testControlFlow() {
+    vector<char> program = assemble({
+        0x6000, // 0x200 V0 = 0
+        0x6103, // 0x202 V1 = 3
+        0x7001, // 0x204 V0 += 1
+        0x3005, // 0x206 Skip if V0 == 5
+        0x1210, // 0x208 Jump to 0x210
+        0x6000, // 0x20A V0 = 0
+        0x4103, // 0x20C Skip if V1 != 3
+        0x1218, // 0x20E Jump to 0x218
+        0x5010, // 0x210 Skip if V0 == V1
+        0x2220, // 0x212 Call 0x220
+        0x9010, // 0x214 Skip if V0 != V1
+        0x7102, // 0x216 V1 += 2
+        0x6202, // 0x218 V2 = 2
+        0xB21C, // 0x21A Jump to 0x21C + V0
+        0x1204, // 0x21C Jump to 0x204
+        0x1204, // 0x21E Jump to 0x204
+        0xC30F, // 0x220 V3 = random & 0x0F
+        0x00EE  // 0x222 Return
+    });
+
+    runDifferential(ExecutionMode::Jit, program, 5000, 1);
+    runDifferential(ExecutionMode::Jit, program, 5000, 13);
+    runDifferential(ExecutionMode::Jit, program, 5000, 500);
+}
+
+/**
+ * @brief Ensures code that overwrites itself is recompiled before it runs again
+ *
+ */
+void testSelfModifyingCode() {
+    vector<char> program = assemble({
+        0x6070, // 0x200 V0 = 0x70
+        0x6101, // 0x202 V1 = 0x01
+        0xA20C, // 0x204 I = 0x20C
+        0xF155, // 0x206 Overwrite 0x20C with V0 V1, 7001 (V0 += 1)
+        0x7201, // 0x208 V2 += 1
+        0x120C, // 0x20A Jump to 0x20C
+        0x0000, // 0x20C Replaced at runtime
+        0x6300, // 0x20E V3 = 0
+        0xA21C, // 0x210 I = 0x21C
+        0xF233, // 0x212 Write V2 as BCD over 0x21C
+        0xA21C, // 0x214 I = 0x21C
+        0xF265, // 0x216 Read back V0 - V2
+        0x7301, // 0x218 V3 += 1
+        0x1200, // 0x21A Jump to 0x200
+        0x0000, // 0x21C BCD storage
+        0x0000  // 0x21E
+    });
+
+    runDifferential(ExecutionMode::Jit, program, 3000, 1);
+    runDifferential(ExecutionMode::Jit, program, 3000, 9);
+    runDifferential(ExecutionMode::Jit, program, 3000, 250);
+}
+
+/**
+ * @brief Ensures display op codes are interpreted and refresh the display the same number of times
+ *
+ */
+void testDisplay() {
+    vector<char> program = assemble({
+        0x00E0, // 0x200 Clear the screen
+        0x6000, // 0x202 V0 = 0
+        0x6100, // 0x204 V1 = 0
+        0xF029, // 0x206 I = font character for V0
+        0xD015, // 0x208 Draw at V0, V1
+        0x7005, // 0x20A V0 += 5
+        0x7103, // 0x20C V1 += 3
+        0x3F01, // 0x20E Skip if collision
+        0x1206, // 0x210 Jump to 0x206
+        0x1200  // 0x212 Jump to 0x200
+    });
+
+    runDifferential(ExecutionMode::Jit, program, 4000, 1);
+    runDifferential(ExecutionMode::Jit, program, 4000, 11);
+    runDifferential(ExecutionMode::Jit, program, 4000, 1000);
+}
+
+/**
+ * @brief Ensures complete games behave the same with the interpreter and the JIT
+ *
+ */
+void testRoms() {
+    // This test assumes it is called from the test executable directory
+    vector<string> roms = {
+        "../../roms/games/Blinky [Hans Christian Egeberg, 1991].ch8",
+        "../../roms/games/Brix [Andreas Gustafsson, 1990].ch8",
+        "../../roms/games/Pong [Paul Vervalin, 1990].ch8",
+        "../../roms/games/Space Invaders [David Winter].ch8",
+        "../../roms/games/Tetris [Fran Dachille, 1991].ch8",
+        "../../roms/games/UFO [Lutz V, 1992].ch8",
+        "../../roms/programs/Life [GV Samways, 1980].ch8"
+    };
+
+    for (string& path : roms) {
+        vector<char>* rom = ReadRom(path);
+        assert(rom->size() > 0);
+        runDifferential(ExecutionMode::Jit, *rom, 20000, 97);
+        delete rom;
+    }
+}
+
+/**
+ * @brief Counts the mappings of the process that are both writable and executable
+ *
+ */
+int writableExecutableMappings() {
+    ifstream maps("/proc/self/maps");
+    string line;
+    int count = 0;
+    while (getline(maps, line)) {
+        // Permissions are the second field, e.g. 7f00-7f01 rwxp ...
+        size_t start = line.find(' ') + 1;
+        if (line.compare(start, 3, "rwx") == 0) {
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Ensures the code buffer is never writable and executable at the same time, even after it was patched
+ *
+ */
+void testCodeProtection() {
+    int before = writableExecutableMappings();
+    Machine machine = createMachine(assemble({
+        0x6001, // 0x200 V0 = 1
+        0x7001, // 0x202 V0 += 1
+        0x1202  // 0x204 Jump to 0x202
+    }), ExecutionMode::Jit);
+    assert(writableExecutableMappings() == before);
+
+    machine.chip_8->RunCycles(1000);
+    assert(machine.state->vRegister(0) != 1);
+    assert(writableExecutableMappings() == before);
+
+    deleteMachine(machine);
+}
+
+int main(int argc, char** argv){
+
+    if (JitCompiler::isSupported() == false) {
+        cout << "JIT is not supported on this platform, skipping" << endl;
+        return 0;
+    }
+
+    testArithmetic();
+    testControlFlow();
+    testSelfModifyingCode();
+    testDisplay();
+    testRoms();
+    testCodeProtection();
+
+    return 0;
+}
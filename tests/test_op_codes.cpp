@@ -1,5 +1,6 @@
 #include <bitset>
 #include <filesystem>
+#include <cassert>
 #include <iostream>
 #include <sstream>
 #include<vector>
@@ -580,6 +581,16 @@ void testCNNN() {
     // Set I to 0x400 + V0
     ExecuteCNNN(chip_8_state, 0xC0AA);
     assert(chip_8_state->vRegister(0) != 0xBB);
+
+    // Every value can be drawn, 255 included
+    bool drawn[256] = {false};
+    for (int i = 0; i < 10000; i++) {
+        ExecuteCNNN(chip_8_state, 0xC1FF);
+        drawn[chip_8_state->vRegister(1)] = true;
+    }
+    for (int value = 0; value < 256; value++) {
+        assert(drawn[value]);
+    }
 }
 
 /**
@@ -959,6 +970,41 @@ void testSpriteCollision() {
     assert(chip_8_state->vRegister(0xF) == 1);
 }
 
+/**
+ * @brief Ensures DXYN and 00E0 record the region of the display they modify
+ *
+ */
+void testDisplayDamage() {
+    CHIP8_State* chip_8_state = new CHIP8_State(INITAL_PROGRAM_COUNTER, 0x300);
+    chip_8_state->setMemoryValue(0x300, 0x81);
+    chip_8_state->setMemoryValue(0x301, 0x18);
+    chip_8_state->setVRegister(0, 10);
+    chip_8_state->setVRegister(1, 4);
+    assert(chip_8_state->displayDamage().empty());
+
+    // Draw a 2 row sprite at 10, 4, the pixels span columns 10 to 17
+    ExecuteDXYN(chip_8_state, 0xD012);
+    DisplayDamage damage = chip_8_state->displayDamage();
+    assert(damage.rows == 0x30);
+    assert(damage.x_begin == 10);
+    assert(damage.x_end == 18);
+
+    // Drawing nothing new leaves the damage untouched
+    chip_8_state->clearDisplayDamage();
+    chip_8_state->setMemoryValue(0x302, 0x00);
+    chip_8_state->setIndexRegister(0x302);
+    ExecuteDXYN(chip_8_state, 0xD011);
+    assert(chip_8_state->displayDamage().empty());
+
+    // Clearing only damages the rows that had pixels
+    Execute00E0(chip_8_state);
+    damage = chip_8_state->displayDamage();
+    assert(damage.rows == 0x30);
+    assert(damage.x_begin == 10);
+    assert(damage.x_end == 18);
+
+    delete chip_8_state;
+}
 
 int main(int argc, char** argv){
 
@@ -994,6 +1040,7 @@ int main(int argc, char** argv){
     testDXYNOverflowX();
     testDXYNOverflowY();
     testSpriteCollision();
+    testDisplayDamage();
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,325 @@
+#include <cassert>
+#include <iostream>
+#include <vector>
+#include "../src/chip-8.hpp"
+#include "../src/chip-8_state.hpp"
+#include "../src/dispatch.hpp"
+#include "../src/op_codes.hpp"
+#include "../src/quirks.hpp"
+#include "../src/jit/jit_compiler.hpp"
+#include "differential.hpp"
+
+using namespace std;
+
+/**
+ * @brief Ensures the command line names map to the profiles
+ *
+ */
+void testParse() {
+    QuirkProfile profile = QuirkProfile::Modern;
+    assert(ParseQuirkProfile("vip", profile));
+    assert(profile == QuirkProfile::Vip);
+    assert(ParseQuirkProfile("chip48", profile));
+    assert(profile == QuirkProfile::Chip48);
+    assert(ParseQuirkProfile("schip", profile));
+    assert(profile == QuirkProfile::SuperChip);
+    assert(ParseQuirkProfile("xo-chip", profile));
+    assert(profile == QuirkProfile::XOChip);
+    assert(ParseQuirkProfile("modern", profile));
+    assert(profile == QuirkProfile::Modern);
+    assert(ParseQuirkProfile("octo", profile) == false);
+    assert(profile == QuirkProfile::Modern);
+}
+
+/**
+ * @brief Ensures 8XY6 and 8XYE shift VY with the COSMAC VIP quirks and VX in place otherwise
+ *
+ */
+void testShift() {
+    CHIP8_State* state = new CHIP8_State();
+    state->setVRegister(1, 0x81);
+    state->setVRegister(2, 0x06);
+
+    Execute8XY6<VipQuirks>(state, 0x8126);
+    assert(state->vRegister(1) == 0x03);
+    assert(state->vRegister(0xF) == 0);
+
+    state->setVRegister(1, 0x81);
+    Execute8XY6<ModernQuirks>(state, 0x8126);
+    assert(state->vRegister(1) == 0x40);
+    assert(state->vRegister(0xF) == 1);
+
+    state->setVRegister(1, 0x81);
+    Execute8XYE<XOChipQuirks>(state, 0x812E);
+    assert(state->vRegister(1) == 0x0C);
+    assert(state->vRegister(0xF) == 0);
+
+    state->setVRegister(1, 0x81);
+    Execute8XYE<Chip48Quirks>(state, 0x812E);
+    assert(state->vRegister(1) == 0x02);
+    assert(state->vRegister(0xF) == 1);
+
+    delete state;
+}
+
+/**
+ * @brief Ensures FX55 and FX65 move I by X + 1, X or not at all
+ *
+ */
+void testLoadStore() {
+    CHIP8_State* state = new CHIP8_State();
+
+    state->setIndexRegister(0x300);
+    ExecuteFX55<VipQuirks>(state, 0xF355);
+    assert(state->indexRegister() == 0x304);
+
+    state->setIndexRegister(0x300);
+    ExecuteFX65<Chip48Quirks>(state, 0xF365);
+    assert(state->indexRegister() == 0x303);
+
+    state->setIndexRegister(0x300);
+    ExecuteFX55<SuperChipQuirks>(state, 0xF355);
+    assert(state->indexRegister() == 0x300);
+
+    state->setIndexRegister(0x300);
+    ExecuteFX65<ModernQuirks>(state, 0xF365);
+    assert(state->indexRegister() == 0x304);
+
+    delete state;
+}
+
+/**
+ * @brief Ensures BNNN jumps with VX on CHIP-48 and SUPER-CHIP and with V0 otherwise
+ *
+ */
+void testJump() {
+    CHIP8_State* state = new CHIP8_State();
+    state->setVRegister(0, 0x10);
+    state->setVRegister(3, 0x20);
+
+    ExecuteBNNN<SuperChipQuirks>(state, 0xB345);
+    assert(state->programCounter() == 0x365);
+
+    ExecuteBNNN<VipQuirks>(state, 0xB345);
+    assert(state->programCounter() == 0x355);
+
+    delete state;
+}
+
+/**
+ * @brief Ensures the logic op codes reset VF with the COSMAC VIP quirks only
+ *
+ */
+void testLogic() {
+    CHIP8_State* state = new CHIP8_State();
+    state->setVRegister(1, 0x0F);
+    state->setVRegister(2, 0xF0);
+
+    state->setVRegister(0xF, 5);
+    Execute8XY1<VipQuirks>(state, 0x8121);
+    assert(state->vRegister(1) == 0xFF);
+    assert(state->vRegister(0xF) == 0);
+
+    state->setVRegister(0xF, 5);
+    Execute8XY2<ModernQuirks>(state, 0x8122);
+    assert(state->vRegister(1) == 0xF0);
+    assert(state->vRegister(0xF) == 5);
+
+    state->setVRegister(0xF, 5);
+    Execute8XY3<VipQuirks>(state, 0x8123);
+    assert(state->vRegister(1) == 0x00);
+    assert(state->vRegister(0xF) == 0);
+
+    delete state;
+}
+
+/**
+ * @brief Ensures sprites wrap around the edges with the XO-CHIP quirks and are clipped otherwise
+ *
+ */
+void testWrap() {
+    CHIP8_State* state = new CHIP8_State(INITAL_PROGRAM_COUNTER, 0x300);
+    state->setMemoryValue(0x300, 0xFF);
+    state->setMemoryValue(0x301, 0xFF);
+    state->setVRegister(0, 60);
+    state->setVRegister(1, 31);
+
+    ExecuteDXYN<ModernQuirks>(state, 0xD012);
+    assert(state->displayValue(63, 31));
+    assert(state->displayValue(0, 31) == false);
+    assert(state->displayValue(63, 0) == false);
+    Execute00E0(state);
+
+    ExecuteDXYN<XOChipQuirks>(state, 0xD012);
+    assert(state->vRegister(0xF) == 0);
+    assert(state->displayValue(63, 31));
+    assert(state->displayValue(0, 31));
+    assert(state->displayValue(3, 31));
+    assert(state->displayValue(4, 31) == false);
+    assert(state->displayValue(63, 0));
+    assert(state->displayValue(3, 0));
+
+    // Wrapped pixels collide like any other
+    ExecuteDXYN<XOChipQuirks>(state, 0xD012);
+    assert(state->vRegister(0xF) == 1);
+    assert(state->displayValue(0, 0) == false);
+
+    // On the high resolution display the spill of the last word wraps to the first word
+    Execute00FF(state);
+    state->setVRegister(0, 124);
+    state->setVRegister(1, 0);
+    ExecuteDXYN<XOChipQuirks>(state, 0xD011);
+    assert(state->displayValue(127, 0));
+    assert(state->displayValue(0, 0));
+    assert(state->displayValue(64, 0) == false);
+
+    delete state;
+}
+
+/**
+ * @brief Ensures the dispatch table holds the handlers of the requested profile
+ *
+ */
+void testDispatch() {
+    assert(OP_CODE_TABLE.lookup(0x8126, QuirkProfile::Vip).execute != OP_CODE_TABLE.lookup(0x8126).execute);
+    assert(OP_CODE_TABLE.lookup(0x8126, QuirkProfile::Modern).execute == OP_CODE_TABLE.lookup(0x8126).execute);
+
+    // Op codes without quirks share their handler
+    assert(OP_CODE_TABLE.lookup(0x6123, QuirkProfile::Vip).execute == OP_CODE_TABLE.lookup(0x6123).execute);
+}
+
+/**
+ * @brief Ensures changing the profile of a running emulator decodes the cached instructions again
+ *
+ */
+void testProfileSwitch() {
+    Machine machine = createMachine(assemble({
+        0x6106, // 0x200 V1 = 6
+        0x6281, // 0x202 V2 = 0x81
+        0x8126, // 0x204 V1 = V2 >> 1 or V1 >> 1
+        0x1200  // 0x206 Jump to 0x200
+    }), ExecutionMode::Threaded);
+    assert(machine.chip_8->quirkProfile() == QuirkProfile::Modern);
+
+    machine.chip_8->RunCycles(3);
+    assert(machine.state->vRegister(1) == 0x03);
+
+    machine.chip_8->SetQuirkProfile(QuirkProfile::Vip);
+    assert(machine.chip_8->quirkProfile() == QuirkProfile::Vip);
+    assert(machine.chip_8->executionMode() == ExecutionMode::Threaded);
+    machine.chip_8->RunCycles(4);
+    assert(machine.state->vRegister(1) == 0x40);
+
+    deleteMachine(machine);
+}
+
+/**
+ * @brief A program exercising every quirk in a loop
+ *
+ */
+vector<char> quirkProgram() {
+    return assemble({
+        0x6000, // 0x200 V0 = 0
+        0x6108, // 0x202 V1 = 8
+        0x6203, // 0x204 V2 = 3
+        0xA300, // 0x206 I = 0x300
+        0x8216, // 0x208 Shift right
+        0x821E, // 0x20A Shift left
+        0x8121, // 0x20C V1 |= V2
+        0x8122, // 0x20E V1 &= V2
+        0x8123, // 0x210 V1 ^= V2
+        0xF255, // 0x212 Store V0 - V2
+        0xF265, // 0x214 Load V0 - V2
+        0xA300, // 0x216 I = 0x300
+        0x703D, // 0x218 V0 += 0x3D
+        0x711B, // 0x21A V1 += 0x1B
+        0xD014, // 0x21C Draw at V0, V1
+        0x6306, // 0x21E V3 = 6
+        0x8032, // 0x220 V0 &= V3
+        0x8232, // 0x222 V2 &= V3
+        0xB228, // 0x224 Jump to 0x228 plus V0 or V2
+        0x1208, // 0x226
+        0x1208, // 0x228 Loop
+        0x1208, // 0x22A
+        0x1208, // 0x22C
+        0x1208  // 0x22E
+    });
+}
+
+/**
+ * @brief Ensures the threaded interpreter and the JIT reproduce the quirks of every profile like the interpreter
+ *
+ */
+void testDifferential() {
+    vector<char> program = quirkProgram();
+    // The sprite at 0x300
+    program.resize(0x100 + 4, 0);
+    program[0x100] = (char)0xF0;
+    program[0x101] = (char)0x90;
+    program[0x102] = (char)0x90;
+    program[0x103] = (char)0xF0;
+
+    vector<QuirkProfile> profiles = {
+        QuirkProfile::Vip,
+        QuirkProfile::Chip48,
+        QuirkProfile::SuperChip,
+        QuirkProfile::Modern,
+        QuirkProfile::XOChip
+    };
+    for (QuirkProfile profile : profiles) {
+        runDifferential(ExecutionMode::Threaded, program, 500, 1, NULL, profile);
+        runDifferential(ExecutionMode::Threaded, program, 500, 37, NULL, profile);
+        if (JitCompiler::isSupported()) {
+            runDifferential(ExecutionMode::Jit, program, 500, 1, NULL, profile);
+            runDifferential(ExecutionMode::Jit, program, 500, 37, NULL, profile);
+        }
+    }
+}
+
+/**
+ * @brief Ensures every execution mode ignores the SUPER-CHIP op codes on the COSMAC VIP profile
+ *
+ */
+void testSuperChipInstructions() {
+    vector<char> program = assemble({
+        0x00FF, // 0x200 High resolution with SUPER-CHIP
+        0x00C1, // 0x202 Scroll down with SUPER-CHIP
+        0x00FD, // 0x204 Exit with SUPER-CHIP
+        0x7101, // 0x206 V1 += 1
+        0x1206  // 0x208 Jump to 0x206
+    });
+
+    vector<ExecutionMode> modes = {ExecutionMode::Interpreter, ExecutionMode::Threaded};
+    if (JitCompiler::isSupported()) {
+        modes.push_back(ExecutionMode::Jit);
+    }
+    for (ExecutionMode mode : modes) {
+        Machine machine = createMachine(program, mode, NULL, QuirkProfile::Vip);
+        machine.chip_8->RunCycles(6);
+        assert(machine.state->exited() == false);
+        assert(machine.state->hires() == false);
+        assert(machine.state->vRegister(1) > 0);
+        deleteMachine(machine);
+
+        machine = createMachine(program, mode, NULL, QuirkProfile::SuperChip);
+        machine.chip_8->RunCycles(6);
+        assert(machine.state->exited() == true);
+        assert(machine.state->hires() == true);
+        assert(machine.state->vRegister(1) == 0);
+        deleteMachine(machine);
+    }
+}
+
+int main(int argc, char** argv){
+    testParse();
+    testShift();
+    testLoadStore();
+    testJump();
+    testLogic();
+    testWrap();
+    testDispatch();
+    testProfileSwitch();
+    testDifferential();
+    testSuperChipInstructions();
+    return 0;
+}
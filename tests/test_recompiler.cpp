@@ -0,0 +1,100 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../src/chip-8.hpp"
+#include "../src/io.hpp"
+#include "../src/recompiled_program.hpp"
+#include "differential.hpp"
+
+using namespace std;
+
+// Generated by chip-8-recompile at build time
+extern const RecompiledRom RECOMPILED_BRIX;
+extern const RecompiledRom RECOMPILED_SPACE_INVADERS;
+extern const RecompiledRom RECOMPILED_TETRIS;
+extern const RecompiledRom RECOMPILED_LIFE;
+extern const RecompiledRom RECOMPILED_BRIX_VIP;
+
+vector<char> imageOf(const RecompiledRom& recompiled) {
+    return vector<char>(recompiled.image, recompiled.image + recompiled.image_size);
+}
+
+/**
+ * @brief Ensures the recompiled image matches the ROM it was generated from
+ *
+ */
+void testImage() {
+    // This test assumes it is called from the test executable directory
+    vector<char>* rom = ReadRom("../../roms/games/Brix [Andreas Gustafsson, 1990].ch8");
+    assert(*rom == imageOf(RECOMPILED_BRIX));
+    assert(RECOMPILED_BRIX.block_count > 0);
+    assert(RECOMPILED_BRIX.blocks[0].start == INITAL_PROGRAM_COUNTER);
+    delete rom;
+}
+
+/**
+ * @brief Ensures the recompiled mode is only available once a recompiled ROM is loaded
+ *
+ */
+void testModeFallback() {
+    Machine machine = createMachine(imageOf(RECOMPILED_BRIX), ExecutionMode::Recompiled);
+    assert(machine.chip_8->executionMode() == ExecutionMode::Interpreter);
+    deleteMachine(machine);
+
+    machine = createMachine(imageOf(RECOMPILED_BRIX), ExecutionMode::Recompiled, &RECOMPILED_BRIX);
+    assert(machine.chip_8->executionMode() == ExecutionMode::Recompiled);
+    deleteMachine(machine);
+
+    // The recompiled code only reproduces the quirks it was generated for
+    machine = createMachine(imageOf(RECOMPILED_BRIX_VIP), ExecutionMode::Recompiled, &RECOMPILED_BRIX_VIP);
+    assert(machine.chip_8->quirkProfile() == QuirkProfile::Vip);
+    assert(machine.chip_8->executionMode() == ExecutionMode::Recompiled);
+    machine.chip_8->SetQuirkProfile(QuirkProfile::Modern);
+    assert(machine.chip_8->executionMode() == ExecutionMode::Interpreter);
+    deleteMachine(machine);
+}
+
+/**
+ * @brief Ensures complete games behave the same once recompiled
+ *
+ */
+void testRoms() {
+    vector<const RecompiledRom*> roms = {
+        &RECOMPILED_BRIX,
+        &RECOMPILED_SPACE_INVADERS,
+        &RECOMPILED_TETRIS,
+        &RECOMPILED_LIFE,
+        &RECOMPILED_BRIX_VIP
+    };
+
+    for (const RecompiledRom* recompiled : roms) {
+        runDifferential(ExecutionMode::Recompiled, imageOf(*recompiled), 20000, 1, recompiled);
+        runDifferential(ExecutionMode::Recompiled, imageOf(*recompiled), 20000, 97, recompiled);
+    }
+}
+
+/**
+ * @brief Ensures blocks whose memory was modified fall back to the interpreter
+ *
+ */
+void testModifiedBlocks() {
+    vector<char> program = imageOf(RECOMPILED_BRIX);
+
+    // Patch the first instruction of the ROM, the patched block must not run its recompiled code
+    program[0] = (char)0x60;
+    program[1] = (char)0x2A;
+
+    runDifferential(ExecutionMode::Recompiled, program, 20000, 1, &RECOMPILED_BRIX);
+    runDifferential(ExecutionMode::Recompiled, program, 20000, 97, &RECOMPILED_BRIX);
+}
+
+int main(int argc, char** argv){
+
+    testImage();
+    testModeFallback();
+    testRoms();
+    testModifiedBlocks();
+
+    return 0;
+}
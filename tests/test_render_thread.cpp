@@ -0,0 +1,134 @@
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include "../src/triple_buffer.hpp"
+#include "../src/display/render_thread.hpp"
+
+using namespace std;
+
+/**
+ * @brief A display recording the frames it is asked to show
+ *
+ */
+class RecordingDisplay : public DisplayInterface
+{
+public:
+    using DisplayInterface::updateDisplay;
+
+    virtual void updateDisplay(const FrameBufferView& frame, const DisplayDamage& damage) {
+        // Only the damaged rows are copied, as a display redrawing the damage would do
+        for (int y = 0; y < DISPLAY_HEIGHT; y++) {
+            if (damage.rows & ((uint32_t)1 << y)) {
+                this->rows[y] = frame.rows[y];
+            }
+        }
+        this->updates++;
+    }
+
+    uint64_t rows[DISPLAY_HEIGHT] = {0};
+    long updates = 0;
+};
+
+/**
+ * @brief A value whose fields are all written with the same number
+ *
+ */
+struct Sample {
+    long values[64];
+};
+
+/**
+ * @brief Ensures the reader only sees published values, the newest one first
+ *
+ */
+void testTripleBuffer() {
+    TripleBuffer<int> buffer;
+    assert(buffer.fresh() == false);
+    assert(buffer.update() == false);
+
+    buffer.writeBuffer() = 1;
+    buffer.publish();
+    assert(buffer.fresh());
+    assert(buffer.update());
+    assert(buffer.readBuffer() == 1);
+    assert(buffer.update() == false);
+    assert(buffer.readBuffer() == 1);
+
+    // Values published while the reader is busy replace each other
+    buffer.writeBuffer() = 2;
+    buffer.publish();
+    buffer.writeBuffer() = 3;
+    buffer.publish();
+    assert(buffer.update());
+    assert(buffer.readBuffer() == 3);
+    assert(buffer.update() == false);
+}
+
+/**
+ * @brief Ensures values are never torn or out of order while both threads are running
+ *
+ */
+void testTripleBufferThreads() {
+    TripleBuffer<Sample>* buffer = new TripleBuffer<Sample>();
+    const long count = 200000;
+
+    thread writer([buffer, count] {
+        for (long i = 1; i <= count; i++) {
+            Sample& sample = buffer->writeBuffer();
+            for (int j = 0; j < 64; j++) {
+                sample.values[j] = i;
+            }
+            buffer->publish();
+        }
+    });
+
+    long last = 0;
+    while (last < count) {
+        if (buffer->update()) {
+            const Sample& sample = buffer->readBuffer();
+            for (int j = 0; j < 64; j++) {
+                assert(sample.values[j] == sample.values[0]);
+            }
+            assert(sample.values[0] > last);
+            last = sample.values[0];
+        }
+    }
+    writer.join();
+    delete buffer;
+}
+
+/**
+ * @brief Ensures the display ends up showing the last frame, even when frames are dropped
+ *
+ */
+void testRenderThread() {
+    RecordingDisplay* display = new RecordingDisplay();
+    RenderThread* render_thread = new RenderThread(display);
+
+    uint64_t rows[DISPLAY_HEIGHT];
+    for (int frame = 1; frame <= 1000; frame++) {
+        memset(rows, 0, sizeof(rows));
+        rows[frame % DISPLAY_HEIGHT] = frame;
+        FrameBufferView view = {rows, DISPLAY_WIDTH, DISPLAY_HEIGHT};
+        render_thread->updateDisplay(view, DisplayDamage());
+    }
+    assert(render_thread->publishedFrames() == 1000);
+
+    // Stopping presents the last frame
+    delete render_thread;
+    for (int y = 0; y < DISPLAY_HEIGHT; y++) {
+        assert(display->rows[y] == rows[y]);
+    }
+    assert(display->updates >= 1);
+    assert(display->updates <= 1000);
+
+    delete display;
+}
+
+int main(int argc, char** argv){
+    testTripleBuffer();
+    testTripleBufferThreads();
+    testRenderThread();
+    return 0;
+}
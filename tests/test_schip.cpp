@@ -0,0 +1,282 @@
+#include <cassert>
+#include <iostream>
+#include <vector>
+#include "../src/chip-8.hpp"
+#include "../src/chip-8_state.hpp"
+#include "../src/op_codes.hpp"
+#include "../src/jit/jit_compiler.hpp"
+#include "differential.hpp"
+
+using namespace std;
+
+/**
+ * @brief Ensures 00FF and 00FE switch the display size, clearing the display each time
+ *
+ */
+void testResolution() {
+    CHIP8_State* chip_8_state = new CHIP8_State(INITAL_PROGRAM_COUNTER, 0x300);
+    chip_8_state->setDisplayValue(5, 5, true);
+    assert(chip_8_state->hires() == false);
+
+    Execute00FF(chip_8_state);
+    FrameBufferView frame = chip_8_state->displayView();
+    assert(chip_8_state->hires());
+    assert(frame.width == 128);
+    assert(frame.height == 64);
+    for (int y = 0; y < frame.height; y++) {
+        assert(frame.row(y)[0] == 0);
+        assert(frame.row(y)[1] == 0);
+    }
+
+    // Pixels past the low resolution display are addressable
+    chip_8_state->setVRegister(0, 100);
+    chip_8_state->setVRegister(1, 50);
+    chip_8_state->setMemoryValue(0x300, 0x80);
+    ExecuteDXYN(chip_8_state, 0xD011);
+    assert(chip_8_state->displayValue(100, 50));
+
+    Execute00FE(chip_8_state);
+    frame = chip_8_state->displayView();
+    assert(chip_8_state->hires() == false);
+    assert(frame.width == DISPLAY_WIDTH);
+    assert(frame.height == DISPLAY_HEIGHT);
+    assert(chip_8_state->displayValue(5, 5) == false);
+
+    delete chip_8_state;
+}
+
+/**
+ * @brief Ensures DXY0 draws a 16x16 sprite in high resolution, split across two words of each row
+ *
+ */
+void testDXY0() {
+    CHIP8_State* chip_8_state = new CHIP8_State(INITAL_PROGRAM_COUNTER, 0x300);
+    Execute00FF(chip_8_state);
+
+    // Rows alternate between the left half and the right half of the sprite
+    for (int row = 0; row < 16; row++) {
+        chip_8_state->setMemoryValue(0x300 + row * 2, row % 2 == 0 ? 0xFF : 0x00);
+        chip_8_state->setMemoryValue(0x301 + row * 2, row % 2 == 0 ? 0x00 : 0xFF);
+    }
+    chip_8_state->setVRegister(0, 60);
+    chip_8_state->setVRegister(1, 10);
+    ExecuteDXYN(chip_8_state, 0xD010);
+    assert(chip_8_state->vRegister(0xF) == 0);
+
+    for (int row = 0; row < 16; row++) {
+        for (int x = 0; x < 16; x++) {
+            bool expected = row % 2 == 0 ? x < 8 : x >= 8;
+            assert(chip_8_state->displayValue(60 + x, 10 + row) == expected);
+        }
+    }
+    assert(chip_8_state->displayValue(59, 10) == false);
+    assert(chip_8_state->displayValue(76, 11) == false);
+    assert(chip_8_state->displayValue(60, 26) == false);
+
+    // The same sprite drawn again erases itself and reports the collision
+    ExecuteDXYN(chip_8_state, 0xD010);
+    assert(chip_8_state->vRegister(0xF) == 1);
+    FrameBufferView frame = chip_8_state->displayView();
+    for (int y = 0; y < frame.height; y++) {
+        assert(frame.row(y)[0] == 0);
+        assert(frame.row(y)[1] == 0);
+    }
+
+    // In low resolution DXY0 draws nothing
+    Execute00FE(chip_8_state);
+    ExecuteDXYN(chip_8_state, 0xD010);
+    assert(chip_8_state->vRegister(0xF) == 0);
+    frame = chip_8_state->displayView();
+    for (int y = 0; y < frame.height; y++) {
+        assert(frame.row(y)[0] == 0);
+    }
+
+    delete chip_8_state;
+}
+
+/**
+ * @brief Ensures the scroll op codes move whole words, carrying pixels from one word to the next
+ *
+ */
+void testScroll() {
+    CHIP8_State* chip_8_state = new CHIP8_State(INITAL_PROGRAM_COUNTER, 0x300);
+    Execute00FF(chip_8_state);
+    chip_8_state->setDisplayValue(62, 0, true);
+    chip_8_state->setDisplayValue(127, 63, true);
+    chip_8_state->clearDisplayDamage();
+
+    // Right by 4, the pixel crosses into the second word and the last pixel falls off the edge
+    Execute00FB(chip_8_state);
+    assert(chip_8_state->displayValue(62, 0) == false);
+    assert(chip_8_state->displayValue(66, 0));
+    assert(chip_8_state->displayValue(127, 63) == false);
+    DisplayDamage damage = chip_8_state->displayDamage();
+    assert(damage.rows == (((uint64_t)1 << 63) | 1));
+    assert(damage.x_begin == 62);
+    assert(damage.x_end == 128);
+
+    // Left by 4 brings it back
+    Execute00FC(chip_8_state);
+    assert(chip_8_state->displayValue(62, 0));
+    assert(chip_8_state->displayValue(66, 0) == false);
+
+    // Down by 3 rows, the bottom rows fall off
+    Execute00CN(chip_8_state, 0x00C3);
+    assert(chip_8_state->displayValue(62, 0) == false);
+    assert(chip_8_state->displayValue(62, 3));
+    for (int i = 0; i < 5; i++) {
+        Execute00CN(chip_8_state, 0x00CF);
+    }
+    FrameBufferView frame = chip_8_state->displayView();
+    for (int y = 0; y < frame.height; y++) {
+        assert(frame.row(y)[0] == 0);
+        assert(frame.row(y)[1] == 0);
+    }
+
+    // Scrolling works on the low resolution display too
+    Execute00FE(chip_8_state);
+    chip_8_state->setDisplayValue(0, 0, true);
+    Execute00FB(chip_8_state);
+    Execute00CN(chip_8_state, 0x00C1);
+    assert(chip_8_state->displayValue(4, 1));
+    assert(chip_8_state->displayValue(0, 0) == false);
+
+    delete chip_8_state;
+}
+
+/**
+ * @brief Ensures FX30 points I at the large digits, which are 10 rows high
+ *
+ */
+void testFX30() {
+    CHIP8_State* chip_8_state = new CHIP8_State(INITAL_PROGRAM_COUNTER, 0x300);
+    chip_8_state->setVRegister(3, 0x17);
+    ExecuteFX30(chip_8_state, 0xF330);
+    assert(chip_8_state->indexRegister() == BIG_FONT_MEMORY_LOCATION + 7 * 10);
+
+    // The large zero is a rounded box
+    assert(chip_8_state->memoryValue(BIG_FONT_MEMORY_LOCATION) != 0);
+    assert(chip_8_state->memoryValue(BIG_FONT_MEMORY_LOCATION + 9) != 0);
+
+    delete chip_8_state;
+}
+
+/**
+ * @brief Ensures FX75 and FX85 save and restore registers through the flags, which are not in memory
+ *
+ */
+void testRplFlags() {
+    CHIP8_State* chip_8_state = new CHIP8_State(INITAL_PROGRAM_COUNTER, 0x300);
+    for (int i = 0; i < 8; i++) {
+        chip_8_state->setVRegister(i, 0x10 + i);
+    }
+    ExecuteFX75(chip_8_state, 0xF575);
+    assert(chip_8_state->rplFlag(5) == 0x15);
+    assert(chip_8_state->rplFlag(6) == 0);
+
+    for (int i = 0; i < 8; i++) {
+        chip_8_state->setVRegister(i, 0);
+    }
+    ExecuteFX85(chip_8_state, 0xF385);
+    assert(chip_8_state->vRegister(0) == 0x10);
+    assert(chip_8_state->vRegister(3) == 0x13);
+    assert(chip_8_state->vRegister(4) == 0);
+    assert(chip_8_state->indexRegister() == 0x300);
+
+    delete chip_8_state;
+}
+
+/**
+ * @brief Ensures 00FD stops the program, in place, and ends a batch early
+ *
+ */
+void test00FD() {
+    vector<char> program = assemble({
+        0x6001, // 0x200 V0 = 1
+        0x00FD, // 0x202 Exit
+        0x6002  // 0x204 V0 = 2, never reached
+    });
+    Machine machine = createMachine(program, ExecutionMode::Interpreter);
+
+    RunSummary summary = machine.chip_8->RunFrames(10);
+    assert(summary.stop_reason == StopReason::Exit);
+    assert(summary.frames == 1);
+    assert(machine.state->exited());
+    assert(machine.state->programCounter() == 0x202);
+    assert(machine.state->vRegister(0) == 1);
+
+    summary = machine.chip_8->RunCycles(100);
+    assert(summary.stop_reason == StopReason::Exit);
+    assert(summary.cycles == 0);
+
+    deleteMachine(machine);
+}
+
+/**
+ * @brief A program switching to high resolution, drawing large sprites and scrolling them around
+ *
+ */
+vector<char> scrollingProgram() {
+    return assemble({
+        0x00FF, // 0x200 High resolution
+        0x6000, // 0x202 V0 = 0
+        0x6100, // 0x204 V1 = 0
+        0x6209, // 0x206 V2 = 9
+        0xF230, // 0x208 I = large digit V2
+        0xD01A, // 0x20A Draw the 8x10 digit at V0, V1
+        0xA300, // 0x20C I = 0x300
+        0xD010, // 0x20E Draw a 16x16 sprite at V0, V1
+        0x00FB, // 0x210 Scroll right
+        0x00C2, // 0x212 Scroll down by 2
+        0x7007, // 0x214 V0 += 7
+        0x7103, // 0x216 V1 += 3
+        0x3F01, // 0x218 Skip if collision
+        0x1220, // 0x21A Jump to 0x220
+        0x00FC, // 0x21C Scroll left
+        0xF285, // 0x21E Restore V0 - V2 from the flags
+        0xF275, // 0x220 Save V0 - V2 in the flags
+        0x3060, // 0x222 Skip if V0 == 0x60
+        0x1208, // 0x224 Jump to 0x208
+        0x00FE, // 0x226 Low resolution
+        0x00FF, // 0x228 High resolution
+        0x1202  // 0x22A Jump to 0x202
+    });
+}
+
+/**
+ * @brief Ensures the threaded interpreter and the JIT run SUPER-CHIP op codes like the interpreter
+ *
+ */
+void testDifferential() {
+    vector<char> program = scrollingProgram();
+    // The 16x16 sprite at 0x300
+    program.resize(0x100 + 32, 0);
+    for (int i = 0; i < 32; i++) {
+        program[0x100 + i] = (char)(i % 3 == 0 ? 0xA5 : 0x3C);
+    }
+
+    runDifferential(ExecutionMode::Threaded, program, 2000, 1);
+    runDifferential(ExecutionMode::Threaded, program, 2000, 37);
+    if (JitCompiler::isSupported()) {
+        runDifferential(ExecutionMode::Jit, program, 2000, 1);
+        runDifferential(ExecutionMode::Jit, program, 2000, 37);
+    }
+
+    // A program that exits ends in the same state whatever the mode
+    vector<char> exiting = assemble({0x00FF, 0x6005, 0xF030, 0xD01A, 0x00FD});
+    runDifferential(ExecutionMode::Threaded, exiting, 20, 1);
+    if (JitCompiler::isSupported()) {
+        runDifferential(ExecutionMode::Jit, exiting, 20, 1);
+    }
+}
+
+int main(int argc, char** argv){
+    testResolution();
+    testDXY0();
+    testScroll();
+    testFX30();
+    testRplFlags();
+    test00FD();
+    testDifferential();
+    return 0;
+}
@@ -1,5 +1,6 @@
 #include <bitset>
 #include <filesystem>
+#include <cassert>
 #include <iostream>
 #include <sstream>
 #include<vector>
@@ -0,0 +1,67 @@
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include "../src/spsc_queue.hpp"
+
+using namespace std;
+
+/**
+ * @brief Ensures values come out in the order they were pushed and a full queue refuses values
+ *
+ */
+void testOrder() {
+    SpscQueue<int, 4> queue;
+    int value = -1;
+    assert(queue.empty());
+    assert(queue.pop(value) == false);
+    assert(value == -1);
+
+    for (int i = 0; i < 4; i++) {
+        assert(queue.push(i));
+    }
+    assert(queue.push(4) == false);
+
+    assert(queue.pop(value));
+    assert(value == 0);
+    assert(queue.push(5));
+
+    int expected[] = {1, 2, 3, 5};
+    for (int i = 0; i < 4; i++) {
+        assert(queue.pop(value));
+        assert(value == expected[i]);
+    }
+    assert(queue.empty());
+}
+
+/**
+ * @brief Ensures every value pushed by one thread reaches the other thread, in order
+ *
+ */
+void testThreads() {
+    static const int COUNT = 1000000;
+    SpscQueue<int, 64> queue;
+
+    thread writer([&queue]() {
+        for (int i = 0; i < COUNT; i++) {
+            while (!queue.push(i)) {
+                this_thread::yield();
+            }
+        }
+    });
+
+    int value;
+    for (int i = 0; i < COUNT; i++) {
+        while (!queue.pop(value)) {
+            this_thread::yield();
+        }
+        assert(value == i);
+    }
+    writer.join();
+    assert(queue.empty());
+}
+
+int main(int argc, char** argv){
+    testOrder();
+    testThreads();
+    return 0;
+}
@@ -0,0 +1,194 @@
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "../src/chip-8_state.hpp"
+
+using namespace std;
+
+/**
+ * @brief Counts the memory writes it is notified of
+ *
+ */
+class CountingListener : public MemoryWriteListener
+{
+public:
+    vector<uint16_t> addresses;
+
+    virtual void onMemoryWrite(uint16_t address) {
+        this->addresses.push_back(address);
+    }
+};
+
+/**
+ * @brief Ensures the state block is aligned and initialized like a machine that was just powered on
+ *
+ */
+void testInitialState() {
+    CHIP8_State state;
+    assert((uintptr_t)state.data() % 64 == 0);
+    assert(state.programCounter() == INITAL_PROGRAM_COUNTER);
+    assert(state.stackPointer() == -2);
+    assert(state.memoryValue(FONT_MEMORY_LOCATION) == 0xF0);
+    assert(state.memoryValue(INITAL_PROGRAM_COUNTER) == 0);
+    assert(state.vRegister(0xF) == 0);
+    assert(state.displayValue(63, 31) == false);
+
+    // Arrays provided to the constructor are copied into the state
+    uint8_t* v_registers = new uint8_t[V_REGISTER_COUNT]();
+    uint8_t* memory = new uint8_t[RAM_SIZE]();
+    v_registers[3] = 0x33;
+    memory[0x300] = 0x44;
+    CHIP8_State provided(0x300, 0x123, 5, 6, v_registers, memory);
+    v_registers[3] = 0;
+    assert(provided.vRegister(3) == 0x33);
+    assert(provided.memoryValue(0x300) == 0x44);
+    assert(provided.memoryValue(FONT_MEMORY_LOCATION) == 0xF0);
+    assert(provided.indexRegister() == 0x123);
+    assert(provided.delayTimer() == 5);
+    assert(provided.soundTimer() == 6);
+    delete[] v_registers;
+    delete[] memory;
+}
+
+/**
+ * @brief Ensures a snapshot restores every part of the state
+ *
+ */
+void testSnapshot() {
+    CHIP8_State state;
+    state.setVRegister(1, 0x11);
+    state.setIndexRegister(0x456);
+    state.setMemoryValue(0x400, 0x99);
+    state.pushStack(0x246);
+    state.setDisplayValue(10, 20, true);
+
+    CHIP8_StateData* snapshot = CHIP8_State::allocateSnapshot();
+    state.snapshot(snapshot);
+
+    state.setVRegister(1, 0);
+    state.setIndexRegister(0);
+    state.setMemoryValue(0x400, 0);
+    state.popStack();
+    state.setDisplayValue(10, 20, false);
+    state.setProgramCounter(0x800);
+
+    state.restore(*snapshot);
+    assert(state.vRegister(1) == 0x11);
+    assert(state.indexRegister() == 0x456);
+    assert(state.memoryValue(0x400) == 0x99);
+    assert(state.peekStack() == 0x246);
+    assert(state.displayValue(10, 20) == true);
+    assert(state.programCounter() == INITAL_PROGRAM_COUNTER);
+    assert(memcmp(state.data(), snapshot, sizeof(CHIP8_StateData)) == 0);
+
+    CHIP8_State::freeSnapshot(snapshot);
+}
+
+/**
+ * @brief Ensures listeners are told about the memory modified by a restore or a reset
+ *
+ */
+void testRestoreNotifiesListeners() {
+    CHIP8_State state;
+    CHIP8_StateData* snapshot = CHIP8_State::allocateSnapshot();
+    state.snapshot(snapshot);
+
+    CountingListener listener;
+    state.setMemoryValue(0x210, 0x12);
+    state.addMemoryListener(&listener);
+    state.setMemoryValue(0x212, 0x34);
+    assert(listener.addresses.size() == 1);
+
+    listener.addresses.clear();
+    state.restore(*snapshot);
+    assert(listener.addresses.size() == 2);
+    assert(listener.addresses[0] == 0x210);
+    assert(listener.addresses[1] == 0x212);
+
+    state.setMemoryValue(0x500, 0x56);
+    state.setVRegister(2, 0x22);
+    listener.addresses.clear();
+    state.reset();
+    assert(listener.addresses.size() == 1);
+    assert(state.memoryValue(0x500) == 0);
+    assert(state.vRegister(2) == 0);
+    assert(state.memoryValue(FONT_MEMORY_LOCATION) == 0xF0);
+
+    state.removeMemoryListener(&listener);
+    CHIP8_State::freeSnapshot(snapshot);
+}
+
+/**
+ * @brief Ensures the pixel accessors are a view over the display rows
+ *
+ */
+void testDisplayRows() {
+    CHIP8_State state;
+    state.setDisplayValue(0, 3, true);
+    state.setDisplayValue(63, 3, true);
+    assert(state.displayRow(3) == 0x8000000000000001);
+
+    state.setDisplayRow(4, 0x00F0000000000000);
+    assert(state.displayValue(8, 4) == true);
+    assert(state.displayValue(11, 4) == true);
+    assert(state.displayValue(12, 4) == false);
+
+    state.setDisplayValue(0, 3, false);
+    assert(state.displayRow(3) == 1);
+
+    state.clearDisplay();
+    for (int y = 0; y < 32; y++) {
+        assert(state.displayRow(y) == 0);
+    }
+}
+
+/**
+ * @brief Ensures the random numbers depend on the seed only, and are part of the snapshot
+ *
+ */
+void testRandom() {
+    CHIP8_State first;
+    CHIP8_State second;
+    first.seedRandom(42);
+    second.seedRandom(42);
+    vector<uint8_t> sequence;
+    for (int i = 0; i < 16; i++) {
+        sequence.push_back(first.randomByte());
+        assert(second.randomByte() == sequence[i]);
+    }
+
+    // Another seed, another sequence
+    second.seedRandom(43);
+    int differences = 0;
+    for (int i = 0; i < 16; i++) {
+        differences += second.randomByte() != sequence[i];
+    }
+    assert(differences > 0);
+
+    // A restore replays the numbers drawn since the snapshot
+    CHIP8_StateData* snapshot = CHIP8_State::allocateSnapshot();
+    first.snapshot(snapshot);
+    uint8_t expected = first.randomByte();
+    first.restore(*snapshot);
+    assert(first.randomByte() == expected);
+
+    // A reset starts over from the seed
+    first.reset();
+    assert(first.randomSeed() == 42);
+    assert(first.randomByte() == sequence[0]);
+
+    CHIP8_State::freeSnapshot(snapshot);
+}
+
+int main(int argc, char** argv){
+
+    testInitialState();
+    testSnapshot();
+    testRestoreNotifiesListeners();
+    testDisplayRows();
+    testRandom();
+
+    return 0;
+}
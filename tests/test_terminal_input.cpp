@@ -0,0 +1,118 @@
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <unistd.h>
+#include "../src/input/terminal_input.hpp"
+
+using namespace std;
+
+/**
+ * @brief Replaces the standard input with the read end of a pipe
+ *
+ * @return The write end of the pipe, typing into the terminal
+ */
+int redirectStdin() {
+    int fds[2];
+    assert(pipe(fds) == 0);
+    assert(dup2(fds[0], STDIN_FILENO) == STDIN_FILENO);
+    close(fds[0]);
+    return fds[1];
+}
+
+/**
+ * @brief Ends frames until a key reaches the requested state, failing after a second
+ *
+ */
+void waitForKey(TerminalInput* input, uint8_t key, bool pressed) {
+    for (int i = 0; i < 1000 && input->isPressed(key) != pressed; i++) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+        input->endFrame();
+    }
+    assert(input->isPressed(key) == pressed);
+}
+
+/**
+ * @brief Ensures typed keys are applied at the end of a frame and released after the hold time
+ *
+ */
+void testIsPressed(TerminalInput* input, int terminal) {
+    assert(input->holdTime() == TerminalInput::DEFAULT_KEY_HOLD_TIME);
+    assert(input->isPressed(0xA) == false);
+
+    // The keypad does not change in the middle of a frame
+    assert(write(terminal, "a", 1) == 1);
+    this_thread::sleep_for(chrono::milliseconds(20));
+    assert(input->isPressed(0xA) == false);
+    input->endFrame();
+    for (uint8_t key = 0; key < 16; key++) {
+        assert(input->isPressed(key) == (key == 0xA));
+    }
+
+    // Several keys are held at once, characters outside the keypad are ignored
+    assert(write(terminal, "zB", 2) == 2);
+    waitForKey(input, 0xB, true);
+    assert(input->isPressed(0xA));
+
+    waitForKey(input, 0xA, false);
+    waitForKey(input, 0xB, false);
+}
+
+/**
+ * @brief Ensures a key typed during a frame is seen for that frame even when it is held for less than a frame
+ *
+ */
+void testHoldTime(TerminalInput* input, int terminal) {
+    input->setHoldTime(chrono::milliseconds(1));
+    assert(write(terminal, "5", 1) == 1);
+    this_thread::sleep_for(chrono::milliseconds(20));
+    input->endFrame();
+    assert(input->isPressed(0x5));
+    input->endFrame();
+    assert(input->isPressed(0x5) == false);
+    input->setHoldTime(TerminalInput::DEFAULT_KEY_HOLD_TIME);
+}
+
+/**
+ * @brief Ensures getInput takes a key typed before the end of the frame, or waits for the next one
+ *
+ */
+void testGetInput(TerminalInput* input, int terminal) {
+    assert(write(terminal, "9", 1) == 1);
+    assert(input->getInput() == 0x9);
+    assert(input->isPressed(0x9));
+
+    thread typist([terminal]() {
+        this_thread::sleep_for(chrono::milliseconds(20));
+        assert(write(terminal, "7", 1) == 1);
+    });
+    assert(input->getInput() == 0x7);
+    typist.join();
+}
+
+/**
+ * @brief Ensures a closed input stops the input thread and no longer blocks getInput
+ *
+ */
+void testClose(TerminalInput* input, int terminal) {
+    close(terminal);
+    assert(input->getInput() == 0x7);
+    waitForKey(input, 0x7, false);
+}
+
+int main(int argc, char** argv){
+    int terminal = redirectStdin();
+    TerminalInput* input = new TerminalInput(NULL);
+    testIsPressed(input, terminal);
+    testHoldTime(input, terminal);
+    testGetInput(input, terminal);
+    testClose(input, terminal);
+    delete input;
+
+    // The input thread stops when destroyed while waiting for keys
+    terminal = redirectStdin();
+    input = new TerminalInput(NULL);
+    delete input;
+    close(terminal);
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../src/chip-8.hpp"
+#include "../src/io.hpp"
+#include "differential.hpp"
+
+using namespace std;
+
+/**
+ * @brief Ensures the instructions handled inline by the threaded interpreter match their op code handlers
+ *
+ */
+void testInlineHandlers() {
+    vector<char> program = assemble({
+        0x6003, // 0x200 V0 = 3
+        0x61F0, // 0x202 V1 = 0xF0
+        0x7120, // 0x204 V1 += 0x20, wraps around
+        0x8210, // 0x206 V2 = V1
+        0x8201, // 0x208 V2 |= V0
+        0x8312, // 0x20A V3 &= V1
+        0x8423, // 0x20C V4 ^= V2
+        0xAFF0, // 0x20E I = 0xFF0
+        0xF11E, // 0x210 I += V1
+        0xF507, // 0x212 V5 = Delay timer
+        0x3003, // 0x214 Skip if V0 == 3
+        0x6A01, // 0x216 VA = 1
+        0x4004, // 0x218 Skip if V0 != 4
+        0x6B01, // 0x21A VB = 1
+        0x5010, // 0x21C Skip if V0 == V1
+        0x9010, // 0x21E Skip if V0 != V1
+        0x6C01, // 0x220 VC = 1
+        0x7001, // 0x222 V0 += 1
+        0x1204  // 0x224 Jump to 0x204
+    });
+
+    runDifferential(ExecutionMode::Threaded, program, 2000, 1);
+    runDifferential(ExecutionMode::Threaded, program, 2000, 17);
+}
+
+/**
+ * @brief Ensures instructions executed through their handlers, including self modifying code, match the interpreter
+ *
+ */
+void testHandlers() {
+    vector<char> program = assemble({
+        0x6070, // 0x200 V0 = 0x70
+        0x6101, // 0x202 V1 = 0x01
+        0xA20E, // 0x204 I = 0x20E
+        0xF155, // 0x206 Overwrite 0x20E with V0 V1, 7001 (V0 += 1)
+        0x2216, // 0x208 Call 0x216
+        0xD015, // 0x20A Draw at V0, V1
+        0x120E, // 0x20C Jump to 0x20E
+        0x0000, // 0x20E Replaced at runtime
+        0x8214, // 0x210 V2 += V1
+        0x8F26, // 0x212 VF >>= 1
+        0x1200, // 0x214 Jump to 0x200
+        0xC3FF, // 0x216 V3 = random
+        0xF329, // 0x218 I = font character for V3
+        0x00EE  // 0x21A Return
+    });
+
+    runDifferential(ExecutionMode::Threaded, program, 3000, 1);
+    runDifferential(ExecutionMode::Threaded, program, 3000, 23);
+}
+
+/**
+ * @brief Ensures fused instruction sequences match the instructions executed one at a time
+ *
+ */
+void testFusedSequences() {
+    vector<char> program = assemble({
+        0x6001, // 0x200 V0 = 1
+        0x6102, // 0x202 V1 = 2
+        0x6203, // 0x204 V2 = 3
+        0x6304, // 0x206 V3 = 4
+        0x6405, // 0x208 V4 = 5
+        0xA250, // 0x20A I = 0x250
+        0xD015, // 0x20C Draw at V0, V1
+        0x7501, // 0x20E V5 += 1
+        0x3503, // 0x210 Skip if V5 == 3
+        0x120A, // 0x212 Jump to 0x20A
+        0xF607, // 0x214 V6 = Delay timer
+        0x3600, // 0x216 Skip if V6 == 0
+        0x1214, // 0x218 Jump to 0x214, until the delay runs out
+        0x6A0A, // 0x21A VA = 10
+        0xFA15, // 0x21C Delay timer = VA
+        0xF607, // 0x21E V6 = Delay timer
+        0x3600, // 0x220 Skip if V6 == 0
+        0x121E  // 0x222 Jump to 0x21E, timers never run out while frames are processed
+    });
+
+    runDifferential(ExecutionMode::Threaded, program, 1000, 1);
+    runDifferential(ExecutionMode::Threaded, program, 1000, 2);
+    runDifferential(ExecutionMode::Threaded, program, 1000, 3);
+    runDifferential(ExecutionMode::Threaded, program, 1000, 29);
+    runDifferential(ExecutionMode::Threaded, program, 100000, 10000);
+}
+
+/**
+ * @brief Ensures a jump to itself spends the remaining budget without moving
+ *
+ */
+void testJumpSelf() {
+    vector<char> program = assemble({
+        0x6005, // 0x200 V0 = 5
+        0x7001, // 0x202 V0 += 1
+        0x1204  // 0x204 Jump to 0x204
+    });
+
+    runDifferential(ExecutionMode::Threaded, program, 100, 1);
+    runDifferential(ExecutionMode::Threaded, program, 100, 2);
+    runDifferential(ExecutionMode::Threaded, program, 100000, 10000);
+}
+
+/**
+ * @brief Ensures complete games behave the same with the threaded interpreter
+ *
+ */
+void testRoms() {
+    // This test assumes it is called from the test executable directory
+    vector<string> roms = {
+        "../../roms/games/Brix [Andreas Gustafsson, 1990].ch8",
+        "../../roms/games/Space Invaders [David Winter].ch8",
+        "../../roms/games/Tetris [Fran Dachille, 1991].ch8",
+        "../../roms/programs/Life [GV Samways, 1980].ch8"
+    };
+
+    for (string& path : roms) {
+        vector<char>* rom = ReadRom(path);
+        assert(rom->size() > 0);
+        runDifferential(ExecutionMode::Threaded, *rom, 20000, 97);
+        delete rom;
+    }
+}
+
+int main(int argc, char** argv){
+
+    testInlineHandlers();
+    testHandlers();
+    testFusedSequences();
+    testJumpSelf();
+    testRoms();
+
+    return 0;
+}
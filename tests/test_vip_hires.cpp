@@ -0,0 +1,158 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../src/chip-8.hpp"
+#include "../src/chip-8_state.hpp"
+#include "../src/io.hpp"
+#include "../src/op_codes.hpp"
+#include "../src/jit/jit_compiler.hpp"
+#include "differential.hpp"
+
+using namespace std;
+
+/**
+ * @brief Ensures ROMs starting with 0x1260 switch to the 64x64 display and skip their hires interpreter
+ *
+ */
+void testLoader() {
+    Machine machine = createMachine(assemble({0x1260, 0x0000}), ExecutionMode::Interpreter);
+    assert(machine.state->displayMode() == DisplayMode::VipHires);
+    assert(machine.state->hires() == false);
+    assert(machine.state->memoryValue(0x200) == 0x12);
+    assert(machine.state->memoryValue(0x201) == 0xC0);
+
+    FrameBufferView frame = machine.state->displayView();
+    assert(frame.width == 64);
+    assert(frame.height == 64);
+
+    machine.chip_8->RunCycles(1);
+    assert(machine.state->programCounter() == 0x2C0);
+    deleteMachine(machine);
+
+    // Other jumps are loaded untouched
+    machine = createMachine(assemble({0x1262, 0x0000}), ExecutionMode::Interpreter);
+    assert(machine.state->displayMode() == DisplayMode::Lores);
+    assert(machine.state->memoryValue(0x201) == 0x62);
+    deleteMachine(machine);
+}
+
+/**
+ * @brief Ensures DXYN reaches the rows past the 64x32 display, clipping at the bottom edge
+ *
+ */
+void testDraw() {
+    CHIP8_State* state = new CHIP8_State(INITAL_PROGRAM_COUNTER, 0x300);
+    state->setDisplayMode(DisplayMode::VipHires);
+    state->setMemoryValue(0x300, 0x80);
+    state->setMemoryValue(0x301, 0x80);
+    state->setMemoryValue(0x302, 0x80);
+    state->setMemoryValue(0x303, 0x80);
+
+    state->setVRegister(0, 5);
+    state->setVRegister(1, 62);
+    ExecuteDXYN(state, 0xD014);
+    assert(state->vRegister(0xF) == 0);
+    assert(state->displayValue(5, 62));
+    assert(state->displayValue(5, 63));
+    assert(state->displayValue(5, 0) == false);
+    assert(state->displayValue(5, 1) == false);
+
+    // The starting row wraps around the 64 rows
+    state->setVRegister(1, 70);
+    ExecuteDXYN(state, 0xD011);
+    assert(state->displayValue(5, 6));
+
+    // Drawn pixels live on the 64x64 display only
+    state->setDisplayMode(DisplayMode::Lores);
+    assert(state->displayValue(5, 6) == false);
+    state->setDisplayMode(DisplayMode::VipHires);
+    assert(state->displayValue(5, 6));
+
+    delete state;
+}
+
+/**
+ * @brief Ensures 0230 clears the 64x64 display and is ignored on the other displays
+ *
+ */
+void test0230() {
+    CHIP8_State* state = new CHIP8_State();
+    state->setDisplayValue(3, 3, true);
+    Execute0230(state);
+    assert(state->displayValue(3, 3));
+
+    state->setDisplayMode(DisplayMode::VipHires);
+    state->setDisplayValue(3, 40, true);
+    state->clearDisplayDamage();
+    Execute0230(state);
+    assert(state->displayValue(3, 40) == false);
+    assert(state->displayDamage().rows == (uint64_t)1 << 40);
+
+    delete state;
+}
+
+/**
+ * @brief Ensures a restore brings back the 64x64 display it was taken on
+ *
+ */
+void testRestore() {
+    CHIP8_State* state = new CHIP8_State();
+    CHIP8_StateData* snapshot = CHIP8_State::allocateSnapshot();
+    state->setDisplayMode(DisplayMode::VipHires);
+    state->setDisplayValue(10, 50, true);
+    state->snapshot(snapshot);
+
+    state->setDisplayMode(DisplayMode::Lores);
+    state->clearDisplayDamage();
+    state->restore(*snapshot);
+    assert(state->displayMode() == DisplayMode::VipHires);
+    assert(state->displayValue(10, 50));
+    assert(state->displayDamage().rows == UINT64_MAX);
+
+    CHIP8_State::freeSnapshot(snapshot);
+    delete state;
+}
+
+/**
+ * @brief Ensures the hires ROMs behave the same with every execution mode
+ *
+ */
+void testRoms() {
+    // This test assumes it is called from the test executable directory
+    vector<string> roms = {
+        "../../roms/hires/Astro Dodge Hires [Revival Studios, 2008].ch8",
+        "../../roms/hires/Hires Maze [David Winter, 199x].ch8",
+        "../../roms/hires/Hires Particle Demo [zeroZshadow, 2008].ch8",
+        "../../roms/hires/Hires Sierpinski [Sergey Naydenov, 2010].ch8",
+        "../../roms/hires/Hires Stars [Sergey Naydenov, 2010].ch8",
+        "../../roms/hires/Hires Test [Tom Swan, 1979].ch8",
+        "../../roms/hires/Hires Worm V4 [RB-Revival Studios, 2007].ch8",
+        "../../roms/hires/Trip8 Hires Demo (2008) [Revival Studios].ch8"
+    };
+
+    for (string& path : roms) {
+        vector<char>* rom = ReadRom(path);
+        assert(rom->size() > 0);
+
+        Machine machine = createMachine(*rom, ExecutionMode::Interpreter);
+        assert(machine.state->displayMode() == DisplayMode::VipHires);
+        machine.chip_8->RunFrames(300);
+        deleteMachine(machine);
+
+        runDifferential(ExecutionMode::Threaded, *rom, 2000, 97);
+        if (JitCompiler::isSupported()) {
+            runDifferential(ExecutionMode::Jit, *rom, 2000, 97);
+        }
+        delete rom;
+    }
+}
+
+int main(int argc, char** argv){
+    testLoader();
+    testDraw();
+    test0230();
+    testRestore();
+    testRoms();
+    return 0;
+}
@@ -0,0 +1,272 @@
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include "../src/chip-8.hpp"
+#include "../src/chip-8_state.hpp"
+#include "../src/op_codes.hpp"
+#include "../src/display/null_display.hpp"
+#include "../src/input/mock_input.hpp"
+#include "differential.hpp"
+
+using namespace std;
+
+/**
+ * @brief Creates an emulator running a program on an XO-CHIP state
+ *
+ */
+CHIP8* createXOChip(CHIP8_State* state, NullDisplay* display, MockInput* input, const vector<uint16_t>& op_codes) {
+    state->enableXOChip();
+    CHIP8* chip_8 = new CHIP8(display, input, state);
+    vector<char> rom = assemble(op_codes);
+    chip_8->LoadRom(&rom);
+    return chip_8;
+}
+
+/**
+ * @brief Ensures only XO-CHIP states address 64KB, plain states wrap around 4KB
+ *
+ */
+void testMemory() {
+    CHIP8_State* plain = new CHIP8_State();
+    assert(plain->xoChip() == false);
+    assert(plain->memorySize() == RAM_SIZE);
+    plain->setMemoryValue(0x1300, 0x42);
+    assert(plain->memoryValue(0x300) == 0x42);
+    delete plain;
+
+    CHIP8_State* state = new CHIP8_State();
+    state->enableXOChip();
+    assert(state->memorySize() == XO_CHIP_RAM_SIZE);
+    state->setMemoryValue(0x1300, 0x42);
+    state->setMemoryValue(0xFFFF, 0x24);
+    assert(state->memoryValue(0x1300) == 0x42);
+    assert(state->memoryValue(0x300) == 0);
+    assert(state->memoryValue(0xFFFF) == 0x24);
+
+    // A reset clears the upper memory too
+    state->reset();
+    assert(state->memoryValue(0x1300) == 0);
+    assert(state->memoryValue(0xFFFF) == 0);
+    delete state;
+}
+
+/**
+ * @brief Ensures F000 NNNN loads a 16 bit address and skips are 4 bytes long over it
+ *
+ */
+void testLongIndex() {
+    CHIP8_State* state = new CHIP8_State();
+    NullDisplay* display = new NullDisplay();
+    MockInput* input = new MockInput();
+    CHIP8* chip_8 = createXOChip(state, display, input, {
+        0xF000, 0x8123, // 0x200 I = 0x8123
+        0x6000,         // 0x204 V0 = 0
+        0x3000,         // 0x206 Skip if V0 == 0
+        0xF000, 0x0456, // 0x208 I = 0x0456, skipped
+        0x6101,         // 0x20C V1 = 1
+        0x120E          // 0x20E Jump to itself
+    });
+
+    chip_8->SetExecutionMode(ExecutionMode::Jit);
+    assert(chip_8->executionMode() == ExecutionMode::Interpreter);
+
+    chip_8->RunCycles(1);
+    assert(state->indexRegister() == 0x8123);
+    assert(state->programCounter() == 0x204);
+
+    chip_8->RunCycles(3);
+    assert(state->indexRegister() == 0x8123);
+    assert(state->vRegister(1) == 1);
+    assert(state->programCounter() == 0x20E);
+
+    delete chip_8;
+    delete input;
+    delete display;
+    delete state;
+}
+
+/**
+ * @brief Ensures 5XY2 and 5XY3 store and load register ranges in both directions, leaving I unchanged
+ *
+ */
+void testRegisterRange() {
+    CHIP8_State* state = new CHIP8_State();
+    state->enableXOChip();
+    state->setIndexRegister(0x2000);
+    for (int i = 0; i < V_REGISTER_COUNT; i++) {
+        state->setVRegister(i, 0x10 + i);
+    }
+
+    Execute5XY2(state, 0x5242);
+    assert(state->memoryValue(0x2000) == 0x12);
+    assert(state->memoryValue(0x2001) == 0x13);
+    assert(state->memoryValue(0x2002) == 0x14);
+    assert(state->memoryValue(0x2003) == 0);
+    assert(state->indexRegister() == 0x2000);
+
+    // Descending when X > Y
+    Execute5XY2(state, 0x5312);
+    assert(state->memoryValue(0x2000) == 0x13);
+    assert(state->memoryValue(0x2001) == 0x12);
+    assert(state->memoryValue(0x2002) == 0x11);
+
+    Execute5XY3(state, 0x5A83);
+    assert(state->vRegister(0xA) == 0x13);
+    assert(state->vRegister(0x9) == 0x12);
+    assert(state->vRegister(0x8) == 0x11);
+    assert(state->vRegister(0xB) == 0x1B);
+
+    delete state;
+}
+
+/**
+ * @brief Ensures each selected plane draws its own sprite and the display shows both planes combined
+ *
+ */
+void testPlanes() {
+    CHIP8_State* state = new CHIP8_State();
+    state->enableXOChip();
+    assert(state->planes() == 1);
+
+    // One row per plane, read one after the other from I
+    state->setIndexRegister(0x300);
+    state->setMemoryValue(0x300, 0xF0);
+    state->setMemoryValue(0x301, 0x0F);
+    state->setVRegister(0, 0);
+    state->setVRegister(1, 0);
+    ExecuteFN01(state, 0xF301);
+    assert(state->planes() == 3);
+    ExecuteDXYN(state, 0xD011);
+    assert(state->vRegister(0xF) == 0);
+    assert(state->displayView().row(0)[0] == 0xFF00000000000000);
+
+    // Clearing the second plane leaves the first one
+    ExecuteFN01(state, 0xF201);
+    Execute00E0(state);
+    assert(state->displayView().row(0)[0] == 0xF000000000000000);
+
+    // Drawing on the second plane only collides with the second plane
+    state->setIndexRegister(0x300);
+    ExecuteDXYN(state, 0xD011);
+    assert(state->vRegister(0xF) == 0);
+    ExecuteDXYN(state, 0xD011);
+    assert(state->vRegister(0xF) == 1);
+    assert(state->displayView().row(0)[0] == 0xF000000000000000);
+
+    // Scrolling moves the selected planes only
+    ExecuteFN01(state, 0xF101);
+    Execute00CN(state, 0x00C2);
+    assert(state->displayView().row(0)[0] == 0);
+    assert(state->displayView().row(2)[0] == 0xF000000000000000);
+    Execute00DN(state, 0x00D1);
+    assert(state->displayView().row(1)[0] == 0xF000000000000000);
+
+    // The composite follows the resolution
+    Execute00FF(state);
+    FrameBufferView frame = state->displayView();
+    assert(frame.width == HIRES_DISPLAY_WIDTH);
+    for (int word = 0; word < frame.height * frame.wordsPerRow(); word++) {
+        assert(frame.rows[word] == 0);
+    }
+
+    delete state;
+}
+
+/**
+ * @brief Ensures 00DN scrolls a single plane display up on a plain CHIP-8 state too
+ *
+ */
+void testScrollUp() {
+    CHIP8_State* state = new CHIP8_State();
+    state->setDisplayValue(3, 0, true);
+    state->setDisplayValue(3, 31, true);
+    Execute00DN(state, 0x00D1);
+    assert(state->displayValue(3, 30));
+    assert(state->displayValue(3, 31) == false);
+    assert(state->displayValue(3, 0) == false);
+    delete state;
+}
+
+/**
+ * @brief Ensures sprites are read from the upper memory
+ *
+ */
+void testHighMemorySprite() {
+    CHIP8_State* state = new CHIP8_State();
+    NullDisplay* display = new NullDisplay();
+    MockInput* input = new MockInput();
+    CHIP8* chip_8 = createXOChip(state, display, input, {
+        0xF000, 0xC000, // 0x200 I = 0xC000
+        0x6000,         // 0x204 V0 = 0
+        0xD001,         // 0x206 Draw one row at V0, V0
+        0x1208          // 0x208 Jump to itself
+    });
+    state->setMemoryValue(0xC000, 0xAA);
+
+    chip_8->RunCycles(3);
+    assert(state->displayView().row(0)[0] == 0xAA00000000000000);
+
+    delete chip_8;
+    delete input;
+    delete display;
+    delete state;
+}
+
+/**
+ * @brief Ensures snapshots of XO-CHIP states carry the upper memory and the second plane
+ *
+ */
+void testSnapshot() {
+    CHIP8_State* state = new CHIP8_State();
+    state->enableXOChip();
+    state->setMemoryValue(0x300, 0x0F);
+    state->setMemoryValue(0x8000, 0x42);
+    state->setIndexRegister(0x300);
+    ExecuteFN01(state, 0xF201);
+    ExecuteDXYN(state, 0xD011);
+
+    CHIP8_StateData* snapshot = CHIP8_State::allocateSnapshot();
+    XOChipStateData* xo_snapshot = CHIP8_State::allocateXOChipSnapshot();
+    state->snapshot(snapshot, xo_snapshot);
+
+    state->setMemoryValue(0x8000, 0);
+    Execute00E0(state);
+    assert(state->displayView().row(0)[0] == 0);
+
+    state->restore(*snapshot, xo_snapshot);
+    assert(state->memoryValue(0x8000) == 0x42);
+    assert(state->planes() == 2);
+    assert(state->displayView().row(0)[0] == 0x0F00000000000000);
+
+    // Without the XO-CHIP block the state would be restored partially
+    bool thrown = false;
+    try {
+        state->snapshot(snapshot);
+    } catch (invalid_argument& e) {
+        thrown = true;
+    }
+    assert(thrown);
+    thrown = false;
+    try {
+        state->restore(*snapshot);
+    } catch (invalid_argument& e) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    CHIP8_State::freeSnapshot(xo_snapshot);
+    CHIP8_State::freeSnapshot(snapshot);
+    delete state;
+}
+
+int main(int argc, char** argv){
+    testMemory();
+    testLongIndex();
+    testRegisterRange();
+    testPlanes();
+    testScrollUp();
+    testHighMemorySprite();
+    testSnapshot();
+    return 0;
+}
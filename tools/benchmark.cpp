@@ -0,0 +1,119 @@
+/**
+ * @file benchmark.cpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Measures the instruction throughput of every execution mode on every ROM in a directory
+ *
+ * Usage: chip-8-benchmark <rom directory> [instructions per run]
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "chip-8.hpp"
+#include "chip-8_state.hpp"
+#include "io.hpp"
+#include "display/null_display.hpp"
+#include "input/mock_input.hpp"
+#include "jit/jit_compiler.hpp"
+
+using namespace std;
+using std::chrono::steady_clock;
+
+// Number of instructions executed between two calls into the emulator
+static const int FRAMES_PER_CALL = 1000;
+
+// Each ROM is run this many times per mode, the fastest run is reported
+static const int RUNS_PER_MODE = 3;
+
+/**
+ * @brief Runs a ROM for the provided number of instructions
+ *
+ * @param stopped Set to true if the ROM threw before running every instruction
+ * @return double Millions of instructions executed per second
+ */
+double RunRom(vector<char>* rom, ExecutionMode mode, int instructions, bool& stopped) {
+    // Start every run from the same cleared state and random sequence
+    uint8_t* memory = new uint8_t[RAM_SIZE]();
+    uint8_t* v_registers = new uint8_t[V_REGISTER_COUNT]();
+    CHIP8_State* state = new CHIP8_State(INITAL_PROGRAM_COUNTER, 0, 0, 0, v_registers, memory);
+    NullDisplay* display = new NullDisplay();
+    MockInput* input = new MockInput();
+    CHIP8* chip_8 = new CHIP8(display, input, state);
+    chip_8->SetExecutionMode(mode);
+    chip_8->LoadRom(rom);
+
+    int executed = 0;
+    steady_clock::time_point start = steady_clock::now();
+    try {
+        while (executed < instructions) {
+            executed += chip_8->ProcessFrames(min(FRAMES_PER_CALL, instructions - executed));
+        }
+    } catch (exception& e) {
+        // Some ROMs rely on unsupported instructions, report the throughput until the failure
+        stopped = true;
+    }
+    chrono::duration<double> duration = steady_clock::now() - start;
+
+    delete chip_8;
+    delete input;
+    delete display;
+    delete state;
+
+    return executed / duration.count() / 1000000.0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        cout << "Usage: chip-8-benchmark <rom directory> [instructions per run]" << endl;
+        return -1;
+    }
+
+    int instructions = argc > 2 ? atoi(argv[2]) : 1000000;
+
+    vector<string>* roms = FindRoms(string(argv[1]));
+
+    vector<ExecutionMode> modes = {ExecutionMode::Interpreter, ExecutionMode::Threaded};
+    vector<string> mode_names = {"interpreter", "threaded"};
+    if (JitCompiler::isSupported()) {
+        modes.push_back(ExecutionMode::Jit);
+        mode_names.push_back("jit");
+    }
+
+    cout << "MIPS over " << instructions << " instructions, best of " << RUNS_PER_MODE << " runs" << endl;
+    for (string& name : mode_names) {
+        cout << setw(12) << name;
+    }
+    cout << "  rom" << endl;
+
+    vector<double> totals(modes.size(), 0.0);
+    for (string& path : *roms) {
+        vector<char>* rom = ReadRom(path);
+        bool stopped = false;
+
+        for (int mode = 0; mode < modes.size(); mode++) {
+            double best = 0.0;
+            for (int run = 0; run < RUNS_PER_MODE; run++) {
+                best = max(best, RunRom(rom, modes[mode], instructions, stopped));
+            }
+            totals[mode] += best;
+            cout << setw(12) << fixed << setprecision(1) << best;
+        }
+        cout << "  " << path.substr(path.find_last_of('/') + 1) << (stopped ? " (stopped early)" : "") << endl;
+
+        delete rom;
+    }
+
+    for (int mode = 0; mode < modes.size(); mode++) {
+        cout << setw(12) << fixed << setprecision(1) << (roms->empty() ? 0.0 : totals[mode] / roms->size());
+    }
+    cout << "  mean of " << roms->size() << " roms" << endl;
+
+    delete roms;
+    return 0;
+}
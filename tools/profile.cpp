@@ -0,0 +1,134 @@
+/**
+ * @file profile.cpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Counts the most frequently executed op code sequences over every ROM in a directory
+ *
+ * Usage: chip-8-profile <rom directory> [instructions per rom] [sequences to list]
+ *
+ * Used to pick the instruction sequences fused by the instruction cache.
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "chip-8.hpp"
+#include "chip-8_state.hpp"
+#include "dispatch.hpp"
+#include "io.hpp"
+#include "display/null_display.hpp"
+#include "input/mock_input.hpp"
+
+using namespace std;
+
+// Must be listed in the same order as OpCodeId
+static const char* OP_CODE_NAMES[OP_CODE_ID_COUNT] = {
+    "0NNN", "????",
+    "00E0", "00EE", "1NNN", "2NNN", "3XNN", "4XNN", "5XY0", "6XNN", "7XNN",
+    "8XY0", "8XY1", "8XY2", "8XY3", "8XY4", "8XY5", "8XY6", "8XY7", "8XYE",
+    "9XY0", "ANNN", "BNNN", "CXNN", "DXYN", "EX9E", "EXA1",
+    "FX07", "FX0A", "FX15", "FX18", "FX1E", "FX29", "FX33", "FX55", "FX65"
+};
+
+// Longest sequence counted
+static const int MAX_SEQUENCE_LENGTH = 3;
+
+/**
+ * @brief Runs a ROM with the interpreter, counting every executed sequence of op codes
+ *
+ * @param counts Executions of each sequence, keyed by the op code ids of the sequence
+ */
+void ProfileRom(vector<char>* rom, int instructions, map<vector<uint8_t>, long>& counts) {
+    uint8_t* memory = new uint8_t[RAM_SIZE]();
+    uint8_t* v_registers = new uint8_t[V_REGISTER_COUNT]();
+    CHIP8_State* state = new CHIP8_State(INITAL_PROGRAM_COUNTER, 0, 0, 0, v_registers, memory);
+    NullDisplay* display = new NullDisplay();
+    MockInput* input = new MockInput();
+    CHIP8* chip_8 = new CHIP8(display, input, state);
+    chip_8->LoadRom(rom);
+
+    vector<uint8_t> history;
+    try {
+        for (int i = 0; i < instructions; i++) {
+            uint16_t program_counter = state->programCounter();
+            uint16_t op_code = ((uint16_t)state->memoryValue(program_counter) << 8)
+                | state->memoryValue(program_counter + 1);
+
+            history.push_back(OP_CODE_TABLE.lookup(op_code).id);
+            if (history.size() > MAX_SEQUENCE_LENGTH) {
+                history.erase(history.begin());
+            }
+
+            // Count every sequence ending with this instruction
+            for (int length = 1; length <= history.size(); length++) {
+                vector<uint8_t> sequence(history.end() - length, history.end());
+                counts[sequence]++;
+            }
+
+            chip_8->ProcessCurrentFrame();
+        }
+    } catch (exception& e) {
+        // Some ROMs rely on unsupported instructions, keep what was counted until the failure
+    }
+
+    delete chip_8;
+    delete input;
+    delete display;
+    delete state;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        cout << "Usage: chip-8-profile <rom directory> [instructions per rom] [sequences to list]" << endl;
+        return -1;
+    }
+
+    int instructions = argc > 2 ? atoi(argv[2]) : 100000;
+    int listed = argc > 3 ? atoi(argv[3]) : 20;
+
+    vector<string>* roms = FindRoms(string(argv[1]));
+
+    map<vector<uint8_t>, long> counts;
+    long total = 0;
+    for (string& path : *roms) {
+        vector<char>* rom = ReadRom(path);
+        ProfileRom(rom, instructions, counts);
+        delete rom;
+    }
+
+    for (auto& count : counts) {
+        if (count.first.size() == 1) {
+            total += count.second;
+        }
+    }
+
+    cout << total << " instructions executed over " << roms->size() << " roms" << endl;
+
+    for (int length = 1; length <= MAX_SEQUENCE_LENGTH; length++) {
+        vector<pair<long, vector<uint8_t>>> sorted;
+        for (auto& count : counts) {
+            if (count.first.size() == length) {
+                sorted.push_back(make_pair(count.second, count.first));
+            }
+        }
+        sort(sorted.rbegin(), sorted.rend());
+
+        cout << endl << "Hottest sequences of " << length << " instructions" << endl;
+        for (int i = 0; i < listed && i < sorted.size(); i++) {
+            string name;
+            for (uint8_t id : sorted[i].second) {
+                name += string(name.empty() ? "" : " ") + OP_CODE_NAMES[id];
+            }
+            double share = total == 0 ? 0.0 : 100.0 * sorted[i].first / total;
+            cout << setw(12) << sorted[i].first << setw(8) << fixed << setprecision(2) << share << "%  " << name << endl;
+        }
+    }
+
+    delete roms;
+    return 0;
+}
@@ -0,0 +1,529 @@
+/**
+ * @file recompiler.cpp
+ * @author Joel Hill (joel.hill.87@gmail.com)
+ * @brief Translates a CHIP-8 ROM into a C++ source file implementing its code ahead of time
+ *
+ * Usage: chip-8-recompile <rom> <output.cpp> <symbol> [vip|chip48|schip|modern|xo-chip]
+ *
+ * The control flow of the ROM is recovered by following every jump, call, skip and return point from the entry
+ * point. Each basic block becomes a labelled section of a single function, and blocks with a static successor jump
+ * straight to it. Computed jumps, returns and skipped input checks go back through a switch on the program
+ * counter. Anything that was not reached statically is left to the interpreter at runtime.
+ *
+ * The generated file defines a RecompiledRom named <symbol>. The code reproduces the quirks of the profile given
+ * last, modern by default, calling the op code handlers instantiated for its policy.
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "chip-8_state.hpp"
+#include "dispatch.hpp"
+#include "instruction.hpp"
+#include "io.hpp"
+#include "quirks.hpp"
+
+using namespace std;
+
+/**
+ * @brief A basic block recovered from the ROM
+ *
+ */
+struct Block {
+    // Address of the first instruction
+    uint16_t start;
+
+    // Address following the last instruction
+    uint16_t end;
+};
+
+/**
+ * @brief Formats a value as a hexadecimal C++ literal
+ *
+ */
+string Hex(int value) {
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "0x%03X", value);
+    return string(buffer);
+}
+
+/**
+ * @brief Name of the quirk policy of a profile, as written in C++
+ *
+ */
+string QuirkPolicy(QuirkProfile profile) {
+    switch (profile) {
+        case QuirkProfile::Vip: return "VipQuirks";
+        case QuirkProfile::Chip48: return "Chip48Quirks";
+        case QuirkProfile::SuperChip: return "SuperChipQuirks";
+        case QuirkProfile::XOChip: return "XOChipQuirks";
+        default: return "ModernQuirks";
+    }
+}
+
+/**
+ * @brief Name of a profile, as written in C++
+ *
+ */
+string QuirkProfileName(QuirkProfile profile) {
+    switch (profile) {
+        case QuirkProfile::Vip: return "QuirkProfile::Vip";
+        case QuirkProfile::Chip48: return "QuirkProfile::Chip48";
+        case QuirkProfile::SuperChip: return "QuirkProfile::SuperChip";
+        case QuirkProfile::XOChip: return "QuirkProfile::XOChip";
+        default: return "QuirkProfile::Modern";
+    }
+}
+
+/**
+ * @brief Name of the op code function executing an instruction, along with its arguments
+ *
+ * @param quirks The quirk policy the handlers depending on quirks are instantiated for
+ */
+string HandlerCall(OpCodeId id, uint16_t op_code, const string& quirks) {
+    string instruction = "Instruction(" + Hex(op_code) + ")";
+    string policy = "<" + quirks + ">";
+    switch (id) {
+        case OP_00E0: return "Execute00E0(state)";
+        case OP_00EE: return "Execute00EE(state)";
+        case OP_2NNN: return "Execute2NNN(state, " + instruction + ")";
+        case OP_8XY4: return "Execute8XY4(state, " + instruction + ")";
+        case OP_8XY5: return "Execute8XY5(state, " + instruction + ")";
+        case OP_8XY6: return "Execute8XY6" + policy + "(state, " + instruction + ")";
+        case OP_8XY7: return "Execute8XY7(state, " + instruction + ")";
+        case OP_8XYE: return "Execute8XYE" + policy + "(state, " + instruction + ")";
+        case OP_BNNN: return "ExecuteBNNN" + policy + "(state, " + instruction + ")";
+        case OP_CNNN: return "ExecuteCNNN(state, " + instruction + ")";
+        case OP_DXYN: return "ExecuteDXYN" + policy + "(state, " + instruction + ")";
+        case OP_EX9E: return "ExecuteEX9E(state, " + instruction + ", input)";
+        case OP_EXA1: return "ExecuteEXA1(state, " + instruction + ", input)";
+        case OP_FX07: return "ExecuteFX07(state, " + instruction + ")";
+        case OP_FX0A: return "ExecuteFX0A(state, " + instruction + ", input)";
+        case OP_FX15: return "ExecuteFX15(state, " + instruction + ")";
+        case OP_FX18: return "ExecuteFX18(state, " + instruction + ")";
+        case OP_FX1E: return "ExecuteFX1E(state, " + instruction + ")";
+        case OP_FX29: return "ExecuteFX29(state, " + instruction + ")";
+        case OP_FX33: return "ExecuteFX33(state, " + instruction + ")";
+        case OP_FX55: return "ExecuteFX55" + policy + "(state, " + instruction + ")";
+        case OP_FX65: return "ExecuteFX65" + policy + "(state, " + instruction + ")";
+        case OP_00CN: return "Execute00CN(state, " + instruction + ")";
+        case OP_00FB: return "Execute00FB(state)";
+        case OP_00FC: return "Execute00FC(state)";
+        case OP_00FD: return "Execute00FD(state)";
+        case OP_00FE: return "Execute00FE(state)";
+        case OP_00FF: return "Execute00FF(state)";
+        case OP_FX30: return "ExecuteFX30(state, " + instruction + ")";
+        case OP_FX75: return "ExecuteFX75(state, " + instruction + ")";
+        case OP_FX85: return "ExecuteFX85(state, " + instruction + ")";
+        case OP_00DN: return "Execute00DN(state, " + instruction + ")";
+        default: return "";
+    }
+}
+
+/**
+ * @brief Recovers the basic blocks of a ROM and writes them out as C++
+ *
+ */
+class Recompiler
+{
+
+public:
+
+    Recompiler(vector<char>* rom, QuirkProfile profile) {
+        for (char byte : *rom) {
+            this->image_.push_back((uint8_t)byte);
+        }
+        this->quirk_profile_ = profile;
+    }
+
+    void Analyze() {
+        vector<uint16_t> work_list = {INITAL_PROGRAM_COUNTER};
+        this->leaders_.insert(INITAL_PROGRAM_COUNTER);
+
+        while (!work_list.empty()) {
+            uint16_t address = work_list.back();
+            work_list.pop_back();
+
+            if (!this->InImage(address) || this->reachable_.count(address) > 0) {
+                continue;
+            }
+            this->reachable_.insert(address);
+
+            Instruction instruction(this->OpCode(address));
+            uint16_t next = address + 2;
+
+            switch (this->Id(instruction.op_code)) {
+                case OP_1NNN:
+                    this->AddLeader(instruction.nnn, work_list);
+                    break;
+                case OP_2NNN:
+                    this->AddLeader(instruction.nnn, work_list);
+                    this->AddLeader(next, work_list);
+                    break;
+                case OP_00EE:
+                case OP_00FD:
+                case OP_BNNN:
+                case OP_NOT_IMPLEMENTED:
+                    break;
+                case OP_FX0A:
+                    // Runs again while no key is pressed, dispatching to its own address
+                    this->AddLeader(address, work_list);
+                    this->AddLeader(next, work_list);
+                    break;
+                case OP_3XNN:
+                case OP_4XNN:
+                case OP_5XY0:
+                case OP_9XY0:
+                case OP_EX9E:
+                case OP_EXA1:
+                    this->AddLeader(next, work_list);
+                    this->AddLeader(next + 2, work_list);
+                    break;
+                case OP_00E0:
+                case OP_DXYN:
+                case OP_00CN:
+                case OP_00FB:
+                case OP_00FC:
+                case OP_00FE:
+                case OP_00FF:
+                case OP_00DN:
+                case OP_FX33:
+                case OP_FX55:
+                    this->AddLeader(next, work_list);
+                    break;
+                default:
+                    work_list.push_back(next);
+                    break;
+            }
+        }
+
+        // Every block runs from a leader until a terminating instruction, the next leader or unreachable code
+        for (uint16_t leader : this->leaders_) {
+            if (this->reachable_.count(leader) == 0 || this->Id(this->OpCode(leader)) == OP_NOT_IMPLEMENTED) {
+                continue;
+            }
+
+            uint16_t address = leader;
+            while (true) {
+                OpCodeId id = this->Id(this->OpCode(address));
+                if (id == OP_NOT_IMPLEMENTED) {
+                    break;
+                }
+                address += 2;
+                if (this->IsTerminator(id) || this->leaders_.count(address) > 0 || this->reachable_.count(address) == 0) {
+                    break;
+                }
+            }
+
+            this->block_numbers_[leader] = this->blocks_.size();
+            this->blocks_.push_back({leader, address});
+        }
+    }
+
+    void Write(ostream& out, const string& rom_name, const string& symbol) {
+        out << "// Generated by chip-8-recompile from " << rom_name << ", do not edit." << endl;
+        out << "#include \"chip-8_state.hpp\"" << endl;
+        out << "#include \"instruction.hpp\"" << endl;
+        out << "#include \"op_codes.hpp\"" << endl;
+        out << "#include \"recompiled_program.hpp\"" << endl;
+        out << "#include \"input/input_interface.hpp\"" << endl << endl;
+
+        out << "static const uint8_t IMAGE[] = {";
+        for (int i = 0; i < this->image_.size(); i++) {
+            out << (i % 16 == 0 ? "\n    " : " ") << (int)this->image_[i] << ",";
+        }
+        out << endl << "};" << endl << endl;
+
+        out << "static const RecompiledBlock BLOCKS[] = {" << endl;
+        for (Block& block : this->blocks_) {
+            out << "    {" << Hex(block.start) << ", " << Hex(block.end) << "}," << endl;
+        }
+        if (this->blocks_.empty()) {
+            out << "    {0, 0}" << endl;
+        }
+        out << "};" << endl << endl;
+
+        out << "static int Run(RecompiledProgram* program, CHIP8_State* state, InputInterface* input, int budget, "
+            << "bool& refresh_display) {" << endl;
+        out << "    int executed = 0;" << endl << endl;
+        out << "dispatch:" << endl;
+        out << "    switch (state->programCounter()) {" << endl;
+        for (Block& block : this->blocks_) {
+            out << "        case " << Hex(block.start) << ": goto " << this->Label(block.start) << ";" << endl;
+        }
+        out << "    }" << endl;
+        out << "    return executed;" << endl;
+
+        for (int number = 0; number < this->blocks_.size(); number++) {
+            this->WriteBlock(out, number);
+        }
+
+        out << "}" << endl << endl;
+
+        out << "extern const RecompiledRom " << symbol << " = {IMAGE, " << this->image_.size() << ", BLOCKS, "
+            << this->blocks_.size() << ", Run, " << QuirkProfileName(this->quirk_profile_) << "};" << endl;
+    }
+
+    int BlockCount() {
+        return this->blocks_.size();
+    }
+
+    int InstructionCount() {
+        return this->reachable_.size();
+    }
+
+private:
+
+    bool InImage(uint16_t address) {
+        return address >= INITAL_PROGRAM_COUNTER && address + 1 < INITAL_PROGRAM_COUNTER + this->image_.size();
+    }
+
+    uint16_t OpCode(uint16_t address) {
+        uint16_t offset = address - INITAL_PROGRAM_COUNTER;
+        return ((uint16_t)this->image_[offset] << 8) | this->image_[offset + 1];
+    }
+
+    /**
+     * @brief The operation of an op code on a CHIP-8 machine, XO-CHIP and COSMAC VIP hires programs are never
+     * recompiled
+     *
+     */
+    OpCodeId Id(uint16_t op_code) {
+        OpCodeId id = OP_CODE_TABLE.lookup(op_code).id;
+        bool super_chip = WithQuirks(this->quirk_profile_, [](auto quirks) {
+            return decltype(quirks)::SUPER_CHIP_INSTRUCTIONS;
+        });
+        if (!super_chip) {
+            // Machine code calls and unknown op codes without SUPER-CHIP
+            switch (id) {
+                case OP_00CN:
+                case OP_00FB:
+                case OP_00FC:
+                case OP_00FD:
+                case OP_00FE:
+                case OP_00FF:
+                    return OP_UNUSED;
+                case OP_FX30:
+                case OP_FX75:
+                case OP_FX85:
+                    return OP_NOT_IMPLEMENTED;
+                default:
+                    break;
+            }
+        }
+        switch (id) {
+            case OP_5XY2:
+            case OP_5XY3:
+                return OP_5XY0;
+            case OP_F000:
+            case OP_FN01:
+                return OP_NOT_IMPLEMENTED;
+            case OP_00DN:
+            case OP_0230:
+                return OP_UNUSED;
+            default:
+                return id;
+        }
+    }
+
+    void AddLeader(uint16_t address, vector<uint16_t>& work_list) {
+        this->leaders_.insert(address);
+        work_list.push_back(address);
+    }
+
+    bool IsTerminator(OpCodeId id) {
+        switch (id) {
+            case OP_1NNN: case OP_2NNN: case OP_00EE: case OP_00FD: case OP_FX0A: case OP_BNNN:
+            case OP_3XNN: case OP_4XNN: case OP_5XY0: case OP_9XY0: case OP_EX9E: case OP_EXA1:
+            case OP_00E0: case OP_DXYN: case OP_FX33: case OP_FX55:
+            case OP_00CN: case OP_00FB: case OP_00FC: case OP_00FE: case OP_00FF:
+            case OP_00DN:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    string Label(uint16_t address) {
+        char buffer[16];
+        snprintf(buffer, sizeof(buffer), "block_%03X", address);
+        return string(buffer);
+    }
+
+    /**
+     * @brief Continues at a static address, jumping to its block when it has one
+     *
+     */
+    string GoTo(uint16_t address) {
+        if (this->block_numbers_.count(address) > 0) {
+            return "goto " + this->Label(address) + ";";
+        }
+        return "state->setProgramCounter(" + Hex(address) + "); return executed;";
+    }
+
+    void WriteBlock(ostream& out, int number) {
+        Block& block = this->blocks_[number];
+        int length = (block.end - block.start) / 2;
+        bool logic_resets_vf = WithQuirks(this->quirk_profile_, [](auto quirks) {
+            return decltype(quirks)::LOGIC_RESETS_VF;
+        });
+
+        out << endl << this->Label(block.start) << ":" << endl;
+        out << "    if (program->isDirty(" << number << ") || budget - executed < " << length << ") {" << endl;
+        out << "        state->setProgramCounter(" << Hex(block.start) << ");" << endl;
+        out << "        return executed;" << endl;
+        out << "    }" << endl;
+        out << "    executed += " << length << ";" << endl;
+
+        for (uint16_t address = block.start; address < block.end; address += 2) {
+            Instruction instruction(this->OpCode(address));
+            OpCodeId id = this->Id(instruction.op_code);
+            uint16_t next = address + 2;
+            string x = "state->vRegister(" + to_string(instruction.x) + ")";
+            string y = "state->vRegister(" + to_string(instruction.y) + ")";
+            string set_x = "state->setVRegister(" + to_string(instruction.x) + ", ";
+            string reset_vf = logic_resets_vf ? "    state->setVRegister(15, 0);\n" : "";
+
+            out << "    // " << Hex(address) << ": " << Hex(instruction.op_code) << endl;
+            switch (id) {
+                case OP_UNUSED:
+                    break;
+                case OP_1NNN:
+                    out << "    " << this->GoTo(instruction.nnn) << endl;
+                    break;
+                case OP_3XNN:
+                case OP_4XNN:
+                case OP_5XY0:
+                case OP_9XY0: {
+                    string compared = (id == OP_3XNN || id == OP_4XNN) ? Hex(instruction.nn) : y;
+                    string comparison = (id == OP_3XNN || id == OP_5XY0) ? " == " : " != ";
+                    out << "    if (" << x << comparison << compared << ") {" << endl;
+                    out << "        " << this->GoTo(next + 2) << endl;
+                    out << "    }" << endl;
+                    out << "    " << this->GoTo(next) << endl;
+                    break;
+                }
+                case OP_6XNN:
+                    out << "    " << set_x << Hex(instruction.nn) << ");" << endl;
+                    break;
+                case OP_7XNN:
+                    out << "    " << set_x << "(uint8_t)(" << x << " + " << Hex(instruction.nn) << "));" << endl;
+                    break;
+                case OP_8XY0:
+                    out << "    " << set_x << y << ");" << endl;
+                    break;
+                case OP_8XY1:
+                    out << "    " << set_x << x << " | " << y << ");" << endl;
+                    out << reset_vf;
+                    break;
+                case OP_8XY2:
+                    out << "    " << set_x << x << " & " << y << ");" << endl;
+                    out << reset_vf;
+                    break;
+                case OP_8XY3:
+                    out << "    " << set_x << x << " ^ " << y << ");" << endl;
+                    out << reset_vf;
+                    break;
+                case OP_ANNN:
+                    out << "    state->setIndexRegister(" << Hex(instruction.nnn) << ");" << endl;
+                    break;
+                default:
+                    // The op code handler may read the program counter, keep it in sync with the interpreter
+                    out << "    state->setProgramCounter(" << Hex(next) << ");" << endl;
+                    out << "    " << HandlerCall(id, instruction.op_code, QuirkPolicy(this->quirk_profile_)) << ";"
+                        << endl;
+                    break;
+            }
+
+            switch (id) {
+                case OP_2NNN:
+                    out << "    " << this->GoTo(instruction.nnn) << endl;
+                    break;
+                case OP_00EE:
+                case OP_00FD:
+                case OP_FX0A:
+                case OP_BNNN:
+                case OP_EX9E:
+                case OP_EXA1:
+                    out << "    goto dispatch;" << endl;
+                    break;
+                case OP_00E0:
+                case OP_DXYN:
+                case OP_00CN:
+                case OP_00FB:
+                case OP_00FC:
+                case OP_00FE:
+                case OP_00FF:
+                case OP_00DN:
+                    out << "    refresh_display = true;" << endl;
+                    out << "    return executed;" << endl;
+                    break;
+                case OP_FX33:
+                case OP_FX55:
+                    // Memory was written to, the next block checks whether it was modified
+                    out << "    " << this->GoTo(next) << endl;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        // Blocks ending without a terminating instruction continue with the following block
+        OpCodeId last = this->Id(this->OpCode(block.end - 2));
+        if (!this->IsTerminator(last)) {
+            out << "    " << this->GoTo(block.end) << endl;
+        }
+    }
+
+    // The ROM data
+    vector<uint8_t> image_;
+
+    // Quirks reproduced by the generated code
+    QuirkProfile quirk_profile_;
+
+    // Addresses starting a block
+    set<uint16_t> leaders_;
+
+    // Addresses of every instruction reached from the entry point
+    set<uint16_t> reachable_;
+
+    // Blocks in address order
+    vector<Block> blocks_;
+
+    // Block number of each leader
+    map<uint16_t, int> block_numbers_;
+};
+
+int main(int argc, char** argv) {
+    QuirkProfile profile = QuirkProfile::Modern;
+    if (argc < 4 || (argc > 4 && !ParseQuirkProfile(string(argv[4]), profile))) {
+        cout << "Usage: chip-8-recompile <rom> <output.cpp> <symbol> [vip|chip48|schip|modern|xo-chip]" << endl;
+        return -1;
+    }
+
+    string rom_path = string(argv[1]);
+    vector<char>* rom = ReadRom(rom_path);
+
+    Recompiler recompiler(rom, profile);
+    recompiler.Analyze();
+
+    ofstream out(argv[2]);
+    if (!out) {
+        cout << "Could not write " << argv[2] << endl;
+        return -1;
+    }
+    recompiler.Write(out, rom_path.substr(rom_path.find_last_of('/') + 1), string(argv[3]));
+
+    cout << "Recompiled " << recompiler.InstructionCount() << " instructions into " << recompiler.BlockCount()
+         << " blocks" << endl;
+
+    delete rom;
+    return 0;
+}